@@ -0,0 +1,63 @@
+///                                                                           
+/// Langulus::Module::Physics                                                 
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include "Octaves.hpp"
+#include "Culling.hpp"
+#include "Broadphase.hpp"
+
+
+///                                                                           
+///   Octave aggregates                                                       
+///                                                                           
+/// Instances that are too small to be seen from the observer's octave are    
+/// culled one by one, but they should still be drawn as points. For each     
+/// octave in an OctaveIndex, this keeps a compact point cloud - one          
+/// bounding sphere per instance, in bucket order - and a bounding volume     
+/// around the whole cloud, so that the renderer can cull and draw an         
+/// octave with a single buffer. Clouds are updated incrementally: only       
+/// moving slots are rewritten, and only octaves whose membership changed     
+/// are rebuilt                                                               
+///                                                                           
+struct Euclidean::Aggregates {
+   /// Bounding sphere of a single instance                                   
+   struct Point {
+      Real mX, mY, mZ;
+      Real mRadius;
+   };
+
+   /// All instances of a single octave                                       
+   struct Cloud {
+      // One point per slot, in the order of the octave's bucket        
+      std::vector<Point> mPoints;
+      // Contains all points, but may be larger than necessary, if      
+      // points moved inwards since the last rebuild                    
+      Broadphase::Box mBounds;
+      // Whether slots entered or left the octave since last refresh    
+      bool mInvalid = true;
+   };
+
+private:
+   std::map<int, Cloud> mClouds;
+
+   static auto MakePoint(const Culling::Bounds&, Offset) noexcept -> Point;
+   static void Grow(Broadphase::Box&, const Point&) noexcept;
+   void Rebuild(Cloud&, const OctaveIndex::Bucket&, const Culling::Bounds&);
+
+public:
+   void Invalidate(int octave);
+   void Refresh(const OctaveIndex&, const Culling::Bounds&, Count active);
+   void Clear() noexcept;
+
+   auto GetCloud(int octave) const noexcept -> const Cloud*;
+   auto GetCloudCount() const noexcept -> Count;
+
+   template<class F>
+   void ForEachHidden(int observer, F&&) const;
+};
+
+#include "Aggregates.inl"
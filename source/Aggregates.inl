@@ -0,0 +1,133 @@
+///                                                                           
+/// Langulus::Module::Physics                                                 
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include "Aggregates.hpp"
+#include <limits>
+
+
+namespace Euclidean
+{
+
+   /// Get the bounding sphere of a slot                                      
+   ///   @param bounds - positions and extents of all slots                   
+   ///   @param slot - the slot                                               
+   ///   @return the point                                                    
+   inline auto Aggregates::MakePoint(const Culling::Bounds& bounds, Offset slot) noexcept -> Point {
+      const Real ex = bounds.mExtentX[slot];
+      const Real ey = bounds.mExtentY[slot];
+      const Real ez = bounds.mExtentZ[slot];
+      return {
+         bounds.mX[slot], bounds.mY[slot], bounds.mZ[slot],
+         std::sqrt(ex * ex + ey * ey + ez * ez)
+      };
+   }
+
+   /// Expand a box, so that it contains a bounding sphere                    
+   ///   @param box - [in/out] the box                                        
+   ///   @param p - the sphere                                                
+   inline void Aggregates::Grow(Broadphase::Box& box, const Point& p) noexcept {
+      box.mMin.x = std::min(box.mMin.x, p.mX - p.mRadius);
+      box.mMin.y = std::min(box.mMin.y, p.mY - p.mRadius);
+      box.mMin.z = std::min(box.mMin.z, p.mZ - p.mRadius);
+      box.mMax.x = std::max(box.mMax.x, p.mX + p.mRadius);
+      box.mMax.y = std::max(box.mMax.y, p.mY + p.mRadius);
+      box.mMax.z = std::max(box.mMax.z, p.mZ + p.mRadius);
+   }
+
+   /// Rewrite all points of a cloud, and fit its bounds tightly              
+   ///   @param cloud - the cloud                                             
+   ///   @param bucket - the slots in the cloud's octave                      
+   ///   @param bounds - positions and extents of all slots                   
+   inline void Aggregates::Rebuild(Cloud& cloud, const OctaveIndex::Bucket& bucket, const Culling::Bounds& bounds) {
+      cloud.mPoints.resize(bucket.size());
+      cloud.mBounds.mMin = Vec3 {std::numeric_limits<Real>::max()};
+      cloud.mBounds.mMax = Vec3 {std::numeric_limits<Real>::lowest()};
+      for (Offset i = 0; i < bucket.size(); ++i) {
+         cloud.mPoints[i] = MakePoint(bounds, bucket[i]);
+         Grow(cloud.mBounds, cloud.mPoints[i]);
+      }
+      cloud.mInvalid = false;
+   }
+
+   /// Mark an octave for rebuilding, because slots entered or left it        
+   /// Renaming slots, like OctaveIndex::Swap does, doesn't require this      
+   ///   @param octave - the octave                                           
+   inline void Aggregates::Invalidate(int octave) {
+      mClouds[octave].mInvalid = true;
+   }
+
+   /// Bring all clouds up to date with the index. Invalid clouds are         
+   /// rebuilt, and in the rest only the points of active slots are           
+   /// rewritten, because sleeping slots don't move                           
+   ///   @param index - the slots, bucketed by octave                         
+   ///   @param bounds - positions and extents of all slots                   
+   ///   @param active - slots below this one are active                      
+   inline void Aggregates::Refresh(const OctaveIndex& index, const Culling::Bounds& bounds, Count active) {
+      for (auto it = mClouds.begin(); it != mClouds.end();) {
+         if (not index.GetBucket(it->first))
+            it = mClouds.erase(it);
+         else
+            ++it;
+      }
+
+      // New octaves get invalid clouds, so they're rebuilt too         
+      index.ForEach([&](int octave, const OctaveIndex::Bucket& bucket) {
+         auto& cloud = mClouds[octave];
+         if (cloud.mInvalid)
+            Rebuild(cloud, bucket, bounds);
+      });
+
+      // Active slots may have moved - rewrite their points in place    
+      Cloud* cloud = nullptr;
+      int octave = 0;
+      for (Offset slot = 0; slot < active; ++slot) {
+         const auto at = index.GetOctave(slot);
+         if (not cloud or at != octave) {
+            octave = at;
+            cloud = &mClouds.find(octave)->second;
+         }
+
+         auto& point = cloud->mPoints[index.GetPosition(slot)];
+         point = MakePoint(bounds, slot);
+         Grow(cloud->mBounds, point);
+      }
+   }
+
+   /// Remove all clouds                                                      
+   inline void Aggregates::Clear() noexcept {
+      mClouds.clear();
+   }
+
+   /// Get the cloud of an octave, as of the last refresh                     
+   ///   @param octave - the octave                                           
+   ///   @return the cloud, or nullptr if the octave is empty                 
+   inline auto Aggregates::GetCloud(int octave) const noexcept -> const Cloud* {
+      const auto found = mClouds.find(octave);
+      return found != mClouds.end() ? &found->second : nullptr;
+   }
+
+   /// Get the number of non-empty octaves                                    
+   ///   @return the number of clouds                                         
+   inline Count Aggregates::GetCloudCount() const noexcept {
+      return mClouds.size();
+   }
+
+   /// Iterate the clouds of octaves that are too small to be seen by an      
+   /// observer, and are culled by Instance::Cull one by one                  
+   ///   @param observer - the octave of the observer                         
+   ///   @param call - invoked with the octave and its cloud                  
+   template<class F>
+   void Aggregates::ForEachHidden(int observer, F&& call) const {
+      for (const auto& [octave, cloud] : mClouds) {
+         if (OctaveIndex::CanBeVisible(octave, observer))
+            break;
+         call(octave, cloud);
+      }
+   }
+
+} // namespace Euclidean
@@ -7,6 +7,8 @@
 ///                                                                           
 #include "Bond.hpp"
 #include "Physics.hpp"
+#include <cmath>
+#include <limits>
 
 using namespace Euclidean;
 
@@ -22,12 +24,122 @@ Bond::Bond(World* producer, const Many& descriptor)
    VERBOSE_PHYSICS("Initialized");
 }
 
+/// Bond destruction                                                          
+Bond::~Bond() {
+   Release();
+}
+
+/// First stage destruction                                                   
+void Bond::Teardown() {
+   Release();
+}
+
+/// Get the world's bond table, where ends and parameters reside              
+///   @return the table                                                       
+BondIslands& Bond::GetTable() const noexcept {
+   return GetProducer()->GetBondIslands();
+}
+
+/// Take the bond out of the world's bond table                               
+void Bond::Release() noexcept {
+   if (mIndex == BondIslands::Invalid)
+      return;
+
+   GetProducer()->Unbind(mIndex);
+   Detach();
+}
+
+/// Forget the index, after the world has already unbound the bond, i.e.      
+/// because one of the ends was unregistered                                  
+void Bond::Detach() noexcept {
+   mIndex = BondIslands::Invalid;
+}
+
 /// Refresh the component on environment change                               
 void Bond::Refresh() {
 
 }
 
-/// Update the component                                                      
-void Bond::Update(Real) {
+/// Bond two instances, keeping them at their current distance. Stiffness     
+/// and damping are kept, if the bond already had ends                        
+///   @param a, b - the instances to bond, or nullptr to detach the bond      
+void Bond::SetEnds(const Instance* a, const Instance* b) {
+   auto stiffness = std::numeric_limits<Real>::infinity();
+   Real damping = 0;
+   if (mIndex != BondIslands::Invalid) {
+      stiffness = GetStiffness();
+      damping = GetDamping();
+   }
+
+   Release();
+   if (not a or not b)
+      return;
+
+   const auto world = GetProducer();
+   const auto& pool = world->GetPool();
+   const Vec3 d = pool.mPosition.Get(b->GetSlot()) - pool.mPosition.Get(a->GetSlot());
+   mIndex = world->Bind(this, a->GetSlot(), b->GetSlot());
+
+   auto& table = GetTable();
+   table.SetRestLength(mIndex, std::sqrt(d.x * d.x + d.y * d.y + d.z * d.z));
+   table.SetStiffness(mIndex, stiffness);
+   table.SetDamping(mIndex, damping);
+}
+
+/// Change the distance the bond keeps between its ends                       
+///   @param length - the new rest length                                     
+void Bond::SetRestLength(Real length) noexcept {
+   LANGULUS_ASSUME(UserAssumes, mIndex != BondIslands::Invalid, "Bond has no ends");
+   GetTable().SetRestLength(mIndex, length);
+}
+
+/// Change how strongly the rest length is kept                               
+///   @param stiffness - the new stiffness, infinite for a rigid bond         
+void Bond::SetStiffness(Real stiffness) noexcept {
+   LANGULUS_ASSUME(UserAssumes, mIndex != BondIslands::Invalid, "Bond has no ends");
+   GetTable().SetStiffness(mIndex, stiffness);
+}
+
+/// Change how quickly a soft bond stops oscillating                          
+///   @param damping - the new damping                                        
+void Bond::SetDamping(Real damping) noexcept {
+   LANGULUS_ASSUME(UserAssumes, mIndex != BondIslands::Invalid, "Bond has no ends");
+   GetTable().SetDamping(mIndex, damping);
+}
+
+/// Get the index of the bond inside the world's bond table                   
+///   @return the index, or BondIslands::Invalid if the bond has no ends      
+uint32_t Bond::GetIndex() const noexcept {
+   return mIndex;
+}
+
+/// Get one of the bonded instances                                           
+///   @param index - zero or one                                              
+///   @return the instance, or nullptr if the bond has no ends                
+const Instance* Bond::GetEnd(Offset index) const noexcept {
+   LANGULUS_ASSUME(DevAssumes, index < 2, "Bonds have two ends");
+   if (mIndex == BondIslands::Invalid)
+      return nullptr;
+   return GetProducer()->GetPool().mOwners[GetTable().GetSlot(mIndex, index)];
+}
+
+/// Get the distance the bond keeps between its ends                          
+///   @return the rest length                                                 
+Real Bond::GetRestLength() const noexcept {
+   LANGULUS_ASSUME(UserAssumes, mIndex != BondIslands::Invalid, "Bond has no ends");
+   return GetTable().GetRestLength(mIndex);
+}
+
+/// Get how strongly the rest length is kept                                  
+///   @return the stiffness, infinite for a rigid bond                        
+Real Bond::GetStiffness() const noexcept {
+   LANGULUS_ASSUME(UserAssumes, mIndex != BondIslands::Invalid, "Bond has no ends");
+   return GetTable().GetStiffness(mIndex);
+}
 
+/// Get how quickly a soft bond stops oscillating                             
+///   @return the damping                                                     
+Real Bond::GetDamping() const noexcept {
+   LANGULUS_ASSUME(UserAssumes, mIndex != BondIslands::Invalid, "Bond has no ends");
+   return GetTable().GetDamping(mIndex);
 }
\ No newline at end of file
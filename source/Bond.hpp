@@ -6,7 +6,7 @@
 /// SPDX-License-Identifier: GPL-3.0-or-later                                 
 ///                                                                           
 #pragma once
-#include "Common.hpp"
+#include "BondIslands.hpp"
 #include <Langulus/Flow/Producible.hpp>
 
 
@@ -18,15 +18,43 @@
 /// whose parts have different behaviors like ragdolls and structures.        
 ///   Can emerge from simulation on collision, when some electromagnetic or   
 /// chemical interaction forms a strong bond.                                 
+///   Bonds keep their ends at a rest distance, and are solved together by    
+/// the world's bond solver, right after instances are integrated. The unit   
+/// is only a handle - ends and parameters of all bonds are packed in the     
+/// world's bond table, so that solving never visits the units                
 ///                                                                           
 struct Euclidean::Bond : A::Bond, ProducedFrom<World> {
    LANGULUS(ABSTRACT) false;
    LANGULUS(PRODUCER) World;
    LANGULUS_BASES(A::Bond);
 
+private:
+   friend struct World;
+
+   // Index of the bond inside the world's bond table, valid only while 
+   // both ends exist                                                   
+   uint32_t mIndex = BondIslands::Invalid;
+
 public:
    Bond(World*, const Many&);
+   ~Bond();
 
-   void Update(Real);
    void Refresh() override;
+   void Teardown();
+
+   void SetEnds(const Instance*, const Instance*);
+   void SetRestLength(Real) noexcept;
+   void SetStiffness(Real) noexcept;
+   void SetDamping(Real) noexcept;
+
+   auto GetIndex() const noexcept -> uint32_t;
+   auto GetEnd(Offset) const noexcept -> const Instance*;
+   auto GetRestLength() const noexcept -> Real;
+   auto GetStiffness() const noexcept -> Real;
+   auto GetDamping() const noexcept -> Real;
+
+private:
+   auto GetTable() const noexcept -> BondIslands&;
+   void Release() noexcept;
+   void Detach() noexcept;
 };
\ No newline at end of file
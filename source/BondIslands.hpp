@@ -0,0 +1,133 @@
+///                                                                           
+/// Langulus::Module::Physics                                                 
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include "BondSolver.hpp"
+#include <vector>
+
+
+///                                                                           
+///   Bond islands                                                            
+///                                                                           
+/// Groups bonds into islands - sets of bonds that are connected through the  
+/// instances they move - so that each island can be solved independently.    
+/// Anchored slots, i.e. static instances, are never moved by bonds, so they  
+/// don't connect islands. Islands are kept in a union-find over bonds, and   
+/// binding only merges sets. Unbinding marks the island dirty, and only the  
+/// bonds of dirty islands are regrouped on the next Group. Each set links    
+/// its bonds in a cycle, so Group visits only the sets that changed, and     
+/// rebuilds only their islands. Each slot keeps an intrusive list of its     
+/// bonds, and slots are swapped and removed like in InstancePool.            
+///   The parameters of all bonds are kept here too, in columns next to the   
+/// slots, so the solver reads each island straight from the columns          
+///                                                                           
+struct Euclidean::BondIslands {
+   /// Marks the end of a list, or a bond that doesn't exist                  
+   static constexpr uint32_t Invalid = static_cast<uint32_t>(-1);
+
+private:
+   /// Lifetime of a bond index                                               
+   enum State : uint8_t {
+      Free,
+      Bound,
+      // Unbound, but still inside its set until the next Group         
+      Unbound
+   };
+
+   /// How a set changed since the last Group                                 
+   enum Change : uint8_t {
+      // The set is in mChanged, and its island must be rebuilt         
+      Listed = 1,
+      // The set might have split, and its bonds must be regrouped      
+      Split = 2
+   };
+
+   // Both ends of each bond are nodes of slot lists, so node 2*i is    
+   // the first end of bond i, and node 2*i+1 is the second one         
+   std::vector<Offset> mSlot;
+   std::vector<uint32_t> mNext;
+   // Parameters of each bond - compliance is the inverse of stiffness  
+   std::vector<Real> mRest;
+   std::vector<Real> mCompliance;
+   std::vector<Real> mDamping;
+   // Owner and lifetime of each bond, and indices ready for reuse      
+   std::vector<Bond*> mOwner;
+   std::vector<State> mState;
+   std::vector<uint32_t> mFree;
+   std::vector<uint32_t> mUnbound;
+   // The union-find, with a cycle through the bonds of each set, and   
+   // how each root's set changed since the last Group                  
+   std::vector<uint32_t> mParent;
+   std::vector<uint32_t> mSize;
+   std::vector<uint32_t> mCycle;
+   std::vector<uint8_t> mDirty;
+   // Sets that changed since the last Group, as roots at the time      
+   std::vector<uint32_t> mChanged;
+
+   // First node of each slot's list, and whether the slot is anchored  
+   std::vector<uint32_t> mFirst;
+   std::vector<uint8_t> mAnchor;
+
+   // Bonds of each island, the root of each island's set, and the      
+   // island of each root, or Invalid. Lists past the island count are  
+   // kept only to be reused                                            
+   std::vector<std::vector<uint32_t>> mIslands;
+   std::vector<uint32_t> mIslandRoot;
+   std::vector<uint32_t> mIslandOf;
+   Count mIslandCount = 0;
+   // Bonds of changed sets that are regrouped, and roots of changed    
+   // sets that are only rebuilt, during Group                          
+   std::vector<uint32_t> mSplit;
+   std::vector<uint32_t> mMerged;
+   // Whether islands are up to date with all bindings                  
+   bool mGrouped = true;
+   // Number of bonds regrouped by the last Group                       
+   Count mRegrouped = 0;
+
+   auto Find(uint32_t) noexcept -> uint32_t;
+   void Union(uint32_t, uint32_t) noexcept;
+   void MarkDirty(Offset slot) noexcept;
+   void Touch(uint32_t root, uint8_t change) noexcept;
+   void AddIsland(uint32_t root);
+   void RemoveIsland(uint32_t island) noexcept;
+   void Link(uint32_t node, Offset slot) noexcept;
+   void Unlink(uint32_t node) noexcept;
+
+public:
+   void Insert(Offset, bool anchor);
+   void Remove(Offset) noexcept;
+   void Swap(Offset, Offset) noexcept;
+   void SetAnchor(Offset, bool) noexcept;
+   void Clear() noexcept;
+
+   auto Bind(Offset a, Offset b, Bond* owner = nullptr) -> uint32_t;
+   void Unbind(uint32_t) noexcept;
+   void Group();
+
+   void SetRestLength(uint32_t bond, Real) noexcept;
+   void SetStiffness(uint32_t bond, Real) noexcept;
+   void SetDamping(uint32_t bond, Real) noexcept;
+
+   auto GetSlot(uint32_t bond, Offset end) const noexcept -> Offset;
+   auto GetRestLength(uint32_t bond) const noexcept -> Real;
+   auto GetStiffness(uint32_t bond) const noexcept -> Real;
+   auto GetDamping(uint32_t bond) const noexcept -> Real;
+   auto GetOwner(uint32_t bond) const noexcept -> Bond*;
+   auto GetFirst(Offset) const noexcept -> uint32_t;
+   auto GetCount() const noexcept -> Count;
+   auto GetIslandCount() const noexcept -> Count;
+   auto GetIslandSize(Offset) const noexcept -> Count;
+   auto GetTable(Offset island) const noexcept -> BondSolver::Table;
+   auto GetRegroupedCount() const noexcept -> Count;
+
+   template<class F>
+   void ForEachBond(Offset, F&&) const;
+   template<class F>
+   void ForEachInIsland(Offset island, F&&) const;
+};
+
+#include "BondIslands.inl"
@@ -0,0 +1,472 @@
+///                                                                           
+/// Langulus::Module::Physics                                                 
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include "BondIslands.hpp"
+#include <limits>
+#include <utility>
+
+
+namespace Euclidean
+{
+
+   /// Find the root of a bond's set, halving the path on the way             
+   ///   @param bond - the bond                                               
+   ///   @return the root bond of the set                                     
+   inline auto BondIslands::Find(uint32_t bond) noexcept -> uint32_t {
+      while (mParent[bond] != bond) {
+         mParent[bond] = mParent[mParent[bond]];
+         bond = mParent[bond];
+      }
+      return bond;
+   }
+
+   /// Merge the sets of two bonds, the smaller one into the larger one.      
+   /// The merged set carries the changes of both, and exchanging the links   
+   /// of the two roots joins their cycles into one                           
+   ///   @param a - a bond of the first set                                   
+   ///   @param b - a bond of the second set                                  
+   inline void BondIslands::Union(uint32_t a, uint32_t b) noexcept {
+      a = Find(a);
+      b = Find(b);
+      if (a == b)
+         return;
+      if (mSize[a] < mSize[b])
+         std::swap(a, b);
+
+      mParent[b] = a;
+      mSize[a] += mSize[b];
+      mDirty[a] |= mDirty[b];
+      std::swap(mCycle[a], mCycle[b]);
+   }
+
+   /// Record a change of a set, listing the set for the next Group, unless   
+   /// it's already listed                                                    
+   ///   @param root - the root of the set                                    
+   ///   @param change - Split, if the set might have split, zero otherwise   
+   inline void BondIslands::Touch(uint32_t root, uint8_t change) noexcept {
+      if (not (mDirty[root] & Listed))
+         mChanged.push_back(root);
+      mDirty[root] |= Listed | change;
+      mGrouped = false;
+   }
+
+   /// Mark the islands of all bonds of a slot dirty                          
+   ///   @param slot - the slot                                               
+   inline void BondIslands::MarkDirty(Offset slot) noexcept {
+      for (auto node = mFirst[slot]; node != Invalid; node = mNext[node])
+         Touch(Find(node / 2), Split);
+   }
+
+   /// Push an end of a bond to the front of a slot's list                    
+   ///   @param node - the end of the bond                                    
+   ///   @param slot - the slot it is attached to                             
+   inline void BondIslands::Link(uint32_t node, Offset slot) noexcept {
+      mSlot[node] = slot;
+      mNext[node] = mFirst[slot];
+      mFirst[slot] = node;
+   }
+
+   /// Take an end of a bond out of its slot's list                           
+   ///   @param node - the end of the bond                                    
+   inline void BondIslands::Unlink(uint32_t node) noexcept {
+      auto link = &mFirst[mSlot[node]];
+      while (*link != node)
+         link = &mNext[*link];
+      *link = mNext[node];
+   }
+
+   /// Add a new slot, which must come right after the last one               
+   ///   @param slot - the slot                                               
+   ///   @param anchor - whether bonds never move the slot                    
+   inline void BondIslands::Insert(Offset slot, bool anchor) {
+      LANGULUS_ASSUME(DevAssumes, slot == mFirst.size(),
+         "Slots must be inserted in order");
+      mFirst.push_back(Invalid);
+      mAnchor.push_back(anchor);
+   }
+
+   /// Remove a slot without bonds - the last slot is renamed to the removed  
+   /// one, exactly like InstancePool::Release does it                        
+   ///   @param slot - the slot to remove                                     
+   inline void BondIslands::Remove(Offset slot) noexcept {
+      LANGULUS_ASSUME(DevAssumes, slot < mFirst.size(), "Slot out of range");
+      LANGULUS_ASSUME(DevAssumes, mFirst[slot] == Invalid,
+         "Unbind all bonds of a slot, before removing it");
+
+      const Offset last = mFirst.size() - 1;
+      if (slot != last)
+         Swap(slot, last);
+      mFirst.pop_back();
+      mAnchor.pop_back();
+   }
+
+   /// Exchange two slots, the same way InstancePool::Swap does it - the      
+   /// bonds of both slots are patched to refer to the new slots              
+   ///   @param a - the first slot                                            
+   ///   @param b - the second slot                                           
+   inline void BondIslands::Swap(Offset a, Offset b) noexcept {
+      LANGULUS_ASSUME(DevAssumes, a < mFirst.size() and b < mFirst.size(),
+         "Slot out of range");
+      if (a == b)
+         return;
+
+      // Each end of a bond is in exactly one list, so a bond between   
+      // the two slots is patched correctly, one end in each list       
+      for (auto node = mFirst[a]; node != Invalid; node = mNext[node])
+         mSlot[node] = b;
+      for (auto node = mFirst[b]; node != Invalid; node = mNext[node])
+         mSlot[node] = a;
+      std::swap(mFirst[a], mFirst[b]);
+      std::swap(mAnchor[a], mAnchor[b]);
+   }
+
+   /// Change whether a slot is anchored. Anchors don't connect islands, so   
+   /// all islands of the slot are regrouped on the next Group                
+   ///   @param slot - the slot                                               
+   ///   @param anchor - whether bonds never move the slot                    
+   inline void BondIslands::SetAnchor(Offset slot, bool anchor) noexcept {
+      LANGULUS_ASSUME(DevAssumes, slot < mFirst.size(), "Slot out of range");
+      if (mAnchor[slot] == anchor)
+         return;
+
+      MarkDirty(slot);
+      mAnchor[slot] = anchor;
+   }
+
+   /// Remove all slots and bonds                                             
+   inline void BondIslands::Clear() noexcept {
+      mSlot.clear();
+      mNext.clear();
+      mRest.clear();
+      mCompliance.clear();
+      mDamping.clear();
+      mOwner.clear();
+      mState.clear();
+      mFree.clear();
+      mUnbound.clear();
+      mParent.clear();
+      mSize.clear();
+      mCycle.clear();
+      mDirty.clear();
+      mChanged.clear();
+      mFirst.clear();
+      mAnchor.clear();
+      mIslandRoot.clear();
+      mIslandOf.clear();
+      mIslandCount = 0;
+      mGrouped = true;
+      mRegrouped = 0;
+   }
+
+   /// Bond two slots, merging their islands, unless a slot is an anchor.     
+   /// The bond is rigid and undamped, with zero rest length, until its       
+   /// parameters are set                                                     
+   ///   @param a - the first slot                                            
+   ///   @param b - the second slot                                           
+   ///   @param owner - the bond unit, if any                                 
+   ///   @return the index of the bond, valid until it is unbound             
+   inline auto BondIslands::Bind(Offset a, Offset b, Bond* owner) -> uint32_t {
+      LANGULUS_ASSUME(DevAssumes, a < mFirst.size() and b < mFirst.size(),
+         "Slot out of range");
+      LANGULUS_ASSUME(UserAssumes, a != b, "Can't bond a slot to itself");
+
+      uint32_t bond;
+      if (mFree.empty()) {
+         bond = static_cast<uint32_t>(mState.size());
+         mSlot.resize(mSlot.size() + 2);
+         mNext.resize(mNext.size() + 2);
+         mRest.push_back(0);
+         mCompliance.push_back(0);
+         mDamping.push_back(0);
+         mOwner.push_back(nullptr);
+         mState.push_back(Free);
+         mParent.push_back(bond);
+         mSize.push_back(1);
+         mCycle.push_back(bond);
+         mDirty.push_back(0);
+         mIslandOf.push_back(Invalid);
+         // So that unbinding and marking never allocate                
+         mUnbound.reserve(mState.size());
+         mChanged.reserve(mState.size());
+      }
+      else {
+         bond = mFree.back();
+         mFree.pop_back();
+      }
+
+      mRest[bond] = 0;
+      mCompliance[bond] = 0;
+      mDamping[bond] = 0;
+      mOwner[bond] = owner;
+      mState[bond] = Bound;
+      mParent[bond] = bond;
+      mSize[bond] = 1;
+      mCycle[bond] = bond;
+      mDirty[bond] = 0;
+
+      const Offset slots[2] {a, b};
+      for (uint32_t end = 0; end < 2; ++end) {
+         const auto slot = slots[end];
+         if (not mAnchor[slot] and mFirst[slot] != Invalid)
+            Union(bond, mFirst[slot] / 2);
+         Link(bond * 2 + end, slot);
+      }
+
+      Touch(Find(bond), 0);
+      return bond;
+   }
+
+   /// Remove a bond. Its island might split in two, so it is regrouped on    
+   /// the next Group. The index is reused only after that                    
+   ///   @param bond - the bond                                               
+   inline void BondIslands::Unbind(uint32_t bond) noexcept {
+      LANGULUS_ASSUME(DevAssumes, bond < mState.size() and mState[bond] == Bound,
+         "Bond isn't bound");
+      Touch(Find(bond), Split);
+      Unlink(bond * 2);
+      Unlink(bond * 2 + 1);
+      mOwner[bond] = nullptr;
+      mState[bond] = Unbound;
+      mUnbound.push_back(bond);
+   }
+
+   /// Bring islands up to date with all changes since the last Group. Only   
+   /// sets that changed are visited, and only their islands are rebuilt.     
+   /// Bonds of sets that might have split are regrouped - each is merged     
+   /// with the first bond of each of its unanchored slots, which is enough,  
+   /// because all bonds of a slot were in sets that might have split         
+   inline void BondIslands::Group() {
+      if (mGrouped)
+         return;
+
+      // Walk the cycle of each changed set once, before any set is     
+      // changed, and drop the islands of all sets merged into it       
+      mRegrouped = 0;
+      mSplit.clear();
+      mMerged.clear();
+      for (auto changed : mChanged) {
+         const auto root = Find(changed);
+         if (not (mDirty[root] & Listed))
+            continue;
+
+         const bool split = mDirty[root] & Split;
+         mDirty[root] = 0;
+         if (not split)
+            mMerged.push_back(root);
+
+         auto bond = root;
+         do {
+            if (mIslandOf[bond] != Invalid)
+               RemoveIsland(mIslandOf[bond]);
+            if (split)
+               mSplit.push_back(bond);
+            bond = mCycle[bond];
+         } while (bond != root);
+      }
+      mChanged.clear();
+
+      for (auto bond : mSplit) {
+         mParent[bond] = bond;
+         mSize[bond] = 1;
+         mCycle[bond] = bond;
+         mDirty[bond] = 0;
+      }
+
+      for (auto bond : mSplit) {
+         if (mState[bond] != Bound)
+            continue;
+
+         ++mRegrouped;
+         for (uint32_t end = 0; end < 2; ++end) {
+            const auto slot = mSlot[bond * 2 + end];
+            if (not mAnchor[slot])
+               Union(bond, mFirst[slot] / 2);
+         }
+      }
+
+      // Unbound bonds were only kept so that their sets stay connected 
+      for (auto bond : mUnbound) {
+         mState[bond] = Free;
+         mFree.push_back(bond);
+      }
+      mUnbound.clear();
+
+      for (auto root : mMerged)
+         AddIsland(root);
+      for (auto bond : mSplit) {
+         if (mState[bond] == Bound and mParent[bond] == bond)
+            AddIsland(bond);
+      }
+      mGrouped = true;
+   }
+
+   /// Add an island with all bonds of a set                                  
+   ///   @param root - the root of the set                                    
+   inline void BondIslands::AddIsland(uint32_t root) {
+      if (mIslandCount == mIslands.size())
+         mIslands.emplace_back();
+      mIslandRoot.resize(mIslands.size());
+
+      auto& bonds = mIslands[mIslandCount];
+      bonds.clear();
+      auto bond = root;
+      do {
+         bonds.push_back(bond);
+         bond = mCycle[bond];
+      } while (bond != root);
+
+      mIslandRoot[mIslandCount] = root;
+      mIslandOf[root] = static_cast<uint32_t>(mIslandCount);
+      ++mIslandCount;
+   }
+
+   /// Remove an island - the last island takes its index, and its list is    
+   /// kept for reuse                                                         
+   ///   @param island - the island to remove                                 
+   inline void BondIslands::RemoveIsland(uint32_t island) noexcept {
+      const auto last = static_cast<uint32_t>(--mIslandCount);
+      mIslandOf[mIslandRoot[island]] = Invalid;
+      if (island == last)
+         return;
+
+      std::swap(mIslands[island], mIslands[last]);
+      mIslandRoot[island] = mIslandRoot[last];
+      mIslandOf[mIslandRoot[island]] = island;
+   }
+
+   /// Change the distance a bond keeps between its ends                      
+   ///   @param bond - the bond                                               
+   ///   @param length - the new rest length                                  
+   inline void BondIslands::SetRestLength(uint32_t bond, Real length) noexcept {
+      LANGULUS_ASSUME(UserAssumes, length >= 0, "Negative rest length");
+      mRest[bond] = length;
+   }
+
+   /// Change how strongly a bond keeps its rest length                       
+   ///   @param bond - the bond                                               
+   ///   @param stiffness - the new stiffness, infinite for a rigid bond      
+   inline void BondIslands::SetStiffness(uint32_t bond, Real stiffness) noexcept {
+      LANGULUS_ASSUME(UserAssumes, stiffness > 0, "Bonds must have some stiffness");
+      mCompliance[bond] = Real(1) / stiffness;
+   }
+
+   /// Change how quickly a soft bond stops oscillating                       
+   ///   @param bond - the bond                                               
+   ///   @param damping - the new damping                                     
+   inline void BondIslands::SetDamping(uint32_t bond, Real damping) noexcept {
+      LANGULUS_ASSUME(UserAssumes, damping >= 0, "Negative damping");
+      mDamping[bond] = damping;
+   }
+
+   /// Get the distance a bond keeps between its ends                         
+   ///   @param bond - the bond                                               
+   ///   @return the rest length                                              
+   inline auto BondIslands::GetRestLength(uint32_t bond) const noexcept -> Real {
+      return mRest[bond];
+   }
+
+   /// Get how strongly a bond keeps its rest length                          
+   ///   @param bond - the bond                                               
+   ///   @return the stiffness, infinite for a rigid bond                     
+   inline auto BondIslands::GetStiffness(uint32_t bond) const noexcept -> Real {
+      return mCompliance[bond] == 0
+         ? std::numeric_limits<Real>::infinity()
+         : Real(1) / mCompliance[bond];
+   }
+
+   /// Get how quickly a soft bond stops oscillating                          
+   ///   @param bond - the bond                                               
+   ///   @return the damping                                                  
+   inline auto BondIslands::GetDamping(uint32_t bond) const noexcept -> Real {
+      return mDamping[bond];
+   }
+
+   /// Get the slot at one end of a bond                                      
+   ///   @param bond - the bond                                               
+   ///   @param end - zero or one                                             
+   ///   @return the slot                                                     
+   inline auto BondIslands::GetSlot(uint32_t bond, Offset end) const noexcept -> Offset {
+      LANGULUS_ASSUME(DevAssumes, end < 2, "Bonds have two ends");
+      return mSlot[bond * 2 + end];
+   }
+
+   /// Get the unit that owns a bond                                          
+   ///   @param bond - the bond                                               
+   ///   @return the owner, or nullptr if the bond has none                   
+   inline auto BondIslands::GetOwner(uint32_t bond) const noexcept -> Bond* {
+      return mOwner[bond];
+   }
+
+   /// Get the most recently bound bond of a slot                             
+   ///   @param slot - the slot                                               
+   ///   @return the bond, or Invalid if the slot has no bonds                
+   inline auto BondIslands::GetFirst(Offset slot) const noexcept -> uint32_t {
+      const auto node = mFirst[slot];
+      return node == Invalid ? Invalid : node / 2;
+   }
+
+   /// Get the number of bound bonds                                          
+   ///   @return the number of bonds                                          
+   inline auto BondIslands::GetCount() const noexcept -> Count {
+      return mState.size() - mFree.size() - mUnbound.size();
+   }
+
+   /// Get the number of islands, as of the last Group                        
+   ///   @return the number of islands                                        
+   inline auto BondIslands::GetIslandCount() const noexcept -> Count {
+      return mIslandCount;
+   }
+
+   /// Get the number of bonds of an island, as of the last Group             
+   ///   @param island - the island                                           
+   ///   @return the number of bonds                                          
+   inline auto BondIslands::GetIslandSize(Offset island) const noexcept -> Count {
+      LANGULUS_ASSUME(DevAssumes, island < GetIslandCount(), "Island out of range");
+      return mIslands[island].size();
+   }
+
+   /// Get the columns of all bonds, along with the bonds of an island, as of 
+   /// the last Group - valid until anything is bound, unbound or grouped     
+   ///   @param island - the island                                           
+   ///   @return the table for the bond solver                                
+   inline auto BondIslands::GetTable(Offset island) const noexcept -> BondSolver::Table {
+      LANGULUS_ASSUME(DevAssumes, island < GetIslandCount(), "Island out of range");
+      return {
+         mSlot.data(), mRest.data(), mCompliance.data(), mDamping.data(),
+         mIslands[island].data(), GetIslandSize(island)
+      };
+   }
+
+   /// Get the number of bonds that the last Group had to regroup, because    
+   /// their islands were dirty                                               
+   ///   @return the number of bonds                                          
+   inline auto BondIslands::GetRegroupedCount() const noexcept -> Count {
+      return mRegrouped;
+   }
+
+   /// Call a function with each bond of a slot - the function must not bind  
+   /// or unbind anything                                                     
+   ///   @param slot - the slot                                               
+   ///   @param call - the function to call with each bond                    
+   template<class F>
+   void BondIslands::ForEachBond(Offset slot, F&& call) const {
+      for (auto node = mFirst[slot]; node != Invalid; node = mNext[node])
+         call(node / 2);
+   }
+
+   /// Call a function with each bond of an island, as of the last Group      
+   ///   @param island - the island                                           
+   ///   @param call - the function to call with each bond                    
+   template<class F>
+   void BondIslands::ForEachInIsland(Offset island, F&& call) const {
+      LANGULUS_ASSUME(DevAssumes, island < GetIslandCount(), "Island out of range");
+      for (auto bond : mIslands[island])
+         call(bond);
+   }
+
+} // namespace Euclidean
@@ -0,0 +1,122 @@
+///                                                                           
+/// Langulus::Module::Physics                                                 
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include "Scheduler.hpp"
+#include <limits>
+#include <vector>
+
+
+///                                                                           
+///   Bond constraint solver                                                  
+///                                                                           
+/// Keeps bonded instances at their rest distance, with extended position     
+/// based dynamics (XPBD) - positions are projected after integration, and    
+/// velocities pick up the projection. Bonds are split in colours by greedy   
+/// graph colouring, so that no two bonds of a colour move the same           
+/// instance, and each colour is solved in parallel, without atomics.         
+/// Static instances are never moved, so they don't constrain colouring.      
+/// Bonds are read from the columns of a table, i.e. the world's bonds, or    
+/// added one by one                                                          
+///                                                                           
+struct Euclidean::BondSolver {
+   /// Marks a slot that isn't a body, or a bond that didn't fit a colour     
+   static constexpr uint32_t Invalid = static_cast<uint32_t>(-1);
+   /// Colours are tracked in a bitmask per body - bonds that don't fit       
+   /// in any of them are solved serially, after all colours                  
+   static constexpr Count ColourLimit = 64;
+
+   /// Pointers to the state of all slots that bonds refer to                 
+   struct State {
+      Real* mX;
+      Real* mY;
+      Real* mZ;
+      Real* mVelocityX;
+      Real* mVelocityY;
+      Real* mVelocityZ;
+      // Slots that are never moved by bonds                            
+      const uint8_t* mStatic;
+   };
+
+   /// Results of the last solve                                              
+   struct Stats {
+      Count mBonds = 0;
+      Count mColours = 0;
+      Count mIterations = 0;
+      // Largest difference between a bond's length and its rest length 
+      Real mResidual = 0;
+   };
+
+   /// Columns of a table of bonds, and which of its bonds to solve           
+   struct Table {
+      // Slots at both ends of each bond, two per bond                  
+      const Offset* mSlots;
+      const Real* mRest;
+      // Inverse of stiffness - zero for rigid bonds                    
+      const Real* mCompliance;
+      const Real* mDamping;
+      // Indices of the bonds to solve                                  
+      const uint32_t* mIndices;
+      Count mCount;
+   };
+
+private:
+   // Bonds added one by one, solved as a table of their own            
+   std::vector<Offset> mAddedSlots;
+   std::vector<Real> mAddedRest;
+   std::vector<Real> mAddedCompliance;
+   std::vector<Real> mAddedDamping;
+   std::vector<uint32_t> mAddedIndices;
+
+   // Each slot bonds refer to becomes a body, so that solving streams  
+   // through a compact copy of their state                             
+   std::vector<uint32_t> mBodyOfSlot;
+   std::vector<Offset> mSlotOfBody;
+   std::vector<Real> mX, mY, mZ;
+   // Positions before projection, and at the beginning of the step     
+   std::vector<Real> mPredictedX, mPredictedY, mPredictedZ;
+   std::vector<Real> mStartX, mStartY, mStartZ;
+   std::vector<Real> mInverseMass;
+   std::vector<uint64_t> mUsedColours;
+
+   // Bodies and parameters of each bond, gathered from the table, and  
+   // the XPBD state of each bond                                       
+   std::vector<uint32_t> mBodyA;
+   std::vector<uint32_t> mBodyB;
+   std::vector<Real> mRest;
+   std::vector<Real> mCompliance;
+   std::vector<Real> mDamping;
+   std::vector<Real> mLambda;
+   std::vector<Real> mError;
+
+   // Bonds sorted by colour, and where each colour begins - the last   
+   // range holds the bonds that didn't fit a colour                    
+   std::vector<uint32_t> mColourOf;
+   std::vector<uint32_t> mOrder;
+   std::vector<Offset> mColourStart;
+
+   Count mIterationLimit = 8;
+   Real mTolerance = Real(1e-4);
+   Stats mStats;
+
+   void Gather(const State&, const Table&, Real dt);
+   void Colour();
+   void Project(Offset from, Offset to, Real dt) noexcept;
+   void Scatter(const State&, Real dt) noexcept;
+
+public:
+   void Clear() noexcept;
+   void Add(Offset a, Offset b, Real rest,
+            Real stiffness = std::numeric_limits<Real>::infinity(), Real damping = 0);
+   void SetIterations(Count limit, Real tolerance) noexcept;
+
+   auto Solve(const State&, const Table&, Real dt, Scheduler* = nullptr) -> const Stats&;
+   auto Solve(const State&, Real dt, Scheduler* = nullptr) -> const Stats&;
+   auto GetStats() const noexcept -> const Stats&;
+};
+
+#include "BondSolver.inl"
@@ -0,0 +1,291 @@
+///                                                                           
+/// Langulus::Module::Physics                                                 
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include "BondSolver.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+
+namespace Euclidean
+{
+
+   /// Remove all added bonds, i.e. before adding the ones to solve next      
+   inline void BondSolver::Clear() noexcept {
+      mAddedSlots.clear();
+      mAddedRest.clear();
+      mAddedCompliance.clear();
+      mAddedDamping.clear();
+      mAddedIndices.clear();
+   }
+
+   /// Add a bond to solve                                                    
+   ///   @param a, b - the slots of the bonded instances                      
+   ///   @param rest - the distance the bond keeps between them               
+   ///   @param stiffness - how strongly the distance is kept, infinite for   
+   ///      a rigid bond                                                      
+   ///   @param damping - how quickly the bond stops oscillating, only for    
+   ///      bonds that aren't rigid                                           
+   inline void BondSolver::Add(Offset a, Offset b, Real rest, Real stiffness, Real damping) {
+      LANGULUS_ASSUME(UserAssumes, stiffness > 0, "Bonds must have some stiffness");
+      mAddedIndices.push_back(static_cast<uint32_t>(mAddedRest.size()));
+      mAddedSlots.push_back(a);
+      mAddedSlots.push_back(b);
+      mAddedRest.push_back(rest);
+      mAddedCompliance.push_back(Real(1) / stiffness);
+      mAddedDamping.push_back(damping);
+   }
+
+   /// Change how long the solver iterates                                    
+   ///   @param limit - the most iterations in a single solve                 
+   ///   @param tolerance - iterating stops once no bond is off its rest      
+   ///      length by more than this                                          
+   inline void BondSolver::SetIterations(Count limit, Real tolerance) noexcept {
+      mIterationLimit = limit;
+      mTolerance = tolerance;
+   }
+
+   /// Project the positions of all bonded slots, so that bonds are kept at   
+   /// their rest lengths, and add the projection to their velocities         
+   ///   @param state - the state of all slots, already integrated            
+   ///   @param table - the bonds to solve                                    
+   ///   @param dt - time between updates, in seconds                         
+   ///   @param scheduler - threads to solve colours on, or nullptr to solve  
+   ///      on this thread                                                    
+   ///   @return the statistics of this solve                                 
+   inline auto BondSolver::Solve(const State& state, const Table& table, Real dt, Scheduler* scheduler) -> const Stats& {
+      // Number of bonds projected in a single chunk                    
+      constexpr Count BondChunk = 256;
+
+      mStats = {};
+      mStats.mBonds = table.mCount;
+      if (not table.mCount or dt <= 0)
+         return mStats;
+
+      Gather(state, table, dt);
+      Colour();
+
+      for (Count iteration = 0; iteration < mIterationLimit; ++iteration) {
+         for (Offset colour = 0; colour <= ColourLimit; ++colour) {
+            const auto from = mColourStart[colour];
+            const auto to = mColourStart[colour + 1];
+            if (scheduler and colour < ColourLimit and to - from > BondChunk) {
+               scheduler->ParallelFor(from, to, BondChunk, [&](Offset f, Offset t) {
+                  Project(f, t, dt);
+               });
+            }
+            else Project(from, to, dt);
+         }
+
+         ++mStats.mIterations;
+         if (*std::max_element(mError.begin(), mError.end()) <= mTolerance)
+            break;
+      }
+
+      Scatter(state, dt);
+
+      for (Offset i = 0; i < mBodyA.size(); ++i) {
+         const auto a = mBodyA[i];
+         const auto b = mBodyB[i];
+         const Real dx = mX[b] - mX[a];
+         const Real dy = mY[b] - mY[a];
+         const Real dz = mZ[b] - mZ[a];
+         const Real length = std::sqrt(dx * dx + dy * dy + dz * dz);
+         mStats.mResidual = std::max(mStats.mResidual, std::abs(length - mRest[i]));
+      }
+      return mStats;
+   }
+
+   /// Solve the bonds that were added one by one                             
+   ///   @param state - the state of all slots, already integrated            
+   ///   @param dt - time between updates, in seconds                         
+   ///   @param scheduler - threads to solve colours on, or nullptr to solve  
+   ///      on this thread                                                    
+   ///   @return the statistics of this solve                                 
+   inline auto BondSolver::Solve(const State& state, Real dt, Scheduler* scheduler) -> const Stats& {
+      const Table added {
+         mAddedSlots.data(), mAddedRest.data(), mAddedCompliance.data(),
+         mAddedDamping.data(), mAddedIndices.data(), mAddedIndices.size()
+      };
+      return Solve(state, added, dt, scheduler);
+   }
+
+   /// Get the statistics of the last solve                                   
+   ///   @return the statistics                                               
+   inline auto BondSolver::GetStats() const noexcept -> const Stats& {
+      return mStats;
+   }
+
+   /// Copy the parameters of each bond, and the state of each bonded slot    
+   /// into a body                                                            
+   ///   @param state - the state of all slots                                
+   ///   @param table - the bonds to solve                                    
+   ///   @param dt - time between updates, in seconds                         
+   inline void BondSolver::Gather(const State& state, const Table& table, Real dt) {
+      const auto count = table.mCount;
+      mSlotOfBody.clear();
+      mBodyA.resize(count);
+      mBodyB.resize(count);
+      mRest.resize(count);
+      mCompliance.resize(count);
+      mDamping.resize(count);
+
+      const auto bodyOf = [&](Offset slot) {
+         if (slot >= mBodyOfSlot.size())
+            mBodyOfSlot.resize(slot + 1, Invalid);
+         auto& body = mBodyOfSlot[slot];
+         if (body == Invalid) {
+            body = static_cast<uint32_t>(mSlotOfBody.size());
+            mSlotOfBody.push_back(slot);
+         }
+         return body;
+      };
+
+      for (Offset i = 0; i < count; ++i) {
+         const auto bond = table.mIndices[i];
+         mBodyA[i] = bodyOf(table.mSlots[bond * 2]);
+         mBodyB[i] = bodyOf(table.mSlots[bond * 2 + 1]);
+         mRest[i] = table.mRest[bond];
+         mCompliance[i] = table.mCompliance[bond];
+         mDamping[i] = table.mDamping[bond];
+      }
+
+      // Only touched entries are reset, so the map is clean next time  
+      for (auto slot : mSlotOfBody)
+         mBodyOfSlot[slot] = Invalid;
+
+      const auto bodies = mSlotOfBody.size();
+      for (auto array : {&mX, &mY, &mZ, &mPredictedX, &mPredictedY, &mPredictedZ,
+                         &mStartX, &mStartY, &mStartZ, &mInverseMass})
+         array->resize(bodies);
+
+      for (Offset i = 0; i < bodies; ++i) {
+         const auto slot = mSlotOfBody[i];
+         mX[i] = mPredictedX[i] = state.mX[slot];
+         mY[i] = mPredictedY[i] = state.mY[slot];
+         mZ[i] = mPredictedZ[i] = state.mZ[slot];
+         // Integration moved slots by their velocity, so undo that to  
+         // find where they were when the step began                    
+         mStartX[i] = mX[i] - state.mVelocityX[slot] * dt;
+         mStartY[i] = mY[i] - state.mVelocityY[slot] * dt;
+         mStartZ[i] = mZ[i] - state.mVelocityZ[slot] * dt;
+         mInverseMass[i] = state.mStatic[slot] ? 0 : 1;
+      }
+
+      mLambda.assign(count, 0);
+      mError.resize(count);
+   }
+
+   /// Assign each bond the lowest colour that no other bond on the same      
+   /// movable body has, and sort bonds by colour                             
+   inline void BondSolver::Colour() {
+      const auto count = mBodyA.size();
+      mUsedColours.assign(mSlotOfBody.size(), 0);
+      mColourOf.resize(count);
+      mColourStart.assign(ColourLimit + 2, 0);
+
+      for (Offset i = 0; i < count; ++i) {
+         const auto a = mBodyA[i];
+         const auto b = mBodyB[i];
+         uint64_t used = 0;
+         if (mInverseMass[a] > 0)
+            used |= mUsedColours[a];
+         if (mInverseMass[b] > 0)
+            used |= mUsedColours[b];
+
+         const auto colour = static_cast<uint32_t>(std::countr_one(used));
+         mColourOf[i] = colour;
+         ++mColourStart[colour + 1];
+         if (colour == ColourLimit)
+            continue;
+
+         if (mInverseMass[a] > 0)
+            mUsedColours[a] |= uint64_t {1} << colour;
+         if (mInverseMass[b] > 0)
+            mUsedColours[b] |= uint64_t {1} << colour;
+      }
+
+      for (Offset colour = 0; colour <= ColourLimit; ++colour) {
+         if (colour < ColourLimit and mColourStart[colour + 1])
+            ++mStats.mColours;
+         mColourStart[colour + 1] += mColourStart[colour];
+      }
+
+      // Counting sort, keeping the order of bonds inside each colour   
+      mOrder.resize(count);
+      std::vector<Offset> cursor {mColourStart.begin(), mColourStart.end() - 1};
+      for (Offset i = 0; i < count; ++i)
+         mOrder[cursor[mColourOf[i]]++] = static_cast<uint32_t>(i);
+   }
+
+   /// Project a range of sorted bonds, one after another                     
+   ///   @param from - the first index in the sorted order                    
+   ///   @param to - the index after the last one                             
+   ///   @param dt - time between updates, in seconds                         
+   inline void BondSolver::Project(Offset from, Offset to, Real dt) noexcept {
+      for (Offset o = from; o < to; ++o) {
+         const auto i = mOrder[o];
+         const auto a = mBodyA[i];
+         const auto b = mBodyB[i];
+         const Real dx = mX[b] - mX[a];
+         const Real dy = mY[b] - mY[a];
+         const Real dz = mZ[b] - mZ[a];
+         const Real length = std::sqrt(dx * dx + dy * dy + dz * dz);
+         const Real error = length - mRest[i];
+         mError[i] = std::abs(error);
+
+         // Coinciding ends have no direction to be pushed apart along  
+         const Real wa = mInverseMass[a];
+         const Real wb = mInverseMass[b];
+         if (wa + wb == 0 or length == 0)
+            continue;
+
+         const Real nx = dx / length;
+         const Real ny = dy / length;
+         const Real nz = dz / length;
+         const Real alpha = mCompliance[i] / (dt * dt);
+         const Real gamma = mCompliance[i] * mDamping[i] / dt;
+
+         // Damping resists the ends moving apart since the step began  
+         const Real moved =
+              nx * ((mX[b] - mStartX[b]) - (mX[a] - mStartX[a]))
+            + ny * ((mY[b] - mStartY[b]) - (mY[a] - mStartY[a]))
+            + nz * ((mZ[b] - mStartZ[b]) - (mZ[a] - mStartZ[a]));
+         const Real delta = (-error - alpha * mLambda[i] - gamma * moved)
+                          / ((1 + gamma) * (wa + wb) + alpha);
+         mLambda[i] += delta;
+
+         mX[a] -= wa * delta * nx;
+         mY[a] -= wa * delta * ny;
+         mZ[a] -= wa * delta * nz;
+         mX[b] += wb * delta * nx;
+         mY[b] += wb * delta * ny;
+         mZ[b] += wb * delta * nz;
+      }
+   }
+
+   /// Write the projected positions back, and change velocities by the       
+   /// projection, so that bodies keep moving the way they were pushed        
+   ///   @param state - the state of all slots                                
+   ///   @param dt - time between updates, in seconds                         
+   inline void BondSolver::Scatter(const State& state, Real dt) noexcept {
+      for (Offset i = 0; i < mSlotOfBody.size(); ++i) {
+         if (mInverseMass[i] == 0)
+            continue;
+
+         const auto slot = mSlotOfBody[i];
+         state.mVelocityX[slot] += (mX[i] - mPredictedX[i]) / dt;
+         state.mVelocityY[slot] += (mY[i] - mPredictedY[i]) / dt;
+         state.mVelocityZ[slot] += (mZ[i] - mPredictedZ[i]) / dt;
+         state.mX[slot] = mX[i];
+         state.mY[slot] = mY[i];
+         state.mZ[slot] = mZ[i];
+      }
+   }
+
+} // namespace Euclidean
@@ -0,0 +1,104 @@
+///                                                                           
+/// Langulus::Module::Physics                                                 
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include "Common.hpp"
+#include <vector>
+
+
+///                                                                           
+///   Broadphase                                                              
+///                                                                           
+/// A dynamic bounding volume hierarchy of axis-aligned boxes. Each proxy     
+/// is stored with a fattened box, so that small movements don't change the   
+/// tree at all, and only proxies that escape their fat box, or whose fat box 
+/// got much larger than needed, get reinserted. Insertion picks the sibling  
+/// with the lowest surface area cost, and the tree is kept balanced with     
+/// rotations                                                                 
+///                                                                           
+struct Euclidean::Broadphase {
+   /// Identifies a proxy inside the tree                                     
+   using Proxy = int32_t;
+   static constexpr Proxy InvalidProxy = -1;
+   /// Deepest tree that can be queried - balancing keeps the tree height     
+   /// logarithmic, so this is never reached in practice                      
+   static constexpr int32_t MaxHeight = 64;
+
+   /// An axis-aligned box                                                    
+   struct Box {
+      Vec3 mMin;
+      Vec3 mMax;
+
+      auto Merge(const Box&) const noexcept -> Box;
+      auto Contains(const Box&) const noexcept -> bool;
+      auto Overlaps(const Box&) const noexcept -> bool;
+      auto GetSurface() const noexcept -> Real;
+   };
+
+   /// A pair of user data, whose fat boxes overlap                           
+   struct Pair {
+      Offset mA;
+      Offset mB;
+   };
+
+private:
+   /// A node in the tree - either a leaf with user data, or a branch with    
+   /// exactly two children                                                   
+   struct Node {
+      Box mBox;
+      // User data, usually an index into some other container          
+      Offset mData;
+      // Parent node for nodes in the tree, next node for free ones     
+      Proxy mParent;
+      Proxy mChild[2];
+      // Leaves have zero height, free nodes have -1                    
+      int32_t mHeight;
+
+      auto IsLeaf() const noexcept -> bool {
+         return mChild[0] == InvalidProxy;
+      }
+   };
+
+   std::vector<Node> mNodes;
+   Proxy mRoot = InvalidProxy;
+   Proxy mFree = InvalidProxy;
+   Count mProxyCount = 0;
+   // How much boxes are fattened in each direction                     
+   Real mMargin;
+   // How much of the displacement is added to the fat box, anticipating
+   // the movement during the following frames                          
+   Real mPrediction;
+
+   auto AllocateNode() -> Proxy;
+   void FreeNode(Proxy) noexcept;
+   void InsertLeaf(Proxy);
+   void RemoveLeaf(Proxy) noexcept;
+   auto Balance(Proxy) noexcept -> Proxy;
+   void Refit(Proxy) noexcept;
+   auto Fatten(const Box&, const Vec3&) const noexcept -> Box;
+
+public:
+   Broadphase(Real margin = Real(0.1), Real prediction = Real(2));
+
+   auto Insert(const Box&, Offset data, const Vec3& displacement = {}) -> Proxy;
+   void Remove(Proxy) noexcept;
+   auto Move(Proxy, const Box&, const Vec3& displacement) -> bool;
+   void Clear() noexcept;
+
+   void SetData(Proxy, Offset) noexcept;
+   auto GetData(Proxy) const noexcept -> Offset;
+   auto GetFatBox(Proxy) const noexcept -> const Box&;
+   auto GetProxyCount() const noexcept -> Count;
+   auto GetHeight() const noexcept -> int32_t;
+   auto IsValid() const noexcept -> bool;
+
+   template<class F>
+   void Query(const Box&, F&&) const;
+   void FindPairs(std::vector<Pair>&) const;
+};
+
+#include "Broadphase.inl"
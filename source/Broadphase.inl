@@ -0,0 +1,477 @@
+///                                                                           
+/// Langulus::Module::Physics                                                 
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include "Broadphase.hpp"
+#include <algorithm>
+
+
+namespace Euclidean
+{
+
+   /// Get the smallest box that contains both boxes                          
+   ///   @param rhs - the other box                                           
+   ///   @return the merged box                                               
+   inline auto Broadphase::Box::Merge(const Box& rhs) const noexcept -> Box {
+      Box result;
+      for (int i = 0; i < 3; ++i) {
+         result.mMin[i] = std::min(mMin[i], rhs.mMin[i]);
+         result.mMax[i] = std::max(mMax[i], rhs.mMax[i]);
+      }
+      return result;
+   }
+
+   /// Check if a box is fully inside this one                                
+   ///   @param rhs - the other box                                           
+   ///   @return true if rhs is contained                                     
+   inline auto Broadphase::Box::Contains(const Box& rhs) const noexcept -> bool {
+      for (int i = 0; i < 3; ++i) {
+         if (rhs.mMin[i] < mMin[i] or rhs.mMax[i] > mMax[i])
+            return false;
+      }
+      return true;
+   }
+
+   /// Check if two boxes overlap (touching counts as overlapping)            
+   ///   @param rhs - the other box                                           
+   ///   @return true if boxes overlap                                        
+   inline auto Broadphase::Box::Overlaps(const Box& rhs) const noexcept -> bool {
+      for (int i = 0; i < 3; ++i) {
+         if (rhs.mMin[i] > mMax[i] or rhs.mMax[i] < mMin[i])
+            return false;
+      }
+      return true;
+   }
+
+   /// Get the surface area of the box, used as insertion cost                
+   ///   @return the surface area                                             
+   inline auto Broadphase::Box::GetSurface() const noexcept -> Real {
+      const auto x = mMax[0] - mMin[0];
+      const auto y = mMax[1] - mMin[1];
+      const auto z = mMax[2] - mMin[2];
+      return 2 * (x * y + y * z + z * x);
+   }
+
+   /// Create an empty broadphase                                             
+   ///   @param margin - how much boxes are fattened in each direction        
+   ///   @param prediction - how many frames of displacement to anticipate    
+   inline Broadphase::Broadphase(Real margin, Real prediction)
+      : mMargin {margin}
+      , mPrediction {prediction} {}
+
+   /// Get a node from the free list, or make a new one                       
+   ///   @return the node index                                               
+   inline auto Broadphase::AllocateNode() -> Proxy {
+      Proxy id;
+      if (mFree != InvalidProxy) {
+         id = mFree;
+         mFree = mNodes[id].mParent;
+      }
+      else {
+         id = static_cast<Proxy>(mNodes.size());
+         mNodes.emplace_back();
+      }
+
+      auto& node = mNodes[id];
+      node.mParent = InvalidProxy;
+      node.mChild[0] = node.mChild[1] = InvalidProxy;
+      node.mHeight = 0;
+      node.mData = 0;
+      return id;
+   }
+
+   /// Put a node in the free list                                            
+   ///   @param id - the node index                                           
+   inline void Broadphase::FreeNode(Proxy id) noexcept {
+      mNodes[id].mParent = mFree;
+      mNodes[id].mHeight = -1;
+      mFree = id;
+   }
+
+   /// Enlarge a box by the margin, and in the direction of movement          
+   ///   @param box - the tight box                                           
+   ///   @param displacement - expected movement over a frame                 
+   ///   @return the fat box                                                  
+   inline auto Broadphase::Fatten(const Box& box, const Vec3& displacement) const noexcept -> Box {
+      Box fat;
+      for (int i = 0; i < 3; ++i) {
+         fat.mMin[i] = box.mMin[i] - mMargin;
+         fat.mMax[i] = box.mMax[i] + mMargin;
+         const auto d = displacement[i] * mPrediction;
+         if (d < 0)
+            fat.mMin[i] += d;
+         else
+            fat.mMax[i] += d;
+      }
+      return fat;
+   }
+
+   /// Add a proxy to the tree                                                
+   ///   @param box - the tight box of the proxy                              
+   ///   @param data - user data, returned in queries                         
+   ///   @param displacement - expected movement over a frame                 
+   ///   @return the proxy                                                    
+   inline auto Broadphase::Insert(const Box& box, Offset data, const Vec3& displacement) -> Proxy {
+      const auto id = AllocateNode();
+      mNodes[id].mBox = Fatten(box, displacement);
+      mNodes[id].mData = data;
+      InsertLeaf(id);
+      ++mProxyCount;
+      return id;
+   }
+
+   /// Remove a proxy from the tree                                           
+   ///   @param id - the proxy to remove                                      
+   inline void Broadphase::Remove(Proxy id) noexcept {
+      LANGULUS_ASSUME(DevAssumes, mNodes[id].IsLeaf(), "Not a proxy");
+      RemoveLeaf(id);
+      FreeNode(id);
+      --mProxyCount;
+   }
+
+   /// Update the box of a proxy. The tree is changed only if the new box     
+   /// escapes the fat box, or if the fat box is much larger than the new     
+   /// box needs - i.e. when a proxy slows down after moving fast             
+   ///   @param id - the proxy to move                                        
+   ///   @param box - the new tight box                                       
+   ///   @param displacement - expected movement over a frame                 
+   ///   @return true if the proxy was reinserted                             
+   inline auto Broadphase::Move(Proxy id, const Box& box, const Vec3& displacement) -> bool {
+      LANGULUS_ASSUME(DevAssumes, mNodes[id].IsLeaf(), "Not a proxy");
+      const auto fat = Fatten(box, displacement);
+      if (mNodes[id].mBox.Contains(box)) {
+         const Vec3 slack {mMargin * 4};
+         const Box huge {fat.mMin - slack, fat.mMax + slack};
+         if (huge.Contains(mNodes[id].mBox))
+            return false;
+      }
+
+      RemoveLeaf(id);
+      mNodes[id].mBox = fat;
+      InsertLeaf(id);
+      return true;
+   }
+
+   /// Remove all proxies                                                     
+   inline void Broadphase::Clear() noexcept {
+      mNodes.clear();
+      mRoot = mFree = InvalidProxy;
+      mProxyCount = 0;
+   }
+
+   /// Change the user data of a proxy                                        
+   ///   @param id - the proxy                                                
+   ///   @param data - the new user data                                      
+   inline void Broadphase::SetData(Proxy id, Offset data) noexcept {
+      mNodes[id].mData = data;
+   }
+
+   /// Get the user data of a proxy                                           
+   ///   @param id - the proxy                                                
+   ///   @return the user data                                                
+   inline auto Broadphase::GetData(Proxy id) const noexcept -> Offset {
+      return mNodes[id].mData;
+   }
+
+   /// Get the fattened box of a proxy                                        
+   ///   @param id - the proxy                                                
+   ///   @return the box, as stored in the tree                               
+   inline auto Broadphase::GetFatBox(Proxy id) const noexcept -> const Box& {
+      return mNodes[id].mBox;
+   }
+
+   /// Get the number of proxies in the tree                                  
+   ///   @return the number of proxies                                        
+   inline auto Broadphase::GetProxyCount() const noexcept -> Count {
+      return mProxyCount;
+   }
+
+   /// Get the height of the tree                                             
+   ///   @return the height, where a single proxy has height zero             
+   inline auto Broadphase::GetHeight() const noexcept -> int32_t {
+      return mRoot == InvalidProxy ? 0 : mNodes[mRoot].mHeight;
+   }
+
+   /// Insert a leaf node in the place with the lowest surface area cost      
+   ///   @param leaf - the leaf to insert                                     
+   inline void Broadphase::InsertLeaf(Proxy leaf) {
+      if (mRoot == InvalidProxy) {
+         mRoot = leaf;
+         mNodes[leaf].mParent = InvalidProxy;
+         return;
+      }
+
+      // Find the best sibling                                          
+      const auto box = mNodes[leaf].mBox;
+      Proxy index = mRoot;
+      while (not mNodes[index].IsLeaf()) {
+         const auto& node = mNodes[index];
+         const auto surface = node.mBox.GetSurface();
+         const auto combined = node.mBox.Merge(box).GetSurface();
+
+         // Cost of creating a new parent for this node and the leaf    
+         const auto cost = 2 * combined;
+         // Minimum cost of pushing the leaf further down the tree      
+         const auto inheritance = 2 * (combined - surface);
+
+         Real childCost[2];
+         for (int c = 0; c < 2; ++c) {
+            const auto& child = mNodes[node.mChild[c]];
+            const auto merged = child.mBox.Merge(box).GetSurface();
+            childCost[c] = child.IsLeaf()
+               ? merged + inheritance
+               : merged - child.mBox.GetSurface() + inheritance;
+         }
+
+         if (cost < childCost[0] and cost < childCost[1])
+            break;
+
+         index = childCost[0] < childCost[1] ? node.mChild[0] : node.mChild[1];
+      }
+
+      // Create a new parent for the sibling and the leaf               
+      const Proxy sibling = index;
+      const Proxy oldParent = mNodes[sibling].mParent;
+      const Proxy newParent = AllocateNode();
+      mNodes[newParent].mParent = oldParent;
+      mNodes[newParent].mBox = box.Merge(mNodes[sibling].mBox);
+      mNodes[newParent].mHeight = mNodes[sibling].mHeight + 1;
+      mNodes[newParent].mChild[0] = sibling;
+      mNodes[newParent].mChild[1] = leaf;
+      mNodes[sibling].mParent = newParent;
+      mNodes[leaf].mParent = newParent;
+
+      if (oldParent != InvalidProxy) {
+         auto& parent = mNodes[oldParent];
+         parent.mChild[parent.mChild[0] == sibling ? 0 : 1] = newParent;
+      }
+      else mRoot = newParent;
+
+      // Fix heights and boxes on the way up                            
+      Refit(mNodes[leaf].mParent);
+   }
+
+   /// Remove a leaf node, replacing its parent with its sibling              
+   ///   @param leaf - the leaf to remove                                     
+   inline void Broadphase::RemoveLeaf(Proxy leaf) noexcept {
+      if (leaf == mRoot) {
+         mRoot = InvalidProxy;
+         return;
+      }
+
+      const Proxy parent = mNodes[leaf].mParent;
+      const Proxy grandParent = mNodes[parent].mParent;
+      const Proxy sibling = mNodes[parent].mChild[0] == leaf
+         ? mNodes[parent].mChild[1] : mNodes[parent].mChild[0];
+
+      if (grandParent != InvalidProxy) {
+         auto& node = mNodes[grandParent];
+         node.mChild[node.mChild[0] == parent ? 0 : 1] = sibling;
+         mNodes[sibling].mParent = grandParent;
+         FreeNode(parent);
+         Refit(grandParent);
+      }
+      else {
+         mRoot = sibling;
+         mNodes[sibling].mParent = InvalidProxy;
+         FreeNode(parent);
+      }
+   }
+
+   /// Balance and recompute boxes and heights, from a node up to the root    
+   ///   @param index - the first node to refit                               
+   inline void Broadphase::Refit(Proxy index) noexcept {
+      while (index != InvalidProxy) {
+         index = Balance(index);
+         auto& node = mNodes[index];
+         const auto& a = mNodes[node.mChild[0]];
+         const auto& b = mNodes[node.mChild[1]];
+         node.mHeight = 1 + std::max(a.mHeight, b.mHeight);
+         node.mBox = a.mBox.Merge(b.mBox);
+         index = node.mParent;
+      }
+   }
+
+   /// Perform a left or right rotation if a node's subtrees are imbalanced   
+   ///   @param a - the node to balance                                       
+   ///   @return the node that took the place of 'a'                          
+   inline auto Broadphase::Balance(Proxy a) noexcept -> Proxy {
+      auto& A = mNodes[a];
+      if (A.IsLeaf() or A.mHeight < 2)
+         return a;
+
+      // Rotate the taller child 'up', in place of 'a'                  
+      const auto rotate = [&](int up) -> Proxy {
+         const Proxy c = A.mChild[up];
+         const Proxy b = A.mChild[1 - up];
+         auto& C = mNodes[c];
+         const Proxy f = C.mChild[0];
+         const Proxy g = C.mChild[1];
+         auto& F = mNodes[f];
+         auto& G = mNodes[g];
+
+         C.mChild[0] = a;
+         C.mParent = A.mParent;
+         A.mParent = c;
+
+         if (C.mParent != InvalidProxy) {
+            auto& parent = mNodes[C.mParent];
+            parent.mChild[parent.mChild[0] == a ? 0 : 1] = c;
+         }
+         else mRoot = c;
+
+         // Keep the taller grandchild under 'c'                        
+         const auto& B = mNodes[b];
+         const Proxy keep = F.mHeight > G.mHeight ? f : g;
+         const Proxy move = F.mHeight > G.mHeight ? g : f;
+         auto& K = mNodes[keep];
+         auto& M = mNodes[move];
+
+         C.mChild[1] = keep;
+         A.mChild[up] = move;
+         M.mParent = a;
+         A.mBox = B.mBox.Merge(M.mBox);
+         C.mBox = A.mBox.Merge(K.mBox);
+         A.mHeight = 1 + std::max(B.mHeight, M.mHeight);
+         C.mHeight = 1 + std::max(A.mHeight, K.mHeight);
+         return c;
+      };
+
+      const auto balance = mNodes[A.mChild[1]].mHeight - mNodes[A.mChild[0]].mHeight;
+      if (balance > 1)
+         return rotate(1);
+      if (balance < -1)
+         return rotate(0);
+      return a;
+   }
+
+   /// Check the integrity of the whole tree, used for testing                
+   ///   @return true if all links, heights and boxes are consistent          
+   inline auto Broadphase::IsValid() const noexcept -> bool {
+      if (mRoot == InvalidProxy)
+         return mProxyCount == 0;
+      if (mNodes[mRoot].mParent != InvalidProxy)
+         return false;
+
+      Count leaves = 0;
+      std::vector<Proxy> stack {mRoot};
+      while (not stack.empty()) {
+         const auto id = stack.back();
+         stack.pop_back();
+         const auto& node = mNodes[id];
+         if (node.IsLeaf()) {
+            if (node.mHeight != 0)
+               return false;
+            ++leaves;
+            continue;
+         }
+
+         const auto& a = mNodes[node.mChild[0]];
+         const auto& b = mNodes[node.mChild[1]];
+         if (a.mParent != id or b.mParent != id)
+            return false;
+         if (node.mHeight != 1 + std::max(a.mHeight, b.mHeight))
+            return false;
+         if (std::abs(a.mHeight - b.mHeight) > 1)
+            return false;
+         if (not node.mBox.Contains(a.mBox) or not node.mBox.Contains(b.mBox))
+            return false;
+
+         stack.push_back(node.mChild[0]);
+         stack.push_back(node.mChild[1]);
+      }
+
+      return leaves == mProxyCount;
+   }
+
+   /// Find all proxies whose fat boxes overlap a box                         
+   ///   @param box - the box to test                                         
+   ///   @param call - called with each overlapping proxy; return false       
+   ///      from it to stop the query early                                   
+   template<class F>
+   void Broadphase::Query(const Box& box, F&& call) const {
+      if (mRoot == InvalidProxy)
+         return;
+
+      // Explicit stack, local so that calls can query the tree again.  
+      // Each level leaves at most one node behind, and balancing keeps 
+      // the tree far shallower than the stack                          
+      LANGULUS_ASSUME(DevAssumes, mNodes[mRoot].mHeight < MaxHeight,
+         "Tree is too deep");
+      Proxy stack[MaxHeight + 1];
+      Count top = 0;
+      stack[top++] = mRoot;
+
+      while (top) {
+         const auto id = stack[--top];
+         const auto& node = mNodes[id];
+         if (not node.mBox.Overlaps(box))
+            continue;
+
+         if (node.IsLeaf()) {
+            if (not call(id))
+               return;
+         }
+         else {
+            stack[top++] = node.mChild[0];
+            stack[top++] = node.mChild[1];
+         }
+      }
+   }
+
+   /// Find all pairs of proxies whose fat boxes overlap                      
+   /// The tree is traversed against itself, so that whole subtrees that      
+   /// don't overlap are discarded at once. Each pair is reported once, with  
+   /// the user data of both proxies                                          
+   ///   @param pairs - [out] the list to append pairs to                     
+   inline void Broadphase::FindPairs(std::vector<Pair>& pairs) const {
+      if (mRoot == InvalidProxy)
+         return;
+
+      struct Task {
+         Proxy mA;
+         Proxy mB;
+      };
+
+      std::vector<Task> stack;
+      stack.push_back({mRoot, mRoot});
+
+      while (not stack.empty()) {
+         const auto [a, b] = stack.back();
+         stack.pop_back();
+         const auto& A = mNodes[a];
+
+         if (a == b) {
+            // Pairs inside a subtree - both children, and between them 
+            if (not A.IsLeaf()) {
+               stack.push_back({A.mChild[0], A.mChild[0]});
+               stack.push_back({A.mChild[1], A.mChild[1]});
+               stack.push_back({A.mChild[0], A.mChild[1]});
+            }
+            continue;
+         }
+
+         const auto& B = mNodes[b];
+         if (not A.mBox.Overlaps(B.mBox))
+            continue;
+
+         if (A.IsLeaf() and B.IsLeaf())
+            pairs.push_back({A.mData, B.mData});
+         else if (A.IsLeaf() or (not B.IsLeaf()
+         and B.mBox.GetSurface() > A.mBox.GetSurface())) {
+            // Descend into the larger subtree                          
+            stack.push_back({a, B.mChild[0]});
+            stack.push_back({a, B.mChild[1]});
+         }
+         else {
+            stack.push_back({A.mChild[0], b});
+            stack.push_back({A.mChild[1], b});
+         }
+      }
+   }
+
+} // namespace Euclidean
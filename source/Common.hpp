@@ -7,6 +7,7 @@
 ///                                                                           
 #pragma once
 #include <Langulus/Physical.hpp>
+#include <cmath>
 
 using namespace Langulus;
 using namespace Math;
@@ -19,7 +20,27 @@ namespace Euclidean
    struct Particles;
    struct Instance;
    struct Bond;
+   struct BondIslands;
+   struct BondSolver;
    struct Field;
+   struct FieldTree;
+   struct Poisson;
+   struct InstancePool;
+   struct Scheduler;
+   struct Broadphase;
+   struct OctaveIndex;
+   struct Aggregates;
+   struct ParticlePool;
+   struct ParticleStates;
+   struct SpatialHash;
+
+   /// Get the whole octave a level falls in                                  
+   ///   @param level - the level                                             
+   ///   @return the octave                                                   
+   LANGULUS(INLINED)
+   int OctaveOf(const Level& level) noexcept {
+      return static_cast<int>(std::floor(static_cast<Real>(level)));
+   }
 }
 
 #if 1
@@ -0,0 +1,64 @@
+///                                                                           
+/// Langulus::Module::Physics                                                 
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include "Integrator.hpp"
+
+
+///                                                                           
+///   Batched frustum culling kernels                                         
+///                                                                           
+/// Test the bounding boxes of many instances against a frustum at once, by   
+/// running over the position and extent arrays of an InstancePool. Results   
+/// are written as a bitset - one bit per slot, set if the box is visible.    
+/// Uses the same instruction sets as the Integrator, picked at runtime       
+///                                                                           
+namespace Euclidean::Culling
+{
+   using Integrator::ISA;
+
+   /// A single word of the visibility bitset                                 
+   using Word = uint64_t;
+   /// Number of slots in a single word                                       
+   constexpr Count WordBits = sizeof(Word) * 8;
+
+   /// Frustum planes, kept as separate arrays for each component             
+   /// A point is inside a plane if dot(normal, point) + offset >= 0          
+   struct Frustum {
+      static constexpr Count Planes = 6;
+
+      Real mNormalX[Planes] {};
+      Real mNormalY[Planes] {};
+      Real mNormalZ[Planes] {};
+      Real mOffset[Planes] {};
+
+      // Absolute normals, used to project the box extent on the normal 
+      Real mAbsX[Planes] {};
+      Real mAbsY[Planes] {};
+      Real mAbsZ[Planes] {};
+
+      void SetPlane(Offset, const Vec3& normal, Real offset) noexcept;
+   };
+
+   /// Pointers to the centers and half-sizes of all boxes                    
+   struct Bounds {
+      const Real* mX;
+      const Real* mY;
+      const Real* mZ;
+      const Real* mExtentX;
+      const Real* mExtentY;
+      const Real* mExtentZ;
+   };
+
+   auto GetWordCount(Count) noexcept -> Count;
+   auto IsVisible(const Word*, Offset) noexcept -> bool;
+
+   void Test(ISA, const Frustum&, const Bounds&, Offset from, Offset to, Word*) noexcept;
+
+} // namespace Euclidean::Culling
+
+#include "Culling.inl"
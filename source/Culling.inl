@@ -0,0 +1,194 @@
+///                                                                           
+/// Langulus::Module::Physics                                                 
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include "Culling.hpp"
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+
+
+namespace Euclidean::Culling
+{
+
+   /// Set a plane of the frustum                                             
+   ///   @param i - the plane index                                           
+   ///   @param normal - the plane normal, pointing inside the frustum        
+   ///   @param offset - the signed distance of the origin from the plane     
+   inline void Frustum::SetPlane(Offset i, const Vec3& normal, Real offset) noexcept {
+      LANGULUS_ASSUME(DevAssumes, i < Planes, "Plane out of range");
+      mNormalX[i] = normal.x;
+      mNormalY[i] = normal.y;
+      mNormalZ[i] = normal.z;
+      mOffset[i] = offset;
+      mAbsX[i] = std::abs(normal.x);
+      mAbsY[i] = std::abs(normal.y);
+      mAbsZ[i] = std::abs(normal.z);
+   }
+
+   /// Get the number of words required to hold the visibility of some slots  
+   ///   @param count - number of slots                                       
+   ///   @return the number of words                                          
+   inline Count GetWordCount(Count count) noexcept {
+      return (count + WordBits - 1) / WordBits;
+   }
+
+   /// Check a single slot in a visibility bitset                             
+   ///   @param bits - the bitset                                             
+   ///   @param slot - the slot to check                                      
+   ///   @return true if the slot is visible                                  
+   inline bool IsVisible(const Word* bits, Offset slot) noexcept {
+      return (bits[slot / WordBits] >> (slot % WordBits)) & 1;
+   }
+
+   namespace Inner
+   {
+
+      /// Test a single box against all planes                                
+      ///   @param f - the frustum                                            
+      ///   @param b - the boxes                                              
+      ///   @param i - the slot index                                         
+      ///   @return true if the box is at least partially inside              
+      LANGULUS(INLINED)
+      bool Step(const Frustum& f, const Bounds& b, Offset i) noexcept {
+         bool visible = true;
+         for (Offset p = 0; p < Frustum::Planes; ++p) {
+            // Distance of the center, and the extent projected on the  
+            // normal - the box is outside if both are behind the plane 
+            const Real d = f.mNormalX[p] * b.mX[i]
+                         + f.mNormalY[p] * b.mY[i]
+                         + f.mNormalZ[p] * b.mZ[i] + f.mOffset[p];
+            const Real r = f.mAbsX[p] * b.mExtentX[i]
+                         + f.mAbsY[p] * b.mExtentY[i]
+                         + f.mAbsZ[p] * b.mExtentZ[i];
+            visible &= not (d + r < 0);
+         }
+         return visible;
+      }
+
+      /// Test a range of boxes, one at a time                                
+      ///   @param f - the frustum                                            
+      ///   @param b - the boxes                                              
+      ///   @param from - first slot, must be at the start of a word          
+      ///   @param to - the slot after the last one                           
+      ///   @param bits - [out] the bitset to write to                        
+      inline void Run(const Frustum& f, const Bounds& b, Offset from, Offset to, Word* bits) noexcept {
+         for (Offset i = from; i < to; ++i)
+            bits[i / WordBits] |= Word {Step(f, b, i)} << (i % WordBits);
+      }
+
+   #if PHYSICS_SIMD_X86()
+      /// Integer of the same size as Real, produced by vector comparisons    
+      using Mask = std::conditional_t<sizeof(Real) == 8, int64_t, int32_t>;
+
+      /// Test W consecutive boxes with a single vector per array             
+      /// Must only be inlined in functions that target a wide enough ISA     
+      ///   @tparam W - number of slots processed at once                     
+      ///   @param f - the frustum                                            
+      ///   @param b - the boxes                                              
+      ///   @param i - the first slot index                                   
+      ///   @return a mask with one bit per slot, set if visible              
+      template<Count W>
+      LANGULUS(INLINED)
+      Word StepPack(const Frustum& f, const Bounds& b, Offset i) noexcept {
+         typedef Real V __attribute__((vector_size(W * sizeof(Real))));
+         typedef Mask M __attribute__((vector_size(W * sizeof(Real))));
+         V x, y, z, ex, ey, ez;
+         std::memcpy(&x,  b.mX + i,       sizeof(V));
+         std::memcpy(&y,  b.mY + i,       sizeof(V));
+         std::memcpy(&z,  b.mZ + i,       sizeof(V));
+         std::memcpy(&ex, b.mExtentX + i, sizeof(V));
+         std::memcpy(&ey, b.mExtentY + i, sizeof(V));
+         std::memcpy(&ez, b.mExtentZ + i, sizeof(V));
+
+         // Same operations as in Step, in the same order               
+         M outside = {};
+         for (Offset p = 0; p < Frustum::Planes; ++p) {
+            const V d = f.mNormalX[p] * x
+                      + f.mNormalY[p] * y
+                      + f.mNormalZ[p] * z + f.mOffset[p];
+            const V r = f.mAbsX[p] * ex
+                      + f.mAbsY[p] * ey
+                      + f.mAbsZ[p] * ez;
+            outside |= (d + r < V {});
+         }
+
+         // Lanes are all ones if outside, and zeroes if visible        
+         Mask lanes[W];
+         std::memcpy(lanes, &outside, sizeof(lanes));
+         Word mask = 0;
+         for (Offset k = 0; k < W; ++k)
+            mask |= Word {lanes[k] == 0} << k;
+         return mask;
+      }
+
+      /// Test a range in packs of W slots, and the remainder one by one      
+      ///   @tparam W - number of slots processed at once                     
+      template<Count W>
+      LANGULUS(INLINED)
+      void RunPacked(const Frustum& f, const Bounds& b, Offset from, Offset to, Word* bits) noexcept {
+         static_assert(WordBits % W == 0, "Packs must not straddle words");
+         Offset i = from;
+         for (; i + W <= to; i += W)
+            bits[i / WordBits] |= StepPack<W>(f, b, i) << (i % WordBits);
+         Run(f, b, i, to, bits);
+      }
+
+      PHYSICS_TARGET("sse4.1")
+      inline void RunSSE4(const Frustum& f, const Bounds& b, Offset from, Offset to, Word* bits) noexcept {
+         RunPacked<16 / sizeof(Real)>(f, b, from, to, bits);
+      }
+
+      PHYSICS_TARGET("avx2")
+      inline void RunAVX2(const Frustum& f, const Bounds& b, Offset from, Offset to, Word* bits) noexcept {
+         RunPacked<32 / sizeof(Real)>(f, b, from, to, bits);
+      }
+
+      PHYSICS_TARGET("avx512f")
+      inline void RunAVX512(const Frustum& f, const Bounds& b, Offset from, Offset to, Word* bits) noexcept {
+         RunPacked<64 / sizeof(Real)>(f, b, from, to, bits);
+      }
+   #endif
+
+   } // namespace Euclidean::Culling::Inner
+
+
+   /// Test a range of boxes against a frustum                                
+   /// The words that cover the range are overwritten, so ranges that are     
+   /// aligned to words can be tested concurrently                            
+   /// Falls back to the scalar kernel if the instruction set is unsupported  
+   ///   @param isa - the instruction set to use                              
+   ///   @param f - the frustum                                               
+   ///   @param b - the boxes                                                 
+   ///   @param from - first slot, must be at the start of a word             
+   ///   @param to - the slot after the last one                              
+   ///   @param bits - [out] the bitset to write to                           
+   inline void Test(ISA isa, const Frustum& f, const Bounds& b, Offset from, Offset to, Word* bits) noexcept {
+      LANGULUS_ASSUME(DevAssumes, from % WordBits == 0,
+         "Range must begin at a word boundary");
+      if (from >= to)
+         return;
+
+      std::fill(bits + from / WordBits, bits + GetWordCount(to), Word {0});
+      if (not Integrator::IsSupported(isa))
+         isa = ISA::Scalar;
+
+      switch (isa) {
+   #if PHYSICS_SIMD_X86()
+      case ISA::SSE4:
+         return Inner::RunSSE4(f, b, from, to, bits);
+      case ISA::AVX2:
+         return Inner::RunAVX2(f, b, from, to, bits);
+      case ISA::AVX512:
+         return Inner::RunAVX512(f, b, from, to, bits);
+   #endif
+      default:
+         return Inner::Run(f, b, from, to, bits);
+      }
+   }
+
+} // namespace Euclidean::Culling
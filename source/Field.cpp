@@ -11,23 +11,162 @@
 using namespace Euclidean;
 
 
-/// World construction                                                        
-///   @param producer - window owner                                          
-///   @param descriptor - window descriptor                                   
+/// Field construction                                                        
+///   @param producer - the world that owns the field                         
+///   @param descriptor - field descriptor                                    
 Field::Field(World* producer, const Many& descriptor)
    : Resolvable {this}
    , Instance   {producer, descriptor} {
    VERBOSE_PHYSICS("Initializing...");
    Couple(descriptor);
+   Refresh();
    VERBOSE_PHYSICS("Initialized");
 }
 
-/// Refresh the world component on environment change                         
+/// Refresh the field on environment change - the field covers the bounds     
+/// of its instance, unless they're degenerate                                
 void Field::Refresh() {
+   const auto& pool = GetProducer()->GetPool();
+   const auto slot = GetSlot();
+   if (slot == InstancePool::InvalidSlot or pool.mUnbounded[slot])
+      return;
 
+   const auto box = pool.GetBox(slot);
+   SetVolume(box.mMin, box.mMax - box.mMin);
 }
 
-/// Update the window                                                         
+/// Update the field - evaluate the blocks whose inputs changed. Blocks are   
+/// refined around instances when the world applies the field to them         
 void Field::Update(Real) {
+   Refill();
+}
+
+/// Refine the blocks around the instances that the field is applied to,      
+/// and evaluate the blocks that were created. Instances the field doesn't    
+/// affect are never passed in, so no blocks are spent on them                
+///   @param x, y, z - positions of the instances inside the volume           
+///   @param moving - whether each instance is awake                          
+///   @param count - the number of instances                                  
+void Field::Adapt(const Real* x, const Real* y, const Real* z, const uint8_t* moving, Count count) {
+   // Sleeping instances don't move, so unless some were added or       
+   // removed, the blocks need refining only if an awake one moved into 
+   // a leaf that isn't at the maximum depth. Leaves that were merely   
+   // left behind are coarsened on the next adaptation                  
+   bool adapt = mReadapt or count != mAdaptedCount;
+   for (Offset i = 0; i < count and not adapt; ++i)
+      adapt = moving[i] and mValues.NeedsRefinement(Vec3 {x[i], y[i], z[i]});
+   if (not adapt)
+      return;
+
+   if (mValues.Adapt(x, y, z, count))
+      Refill();
+   mAdaptedCount = count;
+   mReadapt = false;
+}
+
+/// Evaluate the blocks that are new, or whose inputs changed                 
+void Field::Refill() {
+   mValues.Refill([&](const Vec3& at) {
+      return Evaluate(at);
+   });
+}
+
+/// Change the volume the field affects, discarding all of its blocks         
+///   @param origin - the lowest corner of the volume                         
+///   @param size - the size of the volume along each axis                    
+void Field::SetVolume(const Vec3& origin, const Vec3& size) {
+   mValues.SetVolume(origin, size);
+   mReadapt = true;
+}
+
+/// Change how fine the field gets around instances                           
+///   @param depth - the number of times the volume can be halved             
+void Field::SetDepth(Count depth) noexcept {
+   if (depth == mValues.GetDepth())
+      return;
+
+   mValues.SetDepth(depth);
+   mReadapt = true;
+}
+
+/// Change the acceleration everywhere inside the volume                      
+///   @param acceleration - the uniform acceleration                          
+void Field::SetUniform(const Vec3& acceleration) noexcept {
+   if (acceleration.x == mUniform.x and acceleration.y == mUniform.y
+   and acceleration.z == mUniform.z)
+      return;
+
+   mUniform = acceleration;
+   mValues.Invalidate();
+}
+
+/// Add a point source to the field                                           
+///   @param source - the source                                              
+///   @return the index of the source                                         
+Offset Field::AddSource(const Source& source) {
+   Invalidate(source);
+   mSources.push_back(source);
+   return mSources.size() - 1;
+}
+
+/// Change a point source                                                     
+///   @param index - the index of the source                                  
+///   @param source - the new source                                          
+void Field::SetSource(Offset index, const Source& source) noexcept {
+   LANGULUS_ASSUME(UserAssumes, index < mSources.size(), "Bad source");
+   Invalidate(mSources[index]);
+   Invalidate(source);
+   mSources[index] = source;
+}
+
+/// Remove a point source - the last source takes its index                   
+///   @param index - the index of the source                                  
+void Field::RemoveSource(Offset index) noexcept {
+   LANGULUS_ASSUME(UserAssumes, index < mSources.size(), "Bad source");
+   Invalidate(mSources[index]);
+   mSources[index] = mSources.back();
+   mSources.pop_back();
+}
+
+/// Mark the blocks within a source's range as stale, so that they're         
+/// recomputed on the next update                                             
+///   @param source - the source                                              
+void Field::Invalidate(const Source& source) {
+   if (source.mRange == std::numeric_limits<Real>::infinity())
+      return mValues.Invalidate();
+
+   const Vec3 range {source.mRange};
+   mValues.Invalidate(source.mPosition - range, source.mPosition + range);
+}
+
+/// Compute the exact acceleration at a point, from the uniform part and all  
+/// sources in range. Sources pull with a softened inverse square law         
+///   @param at - the point                                                   
+///   @return the acceleration                                                
+Vec3 Field::Evaluate(const Vec3& at) const noexcept {
+   Vec3 result = mUniform;
+   for (const auto& source : mSources) {
+      const Vec3 d = source.mPosition - at;
+      const Real distanceSquared = d.x * d.x + d.y * d.y + d.z * d.z;
+      if (distanceSquared > source.mRange * source.mRange)
+         continue;
+
+      const Real softened = distanceSquared + source.mSoftening * source.mSoftening;
+      result += d * (source.mStrength / (softened * std::sqrt(softened)));
+   }
+   return result;
+}
+
+/// Interpolate the acceleration at a point, from the field's blocks as of    
+/// the last update                                                           
+///   @param at - the point                                                   
+///   @return the acceleration, or zero outside the field's volume            
+Vec3 Field::Sample(const Vec3& at) const noexcept {
+   return mValues.Sample(at);
+}
 
+/// Get the values of the field, as of the last update                        
+///   @return the field's blocks                                              
+auto Field::GetValues() const noexcept -> const FieldTree& {
+   return mValues;
 }
\ No newline at end of file
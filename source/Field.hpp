@@ -7,21 +7,66 @@
 ///                                                                           
 #pragma once
 #include "Instance.hpp"
+#include "FieldTree.hpp"
+#include <limits>
+#include <vector>
 
 
 ///                                                                           
 ///   Field                                                                   
 ///                                                                           
-/// Affects instances over a volume                                           
+/// Affects instances over a volume. The field is an acceleration - uniform   
+/// over the volume, plus the pull of point sources - and its values are kept 
+/// on an adaptive tree, refined around the instances the field is applied to.
+/// Changes are tracked, so that only blocks affected by a changed uniform    
+/// or source are recomputed, and a field that doesn't change, over           
+/// instances that don't move, costs nothing on update                        
 ///                                                                           
 struct Euclidean::Field : A::Field, Instance {
    LANGULUS(ABSTRACT) false;
    LANGULUS(PRODUCER) World;
    LANGULUS_BASES(A::Field /*Instance base intentionally obscured*/);
 
+   /// A point that pulls everything towards it, like a gravity well          
+   struct Source {
+      Vec3 mPosition;
+      // Acceleration at unit distance, negative values push away       
+      Real mStrength = 1;
+      // The pull stops growing closer than about this distance         
+      Real mSoftening = 1;
+      // The source has no effect beyond this distance                  
+      Real mRange = std::numeric_limits<Real>::infinity();
+   };
+
+private:
+   // Values of the field over its volume                               
+   FieldTree mValues;
+   // Acceleration everywhere inside the volume, i.e. wind              
+   Vec3 mUniform;
+   std::vector<Source> mSources;
+   // Number of instances the blocks were last adapted around           
+   Count mAdaptedCount = 0;
+   // Whether the blocks must be adapted, even if no instance moved     
+   bool mReadapt = true;
+
+   void Invalidate(const Source&);
+   void Refill();
+
 public:
    Field(World*, const Many&);
 
    void Update(Real);
    void Refresh() override;
+   void Adapt(const Real* x, const Real* y, const Real* z, const uint8_t* moving, Count);
+
+   void SetVolume(const Vec3& origin, const Vec3& size);
+   void SetDepth(Count) noexcept;
+   void SetUniform(const Vec3&) noexcept;
+   auto AddSource(const Source&) -> Offset;
+   void SetSource(Offset, const Source&) noexcept;
+   void RemoveSource(Offset) noexcept;
+
+   auto Evaluate(const Vec3&) const noexcept -> Vec3;
+   auto Sample(const Vec3&) const noexcept -> Vec3;
+   auto GetValues() const noexcept -> const FieldTree&;
 };
\ No newline at end of file
@@ -0,0 +1,78 @@
+///                                                                           
+/// Langulus::Module::Physics                                                 
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include "amr/Mesh.hpp"
+
+
+///                                                                           
+///   Adaptive field storage                                                  
+///                                                                           
+/// Keeps a vector on each cell of an AMR tree, that covers a box-shaped      
+/// volume. Blocks are refined around given points - usually the instances    
+/// inside the volume - up to a maximum depth, and coarsened where there are  
+/// none, so resolution is spent only where the field is sampled. Sampling    
+/// is trilinear between the centres of the cells around a point, and reads   
+/// the halos of blocks, so it's continuous between blocks of the same level  
+/// Blocks are recomputed lazily - only those that were created by the last   
+/// adaptation, or whose inputs were invalidated since the last fill - and a  
+/// refill is free when no block is stale                                     
+///                                                                           
+struct Euclidean::FieldTree {
+   /// A single component of the vector on each cell                          
+   using Component = AMR::AverageGrid<Real>;
+   /// Blocks of 8x8x8 cells, with a grid for each component                  
+   using Config = AMR::MeshConfig<3, 8, Component, Component, Component>;
+   using Node = AMR::Node<Config>;
+   using Tree = AMR::Tree<Config>;
+
+   static constexpr Count BlockSize = Config::BlockSize;
+
+private:
+   Tree mTree;
+   // The volume covered by the root block                              
+   Vec3 mOrigin {0};
+   Vec3 mSize {1};
+   // Maximum level of refinement below the root                        
+   Count mDepth = 3;
+   // Leaves recomputed and left as they were, on the last refill       
+   Count mRecomputed = 0;
+   Count mReused = 0;
+   // Whether any leaf might be stale since the last refill             
+   bool mStale = true;
+
+   auto Locate(const Vec3&, Vec3&) const noexcept -> Node*;
+   static auto Interpolate(const Node&, const Vec3&) noexcept -> Vec3;
+
+public:
+   void SetVolume(const Vec3& origin, const Vec3& size);
+   void SetDepth(Count) noexcept;
+   auto Adapt(const Real* x, const Real* y, const Real* z, Count) -> bool;
+   template<class F>
+   void Fill(F&&);
+   template<class F>
+   auto Refill(F&&) -> Count;
+   void Invalidate();
+   void Invalidate(const Vec3& min, const Vec3& max);
+
+   auto Contains(const Vec3&) const noexcept -> bool;
+   auto NeedsRefinement(const Vec3&) const noexcept -> bool;
+   auto Sample(const Vec3&) const noexcept -> Vec3;
+   void Sample(const Real* x, const Real* y, const Real* z, Count,
+               Real* outX, Real* outY, Real* outZ) const noexcept;
+
+   auto GetOrigin() const noexcept -> const Vec3&;
+   auto GetSize() const noexcept -> const Vec3&;
+   auto GetDepth() const noexcept -> Count;
+   auto GetCellSize(Count level) const noexcept -> Vec3;
+   auto GetLeafCount() const -> Count;
+   auto GetRecomputedCount() const noexcept -> Count;
+   auto GetReusedCount() const noexcept -> Count;
+   auto GetTree() const noexcept -> const Tree&;
+};
+
+#include "FieldTree.inl"
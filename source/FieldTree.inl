@@ -0,0 +1,351 @@
+///                                                                           
+/// Langulus::Module::Physics                                                 
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include "FieldTree.hpp"
+
+
+namespace Euclidean
+{
+
+   /// Change the volume covered by the field, discarding all blocks          
+   ///   @param origin - the lowest corner of the volume                      
+   ///   @param size - the size of the volume along each axis                 
+   inline void FieldTree::SetVolume(const Vec3& origin, const Vec3& size) {
+      LANGULUS_ASSUME(UserAssumes, size.x > 0 and size.y > 0 and size.z > 0,
+         "Degenerate field volume");
+      if (origin.x == mOrigin.x and origin.y == mOrigin.y and origin.z == mOrigin.z
+      and size.x == mSize.x and size.y == mSize.y and size.z == mSize.z)
+         return;
+
+      mOrigin = origin;
+      mSize = size;
+      mTree.clear();
+      mStale = true;
+   }
+
+   /// Change the maximum level of refinement - the finest cells are          
+   /// 2^depth times smaller than the root's. Deeper blocks are coarsened on  
+   /// the next adaptation                                                    
+   ///   @param depth - the new depth                                         
+   inline void FieldTree::SetDepth(Count depth) noexcept {
+      mDepth = depth;
+   }
+
+   /// Refine blocks that contain any of the given points, up to the maximum  
+   /// depth, and coarsen blocks that contain none. Refined blocks get their  
+   /// parents' values, and should be filled again                            
+   ///   @param x, y, z - the coordinates of each point                       
+   ///   @param count - the number of points                                  
+   ///   @return true if any block was refined or coarsened                   
+   inline bool FieldTree::Adapt(const Real* x, const Real* y, const Real* z, Count count) {
+      // The tree changes by a single level on each pass                
+      bool changed = false;
+      for (Count pass = 0; pass <= mDepth; ++pass) {
+         mTree.forEachLeaf([](Node& node) {
+            node.action = AMR::Action::Coarsen;
+         });
+
+         Vec3 cell;
+         for (Offset i = 0; i < count; ++i) {
+            const Vec3 at {x[i], y[i], z[i]};
+            if (not Contains(at))
+               continue;
+
+            const auto leaf = Locate(at, cell);
+            leaf->action = leaf->level < mDepth ? AMR::Action::Refine
+               : leaf->level == mDepth ? AMR::Action::None : AMR::Action::Coarsen;
+         }
+
+         if (not mTree.restructure())
+            break;
+         changed = true;
+      }
+
+      mStale |= changed;
+      return changed;
+   }
+
+   /// Set the value of every leaf cell, and bring coarser blocks and all     
+   /// halos up to date                                                       
+   ///   @param valueAt - invoked with the centre of each cell, returns the   
+   ///      value of the cell                                                 
+   template<class F>
+   void FieldTree::Fill(F&& valueAt) {
+      Invalidate();
+      Refill(std::forward<F>(valueAt));
+   }
+
+   /// Set the value of the cells of stale leaves only, and bring coarser     
+   /// blocks and all halos up to date, if any leaf was recomputed            
+   ///   @param valueAt - invoked with the centre of each cell, returns the   
+   ///      value of the cell                                                 
+   ///   @return the number of recomputed leaves                              
+   template<class F>
+   auto FieldTree::Refill(F&& valueAt) -> Count {
+      // Nothing was invalidated or adapted since the last refill, so   
+      // the tree is the same, and every leaf is reused                 
+      if (not mStale) {
+         mReused += mRecomputed;
+         mRecomputed = 0;
+         return 0;
+      }
+
+      mStale = false;
+      mRecomputed = mReused = 0;
+      mTree.forEachLeaf([&](Node& node) {
+         if (not node.stale) {
+            ++mReused;
+            return;
+         }
+
+         node.stale = false;
+         ++mRecomputed;
+         const auto cell = GetCellSize(node.level);
+         const Vec3 first {
+            mOrigin.x + (Real(node.position[0]) + Real(0.5)) * cell.x,
+            mOrigin.y + (Real(node.position[1]) + Real(0.5)) * cell.y,
+            mOrigin.z + (Real(node.position[2]) + Real(0.5)) * cell.z
+         };
+
+         auto& [x, y, z] = node.data;
+         AMR::Loop<3>(Config::Halo, BlockSize + Config::Halo, [&](const auto& it) {
+            const Vec3 value = valueAt(Vec3 {
+               first.x + Real(it[0] - Config::Halo) * cell.x,
+               first.y + Real(it[1] - Config::Halo) * cell.y,
+               first.z + Real(it[2] - Config::Halo) * cell.z
+            });
+            x[it] = value.x;
+            y[it] = value.y;
+            z[it] = value.z;
+         });
+      });
+
+      if (mRecomputed)
+         mTree.synchronize();
+      return mRecomputed;
+   }
+
+   /// Mark all leaves as stale, so they're recomputed on the next refill     
+   inline void FieldTree::Invalidate() {
+      mTree.forEachLeaf([](Node& node) {
+         node.stale = true;
+      });
+      mStale = true;
+   }
+
+   /// Mark leaves that overlap a box as stale, so they're recomputed on the  
+   /// next refill                                                            
+   ///   @param min, max - the corners of the box                             
+   inline void FieldTree::Invalidate(const Vec3& min, const Vec3& max) {
+      mTree.forEachLeaf([&](Node& node) {
+         const auto cell = GetCellSize(node.level);
+         for (int a = 0; a < 3; ++a) {
+            const Real first = mOrigin[a] + Real(node.position[a]) * cell[a];
+            if (max[a] < first or min[a] > first + Real(BlockSize) * cell[a])
+               return;
+         }
+         node.stale = true;
+         mStale = true;
+      });
+   }
+
+   /// Find the leaf that contains a point inside the volume                  
+   ///   @param at - the point                                                
+   ///   @param cell - [out] the point, in cells of the leaf, relative to its 
+   ///      first inner cell                                                  
+   ///   @return the leaf                                                     
+   inline auto FieldTree::Locate(const Vec3& at, Vec3& cell) const noexcept -> Node* {
+      constexpr auto S = Real(BlockSize);
+      cell = Vec3 {
+         (at.x - mOrigin.x) * S / mSize.x,
+         (at.y - mOrigin.y) * S / mSize.y,
+         (at.z - mOrigin.z) * S / mSize.z
+      };
+
+      // Each child covers half of its parent, which is a whole block   
+      // of the child's cells                                           
+      auto node = mTree.root;
+      while (not node->isLeaf) {
+         typename Node::Vu64 index;
+         for (int i = 0; i < 3; ++i) {
+            cell[i] *= 2;
+            index[i] = cell[i] >= S;
+            cell[i] -= index[i] ? S : 0;
+         }
+         node = node->children[index];
+      }
+      return node;
+   }
+
+   /// Check if a point is inside the field's volume                          
+   ///   @param at - the point                                                
+   ///   @return true if the point is inside, including the boundary          
+   inline bool FieldTree::Contains(const Vec3& at) const noexcept {
+      return at.x >= mOrigin.x and at.x <= mOrigin.x + mSize.x
+         and at.y >= mOrigin.y and at.y <= mOrigin.y + mSize.y
+         and at.z >= mOrigin.z and at.z <= mOrigin.z + mSize.z;
+   }
+
+   /// Check if adapting around a point would refine the tree - i.e. the      
+   /// point is inside the volume, but not in a leaf of the maximum depth     
+   ///   @param at - the point                                                
+   ///   @return true if the leaf around the point isn't fine enough          
+   inline bool FieldTree::NeedsRefinement(const Vec3& at) const noexcept {
+      if (not Contains(at))
+         return false;
+
+      Vec3 cell;
+      return Locate(at, cell)->level != mDepth;
+   }
+
+   /// Interpolate the field at a point, from the finest cells around it      
+   ///   @param at - the point                                                
+   ///   @return the interpolated value, or zero outside the volume           
+   inline auto FieldTree::Sample(const Vec3& at) const noexcept -> Vec3 {
+      if (not Contains(at))
+         return {};
+
+      Vec3 cell;
+      return Interpolate(*Locate(at, cell), cell);
+   }
+
+   /// Interpolate the field at many points. Consecutive points that fall in  
+   /// the same leaf don't descend the tree again, so sorting the points      
+   /// along a Z-order curve over the volume first (see Morton) turns this    
+   /// into a single descent per block                                        
+   ///   @param x, y, z - the coordinates of each point                       
+   ///   @param count - the number of points                                  
+   ///   @param outX, outY, outZ - [out] the interpolated value at each       
+   ///      point, or zero outside the volume                                 
+   inline void FieldTree::Sample(
+      const Real* x, const Real* y, const Real* z, Count count,
+      Real* outX, Real* outY, Real* outZ
+   ) const noexcept {
+      constexpr auto S = Real(BlockSize);
+      const Node* leaf = nullptr;
+      Vec3 first, cellSize;
+      Vec3 cell;
+
+      for (Offset i = 0; i < count; ++i) {
+         const Vec3 at {x[i], y[i], z[i]};
+         if (not Contains(at)) {
+            outX[i] = outY[i] = outZ[i] = 0;
+            continue;
+         }
+
+         bool inside = leaf != nullptr;
+         for (int a = 0; a < 3 and inside; ++a) {
+            cell[a] = (at[a] - first[a]) / cellSize[a];
+            inside = cell[a] >= 0 and cell[a] < S;
+         }
+
+         if (not inside) {
+            leaf = Locate(at, cell);
+            cellSize = GetCellSize(leaf->level);
+            for (int a = 0; a < 3; ++a)
+               first[a] = mOrigin[a] + Real(leaf->position[a]) * cellSize[a];
+         }
+
+         const auto value = Interpolate(*leaf, cell);
+         outX[i] = value.x;
+         outY[i] = value.y;
+         outZ[i] = value.z;
+      }
+   }
+
+   /// Interpolate inside a single leaf                                       
+   ///   @param leaf - the leaf                                               
+   ///   @param cell - the point, in cells of the leaf, relative to its first 
+   ///      inner cell                                                        
+   ///   @return the interpolated value                                       
+   inline auto FieldTree::Interpolate(const Node& leaf, const Vec3& cell) noexcept -> Vec3 {
+      // Cell centres are half a cell in, and the halo is before the    
+      // first inner cell, so the cells around a point are always inside
+      // the block, including its halo                                  
+      typename Node::Vu64 low;
+      Real t[3];
+      for (int i = 0; i < 3; ++i) {
+         const Real c = std::clamp(cell[i] + Real(0.5), Real(0), Real(BlockSize + 1));
+         low[i] = std::min(static_cast<AMR::u64>(c), static_cast<AMR::u64>(BlockSize));
+         t[i] = c - Real(low[i]);
+      }
+
+      // All grids of a block have the same layout                      
+      const auto& [gx, gy, gz] = leaf.data;
+      const auto base = gx.indexOf(low);
+      const auto dy = gx.getStride(1);
+      const auto dz = gx.getStride(2);
+      const auto lerp = [&](const Real* v) {
+         const Real* p = v + base;
+         const Real x00 = p[0]       + (p[1]           - p[0])       * t[0];
+         const Real x10 = p[dy]      + (p[dy + 1]      - p[dy])      * t[0];
+         const Real x01 = p[dz]      + (p[dz + 1]      - p[dz])      * t[0];
+         const Real x11 = p[dy + dz] + (p[dy + dz + 1] - p[dy + dz]) * t[0];
+         const Real y0 = x00 + (x10 - x00) * t[1];
+         const Real y1 = x01 + (x11 - x01) * t[1];
+         return y0 + (y1 - y0) * t[2];
+      };
+
+      return {lerp(gx.data()), lerp(gy.data()), lerp(gz.data())};
+   }
+
+   /// Get the lowest corner of the volume                                    
+   ///   @return the origin                                                   
+   inline auto FieldTree::GetOrigin() const noexcept -> const Vec3& {
+      return mOrigin;
+   }
+
+   /// Get the size of the volume along each axis                             
+   ///   @return the size                                                     
+   inline auto FieldTree::GetSize() const noexcept -> const Vec3& {
+      return mSize;
+   }
+
+   /// Get the maximum level of refinement                                    
+   ///   @return the depth                                                    
+   inline Count FieldTree::GetDepth() const noexcept {
+      return mDepth;
+   }
+
+   /// Get the size of the cells of a level                                   
+   ///   @param level - the level, zero for the root                          
+   ///   @return the size of a cell along each axis                           
+   inline auto FieldTree::GetCellSize(Count level) const noexcept -> Vec3 {
+      const Real cells = Real(BlockSize) * Real(AMR::u64 {1} << level);
+      return {mSize.x / cells, mSize.y / cells, mSize.z / cells};
+   }
+
+   /// Count the blocks that hold the finest values                           
+   ///   @return the number of leaves                                         
+   inline Count FieldTree::GetLeafCount() const {
+      Count leaves = 0;
+      mTree.forEachLeaf([&](const Node&) {
+         ++leaves;
+      });
+      return leaves;
+   }
+
+   /// Count the leaves that were recomputed on the last refill               
+   ///   @return the number of recomputed leaves                              
+   inline Count FieldTree::GetRecomputedCount() const noexcept {
+      return mRecomputed;
+   }
+
+   /// Count the leaves that were still up to date on the last refill         
+   ///   @return the number of reused leaves                                  
+   inline Count FieldTree::GetReusedCount() const noexcept {
+      return mReused;
+   }
+
+   /// Get the underlying tree, i.e. to run kernels on its blocks             
+   ///   @return the tree                                                     
+   inline auto FieldTree::GetTree() const noexcept -> const Tree& {
+      return mTree;
+   }
+
+} // namespace Euclidean
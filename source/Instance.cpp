@@ -8,6 +8,7 @@
 #include "Instance.hpp"
 #include "Physics.hpp"
 #include <Langulus/Mesh.hpp>
+#include <thread>
 
 using namespace Euclidean;
 
@@ -32,46 +33,39 @@ Instance::Instance(World* producer, const Many& descriptor)
    SeekValueAux<Traits::Static      >(descriptor, mData.mStatic      );
    SeekValueAux(descriptor, mColor);
    mData.mAim.w = 1;
+
+   // Register the dynamic state in the world's pool                    
+   mSlot = producer->Register(this, mData);
    VERBOSE_PHYSICS("Initialized");
 }
 
-/// Update the instance                                                       
-///   @param dt - time between updates, in seconds                            
-void Instance::Update(Real dt) {
-   // Apply one-time impulse                                            
-   mData.mImpulse +=
-      (mData.mUseImpulse * mData.mUseBoundness) +
-      (mData.mSimImpulse * mData.mSimBoundness);
-   mData.mUseImpulse = 0;
-   mData.mSimImpulse = 0;
-
-   mData.mPosition += mData.mImpulse * dt;
-   mData.mImpulse = 0;
-
-   // Change velocity and apply it                                      
-   mData.mVelocity +=
-      (mData.mUseVelocity * mData.mUseBoundness) +
-      (mData.mSimVelocity * mData.mSimBoundness);
-   mData.mUseVelocity = 0;
-   mData.mSimVelocity = 0;
-
-   mData.mPosition = mData.GetPositionNext(dt);
-   mData.mVelocity = mData.GetVelocityNext(dt);
-
-   // Change level                                                      
-   mData.mLevel +=
-      (mData.mUseLevelChange * Level(dt * mData.mUseBoundness)) +
-      (mData.mSimLevelChange * Level(dt * mData.mSimBoundness));
-   mData.mSimLevelChange = 0;
-   mData.mUseLevelChange = 0;
+/// Instance destruction                                                      
+Instance::~Instance() {
+   ReleaseSlot();
 }
 
 /// First stage destruction                                                   
 void Instance::Teardown() {
+   ReleaseSlot();
    mDomain.Reset();
    mData.mParent.Reset();
 }
 
+/// Give the dynamic state slot back to the world's pool                      
+void Instance::ReleaseSlot() noexcept {
+   if (mSlot == InstancePool::InvalidSlot)
+      return;
+
+   GetProducer()->Unregister(mSlot);
+   mSlot = InstancePool::InvalidSlot;
+}
+
+/// Get the world's instance pool, where the dynamic state resides            
+///   @return the pool                                                        
+InstancePool& Instance::GetPool() const noexcept {
+   return GetProducer()->GetPool();
+}
+
 /// Refresh the instance's properties on environment change                   
 void Instance::Refresh() {
    mDomain = SeekUnit<A::Mesh>();
@@ -80,7 +74,17 @@ void Instance::Refresh() {
 /// Move, rotate, resize verb                                                 
 ///   @param verb - the move verb                                             
 void Instance::Move(Verb& verb) {
+   GetPool().Store(mSlot, mData);
    mData.Move(verb);
+
+   // Renderers only hold the lock for a single transform               
+   std::atomic_ref lock {mCacheLock};
+   while (lock.exchange(1, std::memory_order_acquire))
+      std::this_thread::yield();
+   ++mRevision;
+   lock.store(0, std::memory_order_release);
+
+   GetProducer()->Reload(mSlot, mData);
 }
 
 /// Cull the instance, based on lod state                                     
@@ -88,11 +92,11 @@ void Instance::Move(Verb& verb) {
 ///   @return true if instance is culled (doesn't intersect frusta)           
 bool Instance::Cull(const LOD& state) const noexcept {
    // Quick octave-based cull                                           
-   if (state.mLevel >= mData.mLevel + 1) {
+   if (state.mLevel >= GetLevel() + 1) {
       // We're looking at the instance from a higher octave             
       // Discard - the thing is likely too small to be seen             
-      // Small things will be batched as points/volumes and drawn       
-      // separately. This is not the place for them                     
+      // Small things are batched as points/volumes by the world, and   
+      // drawn separately - see World::GetAggregates                    
       return true;
    }
 
@@ -102,30 +106,101 @@ bool Instance::Cull(const LOD& state) const noexcept {
       return false;
    }
 
-   const auto box = mData.GetRangeRotated(state.mLevel);
+   const auto box = GetState().GetRangeRotated(state.mLevel);
    return not state.mFrustum.Intersects(box);
 }
 
 Level Instance::GetLevel() const noexcept {
-   return mData.mLevel;
+   return GetPool().mLevel[mSlot];
 }
 
 Mat4 Instance::GetModelTransform(const LOD& lod) const noexcept {
-   return mData.GetModelTransform(lod.mLevel);
+   return GetCached(mModelCache, lod.mLevel, false);
 }
 
 Mat4 Instance::GetModelTransform(const Level& level) const noexcept {
-   return mData.GetModelTransform(level);
+   return GetCached(mModelCache, level, false);
 }
 
 Mat4 Instance::GetViewTransform(const LOD& lod) const noexcept {
-   return mData.GetViewTransform(lod.mLevel);
+   return GetCached(mViewCache, lod.mLevel, true);
 }
 
 Mat4 Instance::GetViewTransform(const Level& level) const noexcept {
-   return mData.GetViewTransform(level);
+   return GetCached(mViewCache, level, true);
+}
+
+/// Get a transform from the cache, composing it only if position, level,     
+/// scale or aim changed since it was last composed for the same level.       
+/// If another thread is using the cache, the transform is composed without   
+/// it, instead of waiting                                                    
+///   @param cache - the cache to search                                      
+///   @param level - the level to get the transform for                       
+///   @param view - whether to compose a view or a model transform            
+///   @return the transform                                                   
+Mat4 Instance::GetCached(TransformCache& cache, const Level& level, bool view) const noexcept {
+   const auto& pool = GetPool();
+   const auto position = pool.GetInterpolated(mSlot,
+      GetProducer()->GetInterpolation());
+   const auto ownLevel = pool.mLevel[mSlot];
+   const auto compose = [&] {
+      const auto state = GetRenderState();
+      return view ? state.GetViewTransform(level) : state.GetModelTransform(level);
+   };
+
+   std::atomic_ref lock {mCacheLock};
+   if (lock.exchange(1, std::memory_order_acquire))
+      return compose();
+
+   bool hit = false;
+   for (auto& entry : cache) {
+      if (entry.mRevision != mRevision or entry.mLevel != level
+      or entry.mOwnLevel != ownLevel or entry.mPosition != position)
+         continue;
+
+      // Keep the most recently used entry first                        
+      if (&entry != &cache[0])
+         std::swap(entry, cache[0]);
+      hit = true;
+      break;
+   }
+
+   if (not hit) {
+      // Miss - evict the least recently used entry                     
+      cache[1] = cache[0];
+      cache[0] = {level, ownLevel, position, mRevision, compose()};
+   }
+
+   const auto result = cache[0].mMatrix;
+   lock.store(0, std::memory_order_release);
+   return result;
 }
 
 auto Instance::GetColor() const noexcept -> RGBA {
    return *mColor;
 }
+
+/// Get the index of the instance's dynamic state in the world's pool         
+///   @return the slot index                                                  
+Offset Instance::GetSlot() const noexcept {
+   return mSlot;
+}
+
+/// Get the full instance data, combined with the dynamic state from the      
+/// world's pool                                                              
+///   @return a copy of the instance data                                     
+auto Instance::GetState() const noexcept -> Math::TInstance<Vec3> {
+   auto state = mData;
+   GetPool().Store(mSlot, state);
+   return state;
+}
+
+/// Get the full instance data, with the position interpolated between the    
+/// last two steps of the world, when it advances with a fixed time step      
+///   @return a copy of the instance data, as it should be rendered           
+auto Instance::GetRenderState() const noexcept -> Math::TInstance<Vec3> {
+   auto state = GetState();
+   state.mPosition = GetPool().GetInterpolated(mSlot,
+      GetProducer()->GetInterpolation());
+   return state;
+}
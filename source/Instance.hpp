@@ -6,11 +6,12 @@
 /// SPDX-License-Identifier: GPL-3.0-or-later                                 
 ///                                                                           
 #pragma once
-#include "Common.hpp"
+#include "InstancePool.hpp"
 #include <Langulus/Flow/Factory.hpp>
 #include <Langulus/Math/Instance.hpp>
 #include <Langulus/Mesh.hpp>
 #include <Langulus/Math/Color.hpp>
+#include <atomic>
 
 
 ///                                                                           
@@ -24,20 +25,54 @@ struct Euclidean::Instance : A::Instance, ProducedFrom<World> {
    LANGULUS_BASES(A::Instance);
    LANGULUS_VERBS(Verbs::Move);
 
+   /// A composed transform, along with everything it was composed from       
+   struct CachedTransform {
+      // The level the transform was requested for                      
+      Level mLevel;
+      // The instance's own level and rendered position at the time     
+      Level mOwnLevel;
+      Vec3 mPosition;
+      // The instance revision at the time - zero means an empty entry  
+      uint32_t mRevision = 0;
+      Mat4 mMatrix;
+   };
+
+   /// Most recently used transforms, most recent first                       
+   using TransformCache = CachedTransform[2];
+
 private:
+   friend struct World;
+
    // Collision domain                                                  
    Pin<Ref<A::Mesh>> mDomain;
-   // Instance data                                                     
+   // Instance data - the dynamic state (position, velocity, level...)  
+   // is authoritative inside the world's instance pool, and is only    
+   // copied here when the whole state is required                      
    Math::TInstance<Vec3> mData;
+   // Index of the dynamic state inside the world's instance pool       
+   Offset mSlot = InstancePool::InvalidSlot;
    // Instance color                                                    
    RTTI::Tag<Pin<RGBA>, Traits::Color> mColor = Colors::White;
 
+   // Incremented whenever scale or aim might have changed. Only read   
+   // and written while holding mCacheLock                              
+   uint32_t mRevision = 1;
+   // Transforms are cached for the last couple of levels they were     
+   // requested for, because renderers ask for them many times a frame. 
+   // Renderers may ask from several threads at once, so only the thread
+   // that holds the lock uses the caches, and the others compose their 
+   // transforms without them                                           
+   alignas(std::atomic_ref<uint32_t>::required_alignment)
+   mutable uint32_t mCacheLock = 0;
+   mutable TransformCache mModelCache;
+   mutable TransformCache mViewCache;
+
 public:
    Instance(World*, const Many&);
+   ~Instance();
 
    void Move(Verb&);
 
-   void Update(Real);
    void Refresh() override;
    void Teardown();
    auto Cull(const LOD&) const noexcept -> bool override;
@@ -47,4 +82,13 @@ public:
    auto GetViewTransform(const LOD&) const noexcept -> Mat4 override;
    auto GetViewTransform(const Level& = {}) const noexcept -> Mat4 override;
    auto GetColor() const noexcept -> RGBA override;
+
+   auto GetSlot() const noexcept -> Offset;
+   auto GetState() const noexcept -> Math::TInstance<Vec3>;
+   auto GetRenderState() const noexcept -> Math::TInstance<Vec3>;
+
+private:
+   auto GetPool() const noexcept -> InstancePool&;
+   auto GetCached(TransformCache&, const Level&, bool view) const noexcept -> Mat4;
+   void ReleaseSlot() noexcept;
 };
\ No newline at end of file
@@ -0,0 +1,104 @@
+///                                                                           
+/// Langulus::Module::Physics                                                 
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include "Culling.hpp"
+#include "Broadphase.hpp"
+#include <Langulus/Math/Instance.hpp>
+#include <vector>
+
+
+///                                                                           
+///   Instance state pool                                                     
+///                                                                           
+/// Contiguous structure-of-arrays storage for the dynamic state of all       
+/// instances inside a world. Each instance only keeps a slot index into it,  
+/// so that the per-frame integration streams linearly through memory,        
+/// instead of chasing every instance's reflected data                        
+///                                                                           
+struct Euclidean::InstancePool {
+   /// Marks an instance that isn't registered in a pool                      
+   static constexpr Offset InvalidSlot = static_cast<Offset>(-1);
+
+   /// Each component of a vector lives in its own array, so that kernels     
+   /// can process consecutive instances in a single instruction              
+   struct Lanes3 {
+      std::vector<Real> mX, mY, mZ;
+
+      auto Get(Offset) const noexcept -> Vec3;
+      void Set(Offset, const Vec3&) noexcept;
+      void Push(const Vec3&);
+      void Pop() noexcept;
+      void Move(Offset to, Offset from) noexcept;
+      void Swap(Offset, Offset) noexcept;
+      void Reserve(Count);
+   };
+
+   // Owner of each slot, used to patch slot indices on removal         
+   std::vector<Instance*> mOwners;
+
+   // Integrated state                                                  
+   Lanes3 mPosition;
+   // Position before the last fixed step, for interpolating transforms 
+   Lanes3 mPrevious;
+   Lanes3 mVelocity;
+   Lanes3 mAcceleration;
+   Lanes3 mImpulse;
+   std::vector<Level> mLevel;
+
+   // Accumulated inputs, consumed on each integration step             
+   Lanes3 mUseVelocity;
+   Lanes3 mSimVelocity;
+   Lanes3 mUseImpulse;
+   Lanes3 mSimImpulse;
+   std::vector<Level> mUseLevelChange;
+   std::vector<Level> mSimLevelChange;
+
+   // How strongly user and simulation inputs affect each slot          
+   std::vector<Real> mUseBoundness;
+   std::vector<Real> mSimBoundness;
+
+   // Half the size of the rotated range around the position, used as   
+   // collision bounds in the world's default octave                    
+   Lanes3 mExtent;
+   // Whether the slot takes part in collisions                         
+   std::vector<uint8_t> mSolid;
+   // Whether the slot has degenerate scale, and is never culled        
+   std::vector<uint8_t> mUnbounded;
+   // Proxy of each solid slot inside the world's broadphase            
+   std::vector<Broadphase::Proxy> mProxy;
+
+   // Whether the slot never moves on its own, and is always asleep     
+   std::vector<uint8_t> mStatic;
+   // Number of consecutive updates the slot has been resting for       
+   std::vector<uint32_t> mRest;
+   // Slots are partitioned - the first mActiveCount slots are awake    
+   // and get integrated, the rest are sleeping                         
+   Count mActiveCount = 0;
+
+   auto Allocate(Instance*) -> Offset;
+   void Release(Offset) noexcept;
+   void Swap(Offset, Offset) noexcept;
+   void Reserve(Count);
+   void Clear() noexcept;
+
+   void Load(Offset, const Math::TInstance<Vec3>&) noexcept;
+   void Store(Offset, Math::TInstance<Vec3>&) const noexcept;
+   auto GetBox(Offset) const noexcept -> Broadphase::Box;
+   auto GetBounds() const noexcept -> Culling::Bounds;
+   auto IsResting(Offset, Real speed) const noexcept -> bool;
+   auto GetInterpolated(Offset, Real alpha) const noexcept -> Vec3;
+   void SavePrevious(Offset from, Offset to) noexcept;
+
+   void Integrate(Real dt, Integrator::ISA = {}) noexcept;
+   void Integrate(Offset from, Offset to, Real dt, Integrator::ISA = {}) noexcept;
+
+   auto GetCount() const noexcept -> Count;
+   auto GetActiveCount() const noexcept -> Count;
+};
+
+#include "InstancePool.inl"
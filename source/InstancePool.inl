@@ -0,0 +1,385 @@
+///                                                                           
+/// Langulus::Module::Physics                                                 
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include "InstancePool.hpp"
+#include <algorithm>
+
+
+namespace Euclidean
+{
+
+   /// Gather a vector from the lanes                                         
+   ///   @param i - the slot index                                            
+   ///   @return the vector                                                   
+   inline Vec3 InstancePool::Lanes3::Get(Offset i) const noexcept {
+      return {mX[i], mY[i], mZ[i]};
+   }
+
+   /// Scatter a vector to the lanes                                          
+   ///   @param i - the slot index                                            
+   ///   @param v - the vector to write                                       
+   inline void InstancePool::Lanes3::Set(Offset i, const Vec3& v) noexcept {
+      mX[i] = v.x;
+      mY[i] = v.y;
+      mZ[i] = v.z;
+   }
+
+   /// Append a vector to the end of the lanes                                
+   ///   @param v - the vector to append                                      
+   inline void InstancePool::Lanes3::Push(const Vec3& v) {
+      mX.push_back(v.x);
+      mY.push_back(v.y);
+      mZ.push_back(v.z);
+   }
+
+   /// Remove the last vector in the lanes                                    
+   inline void InstancePool::Lanes3::Pop() noexcept {
+      mX.pop_back();
+      mY.pop_back();
+      mZ.pop_back();
+   }
+
+   /// Overwrite one slot with another                                        
+   ///   @param to - the slot to overwrite                                    
+   ///   @param from - the slot to copy                                       
+   inline void InstancePool::Lanes3::Move(Offset to, Offset from) noexcept {
+      mX[to] = mX[from];
+      mY[to] = mY[from];
+      mZ[to] = mZ[from];
+   }
+
+   /// Exchange two slots                                                     
+   ///   @param a - the first slot                                            
+   ///   @param b - the second slot                                           
+   inline void InstancePool::Lanes3::Swap(Offset a, Offset b) noexcept {
+      std::swap(mX[a], mX[b]);
+      std::swap(mY[a], mY[b]);
+      std::swap(mZ[a], mZ[b]);
+   }
+
+   /// Reserve memory in all lanes                                            
+   ///   @param count - number of slots to reserve                            
+   inline void InstancePool::Lanes3::Reserve(Count count) {
+      mX.reserve(count);
+      mY.reserve(count);
+      mZ.reserve(count);
+   }
+
+   /// Register an instance in the pool                                       
+   ///   @param owner - the instance that will own the slot                   
+   ///   @return the slot index; state is zeroed until Load is called         
+   inline Offset InstancePool::Allocate(Instance* owner) {
+      LANGULUS_ASSUME(DevAssumes, owner, "Invalid owner");
+      mOwners.push_back(owner);
+      mPosition.Push({});
+      mPrevious.Push({});
+      mVelocity.Push({});
+      mAcceleration.Push({});
+      mImpulse.Push({});
+      mLevel.push_back({});
+      mUseVelocity.Push({});
+      mSimVelocity.Push({});
+      mUseImpulse.Push({});
+      mSimImpulse.Push({});
+      mUseLevelChange.push_back({});
+      mSimLevelChange.push_back({});
+      mUseBoundness.push_back(1);
+      mSimBoundness.push_back(1);
+      mExtent.Push({});
+      mSolid.push_back(0);
+      mUnbounded.push_back(0);
+      mProxy.push_back(Broadphase::InvalidProxy);
+      mStatic.push_back(0);
+      mRest.push_back(0);
+      return mOwners.size() - 1;
+   }
+
+   /// Unregister an instance from the pool                                   
+   /// The last slot is moved in place of the removed one to keep the arrays  
+   /// dense - the caller tells its owner about the new index                 
+   ///   @param slot - the slot to release                                    
+   inline void InstancePool::Release(Offset slot) noexcept {
+      LANGULUS_ASSUME(DevAssumes, slot < GetCount(), "Slot out of range");
+      const Offset last = GetCount() - 1;
+      if (slot != last) {
+         mOwners[slot] = mOwners[last];
+         mPosition.Move(slot, last);
+         mPrevious.Move(slot, last);
+         mVelocity.Move(slot, last);
+         mAcceleration.Move(slot, last);
+         mImpulse.Move(slot, last);
+         mLevel[slot] = mLevel[last];
+         mUseVelocity.Move(slot, last);
+         mSimVelocity.Move(slot, last);
+         mUseImpulse.Move(slot, last);
+         mSimImpulse.Move(slot, last);
+         mUseLevelChange[slot] = mUseLevelChange[last];
+         mSimLevelChange[slot] = mSimLevelChange[last];
+         mUseBoundness[slot] = mUseBoundness[last];
+         mSimBoundness[slot] = mSimBoundness[last];
+         mExtent.Move(slot, last);
+         mSolid[slot] = mSolid[last];
+         mUnbounded[slot] = mUnbounded[last];
+         mProxy[slot] = mProxy[last];
+         mStatic[slot] = mStatic[last];
+         mRest[slot] = mRest[last];
+      }
+
+      mOwners.pop_back();
+      mPosition.Pop();
+      mPrevious.Pop();
+      mVelocity.Pop();
+      mAcceleration.Pop();
+      mImpulse.Pop();
+      mLevel.pop_back();
+      mUseVelocity.Pop();
+      mSimVelocity.Pop();
+      mUseImpulse.Pop();
+      mSimImpulse.Pop();
+      mUseLevelChange.pop_back();
+      mSimLevelChange.pop_back();
+      mUseBoundness.pop_back();
+      mSimBoundness.pop_back();
+      mExtent.Pop();
+      mSolid.pop_back();
+      mUnbounded.pop_back();
+      mProxy.pop_back();
+      mStatic.pop_back();
+      mRest.pop_back();
+      mActiveCount = std::min(mActiveCount, GetCount());
+   }
+
+   /// Exchange two slots - the caller tells both owners about their new      
+   /// indices. Used to move slots between the active and the sleeping        
+   /// partitions                                                             
+   ///   @param a - the first slot                                            
+   ///   @param b - the second slot                                           
+   inline void InstancePool::Swap(Offset a, Offset b) noexcept {
+      LANGULUS_ASSUME(DevAssumes, a < GetCount() and b < GetCount(),
+         "Slot out of range");
+      if (a == b)
+         return;
+
+      std::swap(mOwners[a], mOwners[b]);
+      mPosition.Swap(a, b);
+      mPrevious.Swap(a, b);
+      mVelocity.Swap(a, b);
+      mAcceleration.Swap(a, b);
+      mImpulse.Swap(a, b);
+      std::swap(mLevel[a], mLevel[b]);
+      mUseVelocity.Swap(a, b);
+      mSimVelocity.Swap(a, b);
+      mUseImpulse.Swap(a, b);
+      mSimImpulse.Swap(a, b);
+      std::swap(mUseLevelChange[a], mUseLevelChange[b]);
+      std::swap(mSimLevelChange[a], mSimLevelChange[b]);
+      std::swap(mUseBoundness[a], mUseBoundness[b]);
+      std::swap(mSimBoundness[a], mSimBoundness[b]);
+      mExtent.Swap(a, b);
+      std::swap(mSolid[a], mSolid[b]);
+      std::swap(mUnbounded[a], mUnbounded[b]);
+      std::swap(mProxy[a], mProxy[b]);
+      std::swap(mStatic[a], mStatic[b]);
+      std::swap(mRest[a], mRest[b]);
+   }
+
+   /// Reserve memory for a number of instances, to avoid reallocations       
+   ///   @param count - number of slots to reserve                            
+   inline void InstancePool::Reserve(Count count) {
+      mOwners.reserve(count);
+      mPosition.Reserve(count);
+      mPrevious.Reserve(count);
+      mVelocity.Reserve(count);
+      mAcceleration.Reserve(count);
+      mImpulse.Reserve(count);
+      mLevel.reserve(count);
+      mUseVelocity.Reserve(count);
+      mSimVelocity.Reserve(count);
+      mUseImpulse.Reserve(count);
+      mSimImpulse.Reserve(count);
+      mUseLevelChange.reserve(count);
+      mSimLevelChange.reserve(count);
+      mUseBoundness.reserve(count);
+      mSimBoundness.reserve(count);
+      mExtent.Reserve(count);
+      mSolid.reserve(count);
+      mUnbounded.reserve(count);
+      mProxy.reserve(count);
+      mStatic.reserve(count);
+      mRest.reserve(count);
+   }
+
+   /// Release all slots - the caller detaches their owners                   
+   inline void InstancePool::Clear() noexcept {
+      *this = {};
+   }
+
+   /// Copy the dynamic state of an instance inside a slot                    
+   ///   @param slot - the slot to write to                                   
+   ///   @param data - the instance data to read from                         
+   inline void InstancePool::Load(Offset slot, const Math::TInstance<Vec3>& data) noexcept {
+      // Don't interpolate across teleports, but keep interpolating when
+      // only velocities, impulses or anything else changed             
+      if (mPosition.Get(slot) != data.mPosition)
+         mPrevious.Set(slot, data.mPosition);
+      mPosition.Set(slot, data.mPosition);
+      mVelocity.Set(slot, data.mVelocity);
+      mAcceleration.Set(slot, data.mAcceleration);
+      mImpulse.Set(slot, data.mImpulse);
+      mLevel[slot] = data.mLevel;
+      mUseVelocity.Set(slot, data.mUseVelocity);
+      mSimVelocity.Set(slot, data.mSimVelocity);
+      mUseImpulse.Set(slot, data.mUseImpulse);
+      mSimImpulse.Set(slot, data.mSimImpulse);
+      mUseLevelChange[slot] = data.mUseLevelChange;
+      mSimLevelChange[slot] = data.mSimLevelChange;
+      mUseBoundness[slot] = data.mUseBoundness;
+      mSimBoundness[slot] = data.mSimBoundness;
+
+      // Bounds only change on scaling and rotation, so they're cached  
+      const auto range = data.GetRangeRotated(Level {});
+      mExtent.Set(slot, (range.mMax - range.mMin) * Real(0.5));
+      mSolid[slot] = data.mSolid;
+      mUnbounded[slot] = data.mScale.IsDegenerate();
+      mStatic[slot] = data.mStatic;
+   }
+
+   /// Copy the dynamic state of a slot inside an instance                    
+   ///   @param slot - the slot to read from                                  
+   ///   @param data - the instance data to overwrite                         
+   inline void InstancePool::Store(Offset slot, Math::TInstance<Vec3>& data) const noexcept {
+      data.mPosition = mPosition.Get(slot);
+      data.mVelocity = mVelocity.Get(slot);
+      data.mAcceleration = mAcceleration.Get(slot);
+      data.mImpulse = mImpulse.Get(slot);
+      data.mLevel = mLevel[slot];
+      data.mUseVelocity = mUseVelocity.Get(slot);
+      data.mSimVelocity = mSimVelocity.Get(slot);
+      data.mUseImpulse = mUseImpulse.Get(slot);
+      data.mSimImpulse = mSimImpulse.Get(slot);
+      data.mUseLevelChange = mUseLevelChange[slot];
+      data.mSimLevelChange = mSimLevelChange[slot];
+      data.mUseBoundness = mUseBoundness[slot];
+      data.mSimBoundness = mSimBoundness[slot];
+   }
+
+   /// Get the collision bounds of a slot, in the world's default octave      
+   ///   @param slot - the slot                                               
+   ///   @return the bounding box, around the current position                
+   inline auto InstancePool::GetBox(Offset slot) const noexcept -> Broadphase::Box {
+      const auto position = mPosition.Get(slot);
+      const auto extent = mExtent.Get(slot);
+      return {position - extent, position + extent};
+   }
+
+   /// Get the collision bounds of all slots, in the world's default octave, as
+   /// centers and half-sizes                                                 
+   ///   @return pointers to the lanes, valid until the pool changes          
+   inline auto InstancePool::GetBounds() const noexcept -> Culling::Bounds {
+      return {
+         mPosition.mX.data(), mPosition.mY.data(), mPosition.mZ.data(),
+         mExtent.mX.data(), mExtent.mY.data(), mExtent.mZ.data()
+      };
+   }
+
+   /// Check if a slot is at rest - slower than a speed, without acceleration,
+   /// and without any pending inputs that would move it                      
+   ///   @param slot - the slot                                               
+   ///   @param speed - the speed, under which a slot is considered resting   
+   ///   @return true if the slot can be put to sleep                         
+   inline bool InstancePool::IsResting(Offset slot, Real speed) const noexcept {
+      const auto v = mVelocity.Get(slot);
+      if (v.x * v.x + v.y * v.y + v.z * v.z > speed * speed)
+         return false;
+
+      const auto zero = [](const Lanes3& lanes, Offset i) {
+         return lanes.mX[i] == 0 and lanes.mY[i] == 0 and lanes.mZ[i] == 0;
+      };
+
+      return zero(mAcceleration, slot)
+         and zero(mUseVelocity, slot) and zero(mSimVelocity, slot)
+         and zero(mUseImpulse, slot)  and zero(mSimImpulse, slot)
+         and mUseLevelChange[slot] == Level {}
+         and mSimLevelChange[slot] == Level {};
+   }
+
+   /// Get the position of a slot between the last two fixed steps            
+   ///   @param slot - the slot                                               
+   ///   @param alpha - zero for the previous position, one for the current   
+   ///   @return the interpolated position                                    
+   inline auto InstancePool::GetInterpolated(Offset slot, Real alpha) const noexcept -> Vec3 {
+      // Variable steps always render the current position, which the   
+      // interpolation below doesn't always land on exactly             
+      if (alpha >= 1)
+         return mPosition.Get(slot);
+
+      const auto previous = mPrevious.Get(slot);
+      return previous + (mPosition.Get(slot) - previous) * alpha;
+   }
+
+   /// Remember the current positions of a range of slots, before stepping    
+   ///   @param from - first slot                                             
+   ///   @param to - the slot after the last one                              
+   inline void InstancePool::SavePrevious(Offset from, Offset to) noexcept {
+      LANGULUS_ASSUME(DevAssumes, from <= to and to <= GetCount(),
+         "Bad slot range");
+      for (auto c : {&Lanes3::mX, &Lanes3::mY, &Lanes3::mZ})
+         std::copy((mPosition.*c).begin() + from, (mPosition.*c).begin() + to,
+            (mPrevious.*c).begin() + from);
+   }
+
+   /// Integrate all active slots                                             
+   ///   @param dt - time between updates, in seconds                         
+   ///   @param isa - the instruction set to integrate with                   
+   inline void InstancePool::Integrate(Real dt, Integrator::ISA isa) noexcept {
+      Integrate(0, mActiveCount, dt, isa);
+   }
+
+   /// Integrate a range of slots                                             
+   ///   @param from - first slot                                             
+   ///   @param to - the slot after the last one                              
+   ///   @param dt - time between updates, in seconds                         
+   ///   @param isa - the instruction set to integrate with                   
+   inline void InstancePool::Integrate(Offset from, Offset to, Real dt, Integrator::ISA isa) noexcept {
+      LANGULUS_ASSUME(DevAssumes, from <= to and to <= GetCount(),
+         "Bad slot range");
+
+      for (auto c : {&Lanes3::mX, &Lanes3::mY, &Lanes3::mZ}) {
+         const Integrator::Lane lane {
+            (mPosition.*c).data(),    (mVelocity.*c).data(),
+            (mAcceleration.*c).data(), (mImpulse.*c).data(),
+            (mUseVelocity.*c).data(), (mSimVelocity.*c).data(),
+            (mUseImpulse.*c).data(),  (mSimImpulse.*c).data(),
+            mUseBoundness.data(), mSimBoundness.data()
+         };
+         Integrator::Integrate(isa, lane, from, to, dt);
+      }
+
+      // Change level                                                   
+      for (Offset i = from; i < to; ++i) {
+         mLevel[i] +=
+            (mUseLevelChange[i] * Level(dt * mUseBoundness[i])) +
+            (mSimLevelChange[i] * Level(dt * mSimBoundness[i]));
+         mSimLevelChange[i] = 0;
+         mUseLevelChange[i] = 0;
+      }
+   }
+
+   /// Get the number of registered instances                                 
+   ///   @return the number of slots in use                                   
+   inline Count InstancePool::GetCount() const noexcept {
+      return mOwners.size();
+   }
+
+   /// Get the number of instances that are awake                             
+   ///   @return the number of slots in the active partition                  
+   inline Count InstancePool::GetActiveCount() const noexcept {
+      return mActiveCount;
+   }
+
+} // namespace Euclidean
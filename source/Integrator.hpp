@@ -0,0 +1,58 @@
+///                                                                           
+/// Langulus::Module::Physics                                                 
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include "Common.hpp"
+
+
+///                                                                           
+///   Batched instance integration kernels                                    
+///                                                                           
+/// Integrate the dynamic state of many instances at once, by running over    
+/// the component arrays of an InstancePool. The instruction set is picked    
+/// at runtime. Every kernel performs the exact same operations in the same   
+/// order as the scalar one, so results are bit-identical across all of       
+/// them (as long as the compiler doesn't contract into FMA instructions)     
+///                                                                           
+namespace Euclidean::Integrator
+{
+
+   /// Supported instruction sets, ordered by width                           
+   enum class ISA : uint8_t {
+      Scalar,     // One slot at a time, works everywhere
+      SSE4,       // 128bit registers
+      AVX2,       // 256bit registers
+      AVX512,     // 512bit registers
+
+      Counter
+   };
+
+   /// Pointers to a single vector component of all arrays that take part     
+   /// in integration - the kernels run once per component                    
+   struct Lane {
+      Real*       mPosition;
+      Real*       mVelocity;
+      const Real* mAcceleration;
+      Real*       mImpulse;
+      Real*       mUseVelocity;
+      Real*       mSimVelocity;
+      Real*       mUseImpulse;
+      Real*       mSimImpulse;
+      const Real* mUseBoundness;
+      const Real* mSimBoundness;
+   };
+
+   auto IsSupported(ISA) noexcept -> bool;
+   auto GetBestISA() noexcept -> ISA;
+   auto GetName(ISA) noexcept -> const char*;
+   auto GetWidth(ISA) noexcept -> Count;
+
+   void Integrate(ISA, const Lane&, Offset from, Offset to, Real dt) noexcept;
+
+} // namespace Euclidean::Integrator
+
+#include "Integrator.inl"
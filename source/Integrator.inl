@@ -0,0 +1,224 @@
+///                                                                           
+/// Langulus::Module::Physics                                                 
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include "Integrator.hpp"
+#include <cstring>
+
+#if defined(__GNUC__) and (defined(__x86_64__) or defined(__i386__))
+   // Kernels are generated from generic vector extensions inside       
+   // functions that target a specific instruction set, and picked      
+   // at runtime, so the module itself can be built for any x86 CPU     
+   #define PHYSICS_SIMD_X86() 1
+   #define PHYSICS_TARGET(isa) __attribute__((target(isa)))
+#else
+   // No runtime dispatch available - only the scalar kernel is used    
+   #define PHYSICS_SIMD_X86() 0
+   #define PHYSICS_TARGET(isa)
+#endif
+
+
+namespace Euclidean::Integrator
+{
+   namespace Inner
+   {
+
+      /// Integrate a single slot                                             
+      ///   @param l - the component to integrate                             
+      ///   @param i - the slot index                                         
+      ///   @param dt - time between updates, in seconds                      
+      LANGULUS(INLINED)
+      void Step(const Lane& l, Offset i, Real dt) noexcept {
+         // Apply one-time impulse                                      
+         l.mImpulse[i] +=
+            (l.mUseImpulse[i] * l.mUseBoundness[i]) +
+            (l.mSimImpulse[i] * l.mSimBoundness[i]);
+         l.mUseImpulse[i] = 0;
+         l.mSimImpulse[i] = 0;
+
+         l.mPosition[i] += l.mImpulse[i] * dt;
+         l.mImpulse[i] = 0;
+
+         // Change velocity and apply it                                
+         l.mVelocity[i] +=
+            (l.mUseVelocity[i] * l.mUseBoundness[i]) +
+            (l.mSimVelocity[i] * l.mSimBoundness[i]);
+         l.mUseVelocity[i] = 0;
+         l.mSimVelocity[i] = 0;
+
+         l.mPosition[i] = l.mPosition[i] + l.mVelocity[i] * dt;
+         l.mVelocity[i] = l.mVelocity[i] + l.mAcceleration[i] * dt;
+      }
+
+      /// Integrate a range of slots, one at a time                           
+      ///   @param l - the component to integrate                             
+      ///   @param from - first slot                                          
+      ///   @param to - the slot after the last one                           
+      ///   @param dt - time between updates, in seconds                      
+      inline void Run(const Lane& l, Offset from, Offset to, Real dt) noexcept {
+         for (Offset i = from; i < to; ++i)
+            Step(l, i, dt);
+      }
+
+   #if PHYSICS_SIMD_X86()
+      /// Integrate W consecutive slots with a single vector per array        
+      /// Must only be inlined in functions that target a wide enough ISA     
+      ///   @tparam W - number of slots processed at once                     
+      ///   @param l - the component to integrate                             
+      ///   @param i - the first slot index                                   
+      ///   @param dt - time between updates, in seconds                      
+      template<Count W>
+      LANGULUS(INLINED)
+      void StepPack(const Lane& l, Offset i, Real dt) noexcept {
+         typedef Real V __attribute__((vector_size(W * sizeof(Real))));
+         V pos, vel, acc, imp, useV, simV, useI, simI, useB, simB;
+         std::memcpy(&pos,  l.mPosition     + i, sizeof(V));
+         std::memcpy(&vel,  l.mVelocity     + i, sizeof(V));
+         std::memcpy(&acc,  l.mAcceleration + i, sizeof(V));
+         std::memcpy(&imp,  l.mImpulse      + i, sizeof(V));
+         std::memcpy(&useV, l.mUseVelocity  + i, sizeof(V));
+         std::memcpy(&simV, l.mSimVelocity  + i, sizeof(V));
+         std::memcpy(&useI, l.mUseImpulse   + i, sizeof(V));
+         std::memcpy(&simI, l.mSimImpulse   + i, sizeof(V));
+         std::memcpy(&useB, l.mUseBoundness + i, sizeof(V));
+         std::memcpy(&simB, l.mSimBoundness + i, sizeof(V));
+         const V delta = V {} + dt;
+         const V zero  = {};
+
+         // Same operations as in Step, in the same order               
+         imp += (useI * useB) + (simI * simB);
+         pos += imp * delta;
+         vel += (useV * useB) + (simV * simB);
+         pos = pos + vel * delta;
+         vel = vel + acc * delta;
+
+         std::memcpy(l.mPosition    + i, &pos,  sizeof(V));
+         std::memcpy(l.mVelocity    + i, &vel,  sizeof(V));
+         std::memcpy(l.mImpulse     + i, &zero, sizeof(V));
+         std::memcpy(l.mUseVelocity + i, &zero, sizeof(V));
+         std::memcpy(l.mSimVelocity + i, &zero, sizeof(V));
+         std::memcpy(l.mUseImpulse  + i, &zero, sizeof(V));
+         std::memcpy(l.mSimImpulse  + i, &zero, sizeof(V));
+      }
+
+      /// Integrate a range in packs of W slots, and the remainder one by one 
+      ///   @tparam W - number of slots processed at once                     
+      template<Count W>
+      LANGULUS(INLINED)
+      void RunPacked(const Lane& l, Offset from, Offset to, Real dt) noexcept {
+         Offset i = from;
+         for (; i + W <= to; i += W)
+            StepPack<W>(l, i, dt);
+         for (; i < to; ++i)
+            Step(l, i, dt);
+      }
+
+      PHYSICS_TARGET("sse4.1")
+      inline void RunSSE4(const Lane& l, Offset from, Offset to, Real dt) noexcept {
+         RunPacked<16 / sizeof(Real)>(l, from, to, dt);
+      }
+
+      PHYSICS_TARGET("avx2")
+      inline void RunAVX2(const Lane& l, Offset from, Offset to, Real dt) noexcept {
+         RunPacked<32 / sizeof(Real)>(l, from, to, dt);
+      }
+
+      PHYSICS_TARGET("avx512f")
+      inline void RunAVX512(const Lane& l, Offset from, Offset to, Real dt) noexcept {
+         RunPacked<64 / sizeof(Real)>(l, from, to, dt);
+      }
+   #endif
+
+   } // namespace Euclidean::Integrator::Inner
+
+
+   /// Check if the CPU we're running on supports an instruction set          
+   ///   @param isa - the instruction set to check                            
+   ///   @return true if kernels for that instruction set can be used         
+   inline bool IsSupported(ISA isa) noexcept {
+      switch (isa) {
+      case ISA::Scalar:
+         return true;
+   #if PHYSICS_SIMD_X86()
+      case ISA::SSE4:
+         return __builtin_cpu_supports("sse4.1");
+      case ISA::AVX2:
+         return __builtin_cpu_supports("avx2");
+      case ISA::AVX512:
+         return __builtin_cpu_supports("avx512f");
+   #endif
+      default:
+         return false;
+      }
+   }
+
+   /// Get the widest instruction set supported by the CPU                    
+   /// Detected only once, on first call                                      
+   ///   @return the instruction set                                          
+   inline ISA GetBestISA() noexcept {
+      static const ISA best = [] {
+         auto isa = ISA::Scalar;
+         for (auto i = 0; i < static_cast<int>(ISA::Counter); ++i) {
+            if (IsSupported(static_cast<ISA>(i)))
+               isa = static_cast<ISA>(i);
+         }
+         return isa;
+      }();
+      return best;
+   }
+
+   /// Get the name of an instruction set, for logging                        
+   ///   @param isa - the instruction set                                     
+   ///   @return a literal                                                    
+   inline const char* GetName(ISA isa) noexcept {
+      switch (isa) {
+      case ISA::Scalar: return "Scalar";
+      case ISA::SSE4:   return "SSE4";
+      case ISA::AVX2:   return "AVX2";
+      case ISA::AVX512: return "AVX512";
+      default:          return "Unknown";
+      }
+   }
+
+   /// Get the number of slots processed at once by an instruction set        
+   ///   @param isa - the instruction set                                     
+   ///   @return the number of slots                                          
+   inline Count GetWidth(ISA isa) noexcept {
+      switch (isa) {
+      case ISA::SSE4:   return 16 / sizeof(Real);
+      case ISA::AVX2:   return 32 / sizeof(Real);
+      case ISA::AVX512: return 64 / sizeof(Real);
+      default:          return 1;
+      }
+   }
+
+   /// Integrate one component of a range of slots                            
+   /// Falls back to the scalar kernel if the instruction set is unsupported  
+   ///   @param isa - the instruction set to use                              
+   ///   @param l - the component to integrate                                
+   ///   @param from - first slot                                             
+   ///   @param to - the slot after the last one                              
+   ///   @param dt - time between updates, in seconds                         
+   inline void Integrate(ISA isa, const Lane& l, Offset from, Offset to, Real dt) noexcept {
+      if (not IsSupported(isa))
+         isa = ISA::Scalar;
+
+      switch (isa) {
+   #if PHYSICS_SIMD_X86()
+      case ISA::SSE4:
+         return Inner::RunSSE4(l, from, to, dt);
+      case ISA::AVX2:
+         return Inner::RunAVX2(l, from, to, dt);
+      case ISA::AVX512:
+         return Inner::RunAVX512(l, from, to, dt);
+   #endif
+      default:
+         return Inner::Run(l, from, to, dt);
+      }
+   }
+
+} // namespace Euclidean::Integrator
@@ -0,0 +1,49 @@
+///                                                                           
+/// Langulus::Module::Physics                                                 
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include "Scheduler.hpp"
+#include <vector>
+
+
+///                                                                           
+///   Z-order curve                                                           
+///                                                                           
+/// Maps positions to Morton keys, by interleaving the bits of quantized      
+/// coordinates, so that points close in space tend to get close keys.        
+/// Sorting by these keys puts neighbours next to each other in memory        
+///                                                                           
+namespace Euclidean::Morton
+{
+   /// Bits per axis - three axes fit in a 64bit key                          
+   constexpr uint32_t AxisBits = 21;
+
+   /// Maps positions inside a box to the key grid                            
+   struct Quantizer {
+      Vec3 mMin;
+      Vec3 mScale;
+
+      static auto Fit(const Real* x, const Real* y, const Real* z, Count) noexcept -> Quantizer;
+      auto operator () (Real x, Real y, Real z) const noexcept -> uint64_t;
+   };
+
+   auto Spread(uint32_t) noexcept -> uint64_t;
+   auto Encode(uint32_t x, uint32_t y, uint32_t z) noexcept -> uint64_t;
+
+   /// Buffers that sorting needs besides the keys. Owned by whoever sorts,   
+   /// and never shared by two sorts that might run at the same time          
+   struct Scratch {
+      std::vector<uint64_t> mKeys;
+      std::vector<uint32_t> mOrder;
+      std::vector<uint32_t> mHistograms;
+   };
+
+   void Sort(std::vector<uint64_t>& keys, std::vector<uint32_t>& order, Scratch&, Scheduler* = nullptr, uint32_t bits = AxisBits * 3);
+
+} // namespace Euclidean::Morton
+
+#include "Morton.inl"
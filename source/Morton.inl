@@ -0,0 +1,154 @@
+///                                                                           
+/// Langulus::Module::Physics                                                 
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include "Morton.hpp"
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+
+namespace Euclidean::Morton
+{
+
+   /// Spread the lowest 21 bits of a number, leaving two zero bits between   
+   /// every two consecutive bits                                             
+   ///   @param v - the number to spread                                      
+   ///   @return the spread bits                                              
+   inline uint64_t Spread(uint32_t v) noexcept {
+      uint64_t x = v & 0x1FFFFF;
+      x = (x | (x << 32)) & 0x001F00000000FFFFull;
+      x = (x | (x << 16)) & 0x001F0000FF0000FFull;
+      x = (x | (x <<  8)) & 0x100F00F00F00F00Full;
+      x = (x | (x <<  4)) & 0x10C30C30C30C30C3ull;
+      x = (x | (x <<  2)) & 0x1249249249249249ull;
+      return x;
+   }
+
+   /// Interleave three quantized coordinates into a key                      
+   ///   @param x, y, z - coordinates, only the lowest 21 bits are used       
+   ///   @return the key                                                      
+   inline uint64_t Encode(uint32_t x, uint32_t y, uint32_t z) noexcept {
+      return Spread(x) | (Spread(y) << 1) | (Spread(z) << 2);
+   }
+
+   /// Fit the key grid around a set of points                                
+   ///   @param x, y, z - position streams                                    
+   ///   @param count - number of points                                      
+   ///   @return the quantizer                                                
+   inline Quantizer Quantizer::Fit(const Real* x, const Real* y, const Real* z, Count count) noexcept {
+      Vec3 lo {std::numeric_limits<Real>::max()};
+      Vec3 hi {std::numeric_limits<Real>::lowest()};
+      for (Offset i = 0; i < count; ++i) {
+         lo.x = std::min(lo.x, x[i]); hi.x = std::max(hi.x, x[i]);
+         lo.y = std::min(lo.y, y[i]); hi.y = std::max(hi.y, y[i]);
+         lo.z = std::min(lo.z, z[i]); hi.z = std::max(hi.z, z[i]);
+      }
+
+      constexpr Real cells = Real((1u << AxisBits) - 1);
+      Quantizer result {lo, {}};
+      for (int a = 0; a < 3; ++a) {
+         const Real extent = hi[a] - lo[a];
+         result.mScale[a] = extent > 0 ? cells / extent : 0;
+      }
+      return result;
+   }
+
+   /// Get the key of a position                                              
+   /// Positions outside the fitted box are clamped to its sides              
+   ///   @param x, y, z - the position                                        
+   ///   @return the key                                                      
+   inline uint64_t Quantizer::operator () (Real x, Real y, Real z) const noexcept {
+      constexpr Real cells = Real((1u << AxisBits) - 1);
+      const auto quantize = [&](Real v, int a) {
+         const Real q = std::clamp((v - mMin[a]) * mScale[a], Real(0), cells);
+         return static_cast<uint32_t>(q);
+      };
+      return Encode(quantize(x, 0), quantize(y, 1), quantize(z, 2));
+   }
+
+   /// Sort keys with a stable least-significant-digit radix sort             
+   /// Each pass counts digits per chunk, and then scatters each chunk to     
+   /// its own precomputed offsets, so chunks run in parallel and the result  
+   /// doesn't depend on the number of threads                                
+   ///   @param keys - [in/out] the keys to sort                              
+   ///   @param order - [out] original index of each sorted key               
+   ///   @param scratch - buffers to sort with, reused between sorts          
+   ///   @param scheduler - threads to sort on, or nullptr to sort on the     
+   ///      calling thread only                                               
+   ///   @param bits - how many of the lowest bits the keys use, so that      
+   ///      smaller keys are sorted in fewer passes                           
+   inline void Sort(std::vector<uint64_t>& keys, std::vector<uint32_t>& order, Scratch& scratch, Scheduler* scheduler, uint32_t bits) {
+      constexpr uint32_t DigitBits = 11;
+      constexpr uint32_t Digits = 1u << DigitBits;
+      constexpr Count Chunk = 65536;
+      LANGULUS_ASSUME(DevAssumes, keys.size() < std::numeric_limits<uint32_t>::max(),
+         "Too many keys");
+      LANGULUS_ASSUME(DevAssumes, bits <= 64, "Bad key size");
+      const uint32_t passes = (bits + DigitBits - 1) / DigitBits;
+
+      const Count count = keys.size();
+      const Count chunks = std::max((count + Chunk - 1) / Chunk, Count {1});
+      order.resize(count);
+      std::iota(order.begin(), order.end(), 0u);
+
+      auto& keysOut = scratch.mKeys;
+      auto& orderOut = scratch.mOrder;
+      auto& histograms = scratch.mHistograms;
+      keysOut.resize(count);
+      orderOut.resize(count);
+
+      const auto run = [&](auto&& body) {
+         if (scheduler) {
+            scheduler->ParallelFor(0, count, Chunk, body);
+            return;
+         }
+
+         for (Offset from = 0; from < count; from += Chunk)
+            body(from, std::min(from + Chunk, count));
+      };
+
+      for (uint32_t pass = 0; pass < passes; ++pass) {
+         const auto shift = pass * DigitBits;
+         const auto digit = [shift](uint64_t key) {
+            return static_cast<uint32_t>(key >> shift) & (Digits - 1);
+         };
+
+         // Count digits in each chunk                                  
+         histograms.assign(chunks * Digits, 0);
+         run([&](Offset from, Offset to) {
+            auto histogram = histograms.data() + (from / Chunk) * Digits;
+            for (Offset i = from; i < to; ++i)
+               ++histogram[digit(keys[i])];
+         });
+
+         // Offsets, ordered by digit first, and by chunk second        
+         uint32_t sum = 0;
+         for (uint32_t d = 0; d < Digits; ++d) {
+            for (Offset c = 0; c < chunks; ++c) {
+               const auto n = histograms[c * Digits + d];
+               histograms[c * Digits + d] = sum;
+               sum += n;
+            }
+         }
+
+         // Scatter each chunk to its own offsets                       
+         run([&](Offset from, Offset to) {
+            auto cursor = histograms.data() + (from / Chunk) * Digits;
+            for (Offset i = from; i < to; ++i) {
+               const auto at = cursor[digit(keys[i])]++;
+               keysOut[at] = keys[i];
+               orderOut[at] = order[i];
+            }
+         });
+
+         keys.swap(keysOut);
+         order.swap(orderOut);
+      }
+   }
+
+} // namespace Euclidean::Morton
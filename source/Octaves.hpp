@@ -0,0 +1,60 @@
+///                                                                           
+/// Langulus::Module::Physics                                                 
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include "Common.hpp"
+#include <map>
+#include <utility>
+#include <vector>
+
+
+///                                                                           
+///   Octave index                                                            
+///                                                                           
+/// Keeps the slots of an InstancePool bucketed by the octave of their        
+/// level, so that whole octaves can be skipped when looking at the world     
+/// from a higher octave, without visiting every instance. Slots are          
+/// removed the same way the pool removes them - the last slot takes the      
+/// place of the removed one                                                  
+///                                                                           
+struct Euclidean::OctaveIndex {
+   /// Slots that share the same octave, in no particular order               
+   using Bucket = std::vector<Offset>;
+
+private:
+   // Buckets, ordered by octave; empty buckets are removed             
+   std::map<int, Bucket> mBuckets;
+   // Octave of each slot                                               
+   std::vector<int> mOctave;
+   // Position of each slot inside its bucket                           
+   std::vector<Offset> mPosition;
+
+   void Detach(Offset) noexcept;
+   void Attach(Offset, int);
+
+public:
+   void Insert(Offset, int octave);
+   void Remove(Offset) noexcept;
+   void Swap(Offset, Offset) noexcept;
+   auto Update(Offset, int octave) -> bool;
+   void Clear() noexcept;
+
+   auto GetOctave(Offset) const noexcept -> int;
+   auto GetPosition(Offset) const noexcept -> Offset;
+   auto GetBucket(int octave) const noexcept -> const Bucket*;
+   auto GetBucketCount() const noexcept -> Count;
+   auto GetCount() const noexcept -> Count;
+
+   static auto CanBeVisible(int octave, int observer) noexcept -> bool;
+
+   template<class F>
+   void ForEach(F&&) const;
+   template<class F>
+   void ForEachVisible(int observer, F&&) const;
+};
+
+#include "Octaves.inl"
@@ -0,0 +1,168 @@
+///                                                                           
+/// Langulus::Module::Physics                                                 
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include "Octaves.hpp"
+
+
+namespace Euclidean
+{
+
+   /// Add a slot to the end of its octave's bucket                           
+   ///   @param slot - the slot                                               
+   ///   @param octave - the octave to put it in                              
+   inline void OctaveIndex::Attach(Offset slot, int octave) {
+      auto& bucket = mBuckets[octave];
+      mOctave[slot] = octave;
+      mPosition[slot] = bucket.size();
+      bucket.push_back(slot);
+   }
+
+   /// Take a slot out of its bucket, moving the last slot of the bucket in   
+   /// its place. Empty buckets are discarded                                 
+   ///   @param slot - the slot                                               
+   inline void OctaveIndex::Detach(Offset slot) noexcept {
+      const auto found = mBuckets.find(mOctave[slot]);
+      LANGULUS_ASSUME(DevAssumes, found != mBuckets.end(), "Missing bucket");
+      auto& bucket = found->second;
+      const auto last = bucket.back();
+      bucket[mPosition[slot]] = last;
+      mPosition[last] = mPosition[slot];
+      bucket.pop_back();
+      if (bucket.empty())
+         mBuckets.erase(found);
+   }
+
+   /// Add a new slot, which must come right after the last one               
+   ///   @param slot - the slot                                               
+   ///   @param octave - the octave of the slot's level                       
+   inline void OctaveIndex::Insert(Offset slot, int octave) {
+      LANGULUS_ASSUME(DevAssumes, slot == mOctave.size(),
+         "Slots must be inserted in order");
+      mOctave.push_back(octave);
+      mPosition.push_back(0);
+      Attach(slot, octave);
+   }
+
+   /// Remove a slot - the last slot is renamed to the removed one, exactly   
+   /// like InstancePool::Release does it                                     
+   ///   @param slot - the slot to remove                                     
+   inline void OctaveIndex::Remove(Offset slot) noexcept {
+      LANGULUS_ASSUME(DevAssumes, slot < mOctave.size(), "Slot out of range");
+      Detach(slot);
+
+      const Offset last = mOctave.size() - 1;
+      if (slot != last) {
+         mOctave[slot] = mOctave[last];
+         mPosition[slot] = mPosition[last];
+         mBuckets[mOctave[slot]][mPosition[slot]] = slot;
+      }
+
+      mOctave.pop_back();
+      mPosition.pop_back();
+   }
+
+   /// Exchange two slots, the same way InstancePool::Swap does it            
+   ///   @param a - the first slot                                            
+   ///   @param b - the second slot                                           
+   inline void OctaveIndex::Swap(Offset a, Offset b) noexcept {
+      LANGULUS_ASSUME(DevAssumes, a < mOctave.size() and b < mOctave.size(),
+         "Slot out of range");
+      if (a == b)
+         return;
+
+      mBuckets[mOctave[a]][mPosition[a]] = b;
+      mBuckets[mOctave[b]][mPosition[b]] = a;
+      std::swap(mOctave[a], mOctave[b]);
+      std::swap(mPosition[a], mPosition[b]);
+   }
+
+   /// Move a slot to another bucket, if its octave has changed               
+   ///   @param slot - the slot                                               
+   ///   @param octave - the octave of the slot's current level               
+   ///   @return true if the slot changed buckets                             
+   inline bool OctaveIndex::Update(Offset slot, int octave) {
+      LANGULUS_ASSUME(DevAssumes, slot < mOctave.size(), "Slot out of range");
+      if (mOctave[slot] == octave)
+         return false;
+
+      Detach(slot);
+      Attach(slot, octave);
+      return true;
+   }
+
+   /// Remove all slots                                                       
+   inline void OctaveIndex::Clear() noexcept {
+      mBuckets.clear();
+      mOctave.clear();
+      mPosition.clear();
+   }
+
+   /// Get the octave a slot is in                                            
+   ///   @param slot - the slot                                               
+   ///   @return the octave                                                   
+   inline int OctaveIndex::GetOctave(Offset slot) const noexcept {
+      return mOctave[slot];
+   }
+
+   /// Get the place of a slot inside its octave's bucket                     
+   ///   @param slot - the slot                                               
+   ///   @return the index inside the bucket                                  
+   inline Offset OctaveIndex::GetPosition(Offset slot) const noexcept {
+      return mPosition[slot];
+   }
+
+   /// Get the slots in an octave                                             
+   ///   @param octave - the octave                                           
+   ///   @return the bucket, or nullptr if no slots are in that octave        
+   inline auto OctaveIndex::GetBucket(int octave) const noexcept -> const Bucket* {
+      const auto found = mBuckets.find(octave);
+      return found != mBuckets.end() ? &found->second : nullptr;
+   }
+
+   /// Get the number of octaves that contain at least one slot               
+   ///   @return the number of buckets                                        
+   inline Count OctaveIndex::GetBucketCount() const noexcept {
+      return mBuckets.size();
+   }
+
+   /// Get the number of slots in all buckets                                 
+   ///   @return the number of slots                                          
+   inline Count OctaveIndex::GetCount() const noexcept {
+      return mOctave.size();
+   }
+
+   /// Check if anything in an octave can be seen by an observer              
+   /// Instance::Cull discards instances when the observer is at least one    
+   /// level above them, and an octave holds levels up to the next one        
+   ///   @param octave - the octave of the bucket                             
+   ///   @param observer - the octave of the observer                         
+   ///   @return false if all slots in the octave are guaranteed to be culled 
+   inline bool OctaveIndex::CanBeVisible(int octave, int observer) noexcept {
+      return observer < octave + 2;
+   }
+
+   /// Iterate all buckets, from the lowest octave to the highest             
+   ///   @param call - invoked with the octave and its bucket                 
+   template<class F>
+   void OctaveIndex::ForEach(F&& call) const {
+      for (const auto& [octave, bucket] : mBuckets)
+         call(octave, bucket);
+   }
+
+   /// Iterate only the buckets that can be seen by an observer               
+   /// Buckets below the observer are skipped without being visited           
+   ///   @param observer - the octave of the observer                         
+   ///   @param call - invoked with the octave and its bucket                 
+   template<class F>
+   void OctaveIndex::ForEachVisible(int observer, F&& call) const {
+      // Lowest octave that can be visible                              
+      for (auto it = mBuckets.lower_bound(observer - 1); it != mBuckets.end(); ++it)
+         call(it->first, it->second);
+   }
+
+} // namespace Euclidean
@@ -0,0 +1,42 @@
+///                                                                           
+/// Langulus::Module::Physics                                                 
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include "Integrator.hpp"
+#include "ParticlePool.hpp"
+
+
+///                                                                           
+///   Batched particle integration kernels                                    
+///                                                                           
+/// Advance the particles of a ParticlePool, by running over its streams,     
+/// either in place, or into the pool's back streams.                         
+/// Uses the same instruction sets as the Integrator, picked at runtime,      
+/// and the same guarantee - all kernels give bit-identical results           
+///                                                                           
+namespace Euclidean::ParticleIntegrator
+{
+   using Integrator::ISA;
+
+   /// Behavior shared by all particles in a system                           
+   struct Parameters {
+      // Constant acceleration, i.e. gravity                            
+      Vec3 mAcceleration;
+      // Colour that particles fade into, reached at the end of their   
+      // lifetime - fully transparent white by default                  
+      Real mFadeRed = 1;
+      Real mFadeGreen = 1;
+      Real mFadeBlue = 1;
+      Real mFadeAlpha = 0;
+   };
+
+   void Integrate(ISA, ParticlePool&, const Parameters&, Offset from, Offset to, Real dt) noexcept;
+   void IntegrateToBack(ISA, ParticlePool&, const Parameters&, Offset from, Offset to, Real dt) noexcept;
+
+} // namespace Euclidean::ParticleIntegrator
+
+#include "ParticleIntegrator.inl"
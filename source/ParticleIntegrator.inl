@@ -0,0 +1,229 @@
+///                                                                           
+/// Langulus::Module::Physics                                                 
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include "ParticleIntegrator.hpp"
+
+
+namespace Euclidean::ParticleIntegrator
+{
+   namespace Inner
+   {
+
+      /// Pointers to all streams of a pool - particles are read from the     
+      /// input streams, and written to the output ones, which may be the     
+      /// same streams                                                        
+      struct Streams {
+         const Real* mIn[ParticlePool::StreamCount];
+         Real* mOut[ParticlePool::StreamCount];
+
+         Streams(ParticlePool& pool, bool back) noexcept {
+            for (int s = 0; s < ParticlePool::StreamCount; ++s) {
+               const auto stream = static_cast<ParticlePool::Stream>(s);
+               mIn[s] = pool.GetStream(stream);
+               mOut[s] = back ? pool.GetBackStream(stream) : pool.GetStream(stream);
+            }
+         }
+      };
+
+      /// Advance a single particle                                           
+      ///   @param s - the streams                                            
+      ///   @param p - the system parameters                                  
+      ///   @param i - the particle index                                     
+      ///   @param dt - time between updates, in seconds                      
+      LANGULUS(INLINED)
+      void Step(const Streams& s, const Parameters& p, Offset i, Real dt) noexcept {
+         using P = ParticlePool;
+         const auto in = [&](P::Stream stream) { return s.mIn[stream][i]; };
+         const auto out = [&](P::Stream stream) -> Real& { return s.mOut[stream][i]; };
+
+         // Move, then accelerate                                       
+         out(P::PositionX) = in(P::PositionX) + in(P::VelocityX) * dt;
+         out(P::PositionY) = in(P::PositionY) + in(P::VelocityY) * dt;
+         out(P::PositionZ) = in(P::PositionZ) + in(P::VelocityZ) * dt;
+         out(P::VelocityX) = in(P::VelocityX) + p.mAcceleration.x * dt;
+         out(P::VelocityY) = in(P::VelocityY) + p.mAcceleration.y * dt;
+         out(P::VelocityZ) = in(P::VelocityZ) + p.mAcceleration.z * dt;
+
+         // Fade the colour by the part of the remaining life that      
+         // passed, so it arrives at the fade colour right on death     
+         const Real remaining = in(P::Lifetime) - in(P::Age);
+         const Real t = dt / (remaining > dt ? remaining : dt);
+         out(P::Red  ) = in(P::Red  ) + (p.mFadeRed   - in(P::Red  )) * t;
+         out(P::Green) = in(P::Green) + (p.mFadeGreen - in(P::Green)) * t;
+         out(P::Blue ) = in(P::Blue ) + (p.mFadeBlue  - in(P::Blue )) * t;
+         out(P::Alpha) = in(P::Alpha) + (p.mFadeAlpha - in(P::Alpha)) * t;
+         out(P::Age) = in(P::Age) + dt;
+         out(P::Lifetime) = in(P::Lifetime);
+      }
+
+      /// Advance a range of particles, one at a time                         
+      ///   @param s - the streams                                            
+      ///   @param p - the system parameters                                  
+      ///   @param from - first particle                                      
+      ///   @param to - the particle after the last one                       
+      ///   @param dt - time between updates, in seconds                      
+      inline void Run(const Streams& s, const Parameters& p, Offset from, Offset to, Real dt) noexcept {
+         for (Offset i = from; i < to; ++i)
+            Step(s, p, i, dt);
+      }
+
+   #if PHYSICS_SIMD_X86()
+      /// Advance W consecutive particles with a single vector per stream     
+      /// Must only be inlined in functions that target a wide enough ISA     
+      ///   @tparam W - number of particles processed at once                 
+      ///   @param s - the streams                                            
+      ///   @param p - the system parameters                                  
+      ///   @param i - the first particle index                               
+      ///   @param dt - time between updates, in seconds                      
+      template<Count W>
+      LANGULUS(INLINED)
+      void StepPack(const Streams& s, const Parameters& p, Offset i, Real dt) noexcept {
+         using P = ParticlePool;
+         typedef Real V __attribute__((vector_size(W * sizeof(Real))));
+         V px, py, pz, vx, vy, vz, r, g, b, a, age, life;
+         std::memcpy(&px,   s.mIn[P::PositionX] + i, sizeof(V));
+         std::memcpy(&py,   s.mIn[P::PositionY] + i, sizeof(V));
+         std::memcpy(&pz,   s.mIn[P::PositionZ] + i, sizeof(V));
+         std::memcpy(&vx,   s.mIn[P::VelocityX] + i, sizeof(V));
+         std::memcpy(&vy,   s.mIn[P::VelocityY] + i, sizeof(V));
+         std::memcpy(&vz,   s.mIn[P::VelocityZ] + i, sizeof(V));
+         std::memcpy(&r,    s.mIn[P::Red]       + i, sizeof(V));
+         std::memcpy(&g,    s.mIn[P::Green]     + i, sizeof(V));
+         std::memcpy(&b,    s.mIn[P::Blue]      + i, sizeof(V));
+         std::memcpy(&a,    s.mIn[P::Alpha]     + i, sizeof(V));
+         std::memcpy(&age,  s.mIn[P::Age]       + i, sizeof(V));
+         std::memcpy(&life, s.mIn[P::Lifetime]  + i, sizeof(V));
+         const V delta = V {} + dt;
+
+         // Same operations as in Step, in the same order               
+         px += vx * delta;
+         py += vy * delta;
+         pz += vz * delta;
+         vx += p.mAcceleration.x * delta;
+         vy += p.mAcceleration.y * delta;
+         vz += p.mAcceleration.z * delta;
+
+         const V remaining = life - age;
+         const V t = delta / (remaining > delta ? remaining : delta);
+         r += (p.mFadeRed   - r) * t;
+         g += (p.mFadeGreen - g) * t;
+         b += (p.mFadeBlue  - b) * t;
+         a += (p.mFadeAlpha - a) * t;
+         age += delta;
+
+         std::memcpy(s.mOut[P::PositionX] + i, &px,  sizeof(V));
+         std::memcpy(s.mOut[P::PositionY] + i, &py,  sizeof(V));
+         std::memcpy(s.mOut[P::PositionZ] + i, &pz,  sizeof(V));
+         std::memcpy(s.mOut[P::VelocityX] + i, &vx,  sizeof(V));
+         std::memcpy(s.mOut[P::VelocityY] + i, &vy,  sizeof(V));
+         std::memcpy(s.mOut[P::VelocityZ] + i, &vz,  sizeof(V));
+         std::memcpy(s.mOut[P::Red]       + i, &r,   sizeof(V));
+         std::memcpy(s.mOut[P::Green]     + i, &g,   sizeof(V));
+         std::memcpy(s.mOut[P::Blue]      + i, &b,   sizeof(V));
+         std::memcpy(s.mOut[P::Alpha]     + i, &a,   sizeof(V));
+         std::memcpy(s.mOut[P::Age]       + i, &age, sizeof(V));
+         std::memcpy(s.mOut[P::Lifetime]  + i, &life, sizeof(V));
+      }
+
+      /// Advance a range in packs of W particles, and the remainder one by one
+      ///   @tparam W - number of particles processed at once                 
+      template<Count W>
+      LANGULUS(INLINED)
+      void RunPacked(const Streams& s, const Parameters& p, Offset from, Offset to, Real dt) noexcept {
+         Offset i = from;
+         for (; i + W <= to; i += W)
+            StepPack<W>(s, p, i, dt);
+         for (; i < to; ++i)
+            Step(s, p, i, dt);
+      }
+
+      PHYSICS_TARGET("sse4.1")
+      inline void RunSSE4(const Streams& s, const Parameters& p, Offset from, Offset to, Real dt) noexcept {
+         RunPacked<16 / sizeof(Real)>(s, p, from, to, dt);
+      }
+
+      PHYSICS_TARGET("avx2")
+      inline void RunAVX2(const Streams& s, const Parameters& p, Offset from, Offset to, Real dt) noexcept {
+         RunPacked<32 / sizeof(Real)>(s, p, from, to, dt);
+      }
+
+      PHYSICS_TARGET("avx512f")
+      inline void RunAVX512(const Streams& s, const Parameters& p, Offset from, Offset to, Real dt) noexcept {
+         RunPacked<64 / sizeof(Real)>(s, p, from, to, dt);
+      }
+   #endif
+
+      /// Dispatch a range to the kernel of an instruction set                
+      ///   @param isa - the instruction set to use                           
+      ///   @param s - the streams                                            
+      ///   @param p - the system parameters                                  
+      ///   @param from - first particle                                      
+      ///   @param to - the particle after the last one                       
+      ///   @param dt - time between updates, in seconds                      
+      inline void Dispatch(ISA isa, const Streams& s, const Parameters& p, Offset from, Offset to, Real dt) noexcept {
+         if (not Integrator::IsSupported(isa))
+            isa = ISA::Scalar;
+
+         switch (isa) {
+      #if PHYSICS_SIMD_X86()
+         case ISA::SSE4:
+            return RunSSE4(s, p, from, to, dt);
+         case ISA::AVX2:
+            return RunAVX2(s, p, from, to, dt);
+         case ISA::AVX512:
+            return RunAVX512(s, p, from, to, dt);
+      #endif
+         default:
+            return Run(s, p, from, to, dt);
+         }
+      }
+
+   } // namespace Euclidean::ParticleIntegrator::Inner
+
+
+   /// Advance a range of particles - dead particles are advanced, too, and   
+   /// should be compacted afterwards                                         
+   /// Falls back to the scalar kernel if the instruction set is unsupported  
+   ///   @param isa - the instruction set to use                              
+   ///   @param pool - the particles                                          
+   ///   @param p - the system parameters                                     
+   ///   @param from - first particle                                         
+   ///   @param to - the particle after the last one                          
+   ///   @param dt - time between updates, in seconds; must be positive       
+   inline void Integrate(ISA isa, ParticlePool& pool, const Parameters& p, Offset from, Offset to, Real dt) noexcept {
+      LANGULUS_ASSUME(DevAssumes, from <= to and to <= pool.GetCount(),
+         "Bad particle range");
+      if (not (dt > 0))
+         return;
+
+      Inner::Dispatch(isa, Inner::Streams {pool, false}, p, from, to, dt);
+   }
+
+   /// Advance a range of particles into the back streams of the pool,        
+   /// leaving the current ones untouched, so that they can still be read     
+   /// by a renderer. Call ParticlePool::Flip, once all ranges are done       
+   /// Results are bit-identical to Integrate                                 
+   ///   @param isa - the instruction set to use                              
+   ///   @param pool - the particles                                          
+   ///   @param p - the system parameters                                     
+   ///   @param from - first particle                                         
+   ///   @param to - the particle after the last one                          
+   ///   @param dt - time between updates, in seconds; particles are only     
+   ///      copied if it isn't positive                                       
+   inline void IntegrateToBack(ISA isa, ParticlePool& pool, const Parameters& p, Offset from, Offset to, Real dt) noexcept {
+      LANGULUS_ASSUME(DevAssumes, from <= to and to <= pool.GetCount(),
+         "Bad particle range");
+      const Inner::Streams s {pool, true};
+      if (dt > 0)
+         return Inner::Dispatch(isa, s, p, from, to, dt);
+
+      for (int stream = 0; stream < ParticlePool::StreamCount; ++stream)
+         std::copy(s.mIn[stream] + from, s.mIn[stream] + to, s.mOut[stream] + from);
+   }
+
+} // namespace Euclidean::ParticleIntegrator
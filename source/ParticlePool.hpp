@@ -0,0 +1,153 @@
+///                                                                           
+/// Langulus::Module::Physics                                                 
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include "Morton.hpp"
+#include <atomic>
+#include <utility>
+#include <vector>
+
+
+///                                                                           
+///   Particle pool                                                           
+///                                                                           
+/// Structure-of-arrays storage for the particles of a single particle        
+/// system. All streams are allocated once, for a fixed capacity, so that     
+/// emitting and killing particles never touches the heap. Live particles     
+/// are always packed at the front - dead ones are removed by compacting      
+/// the streams, preserving the order of the survivors. Particles can be      
+/// reordered along a Z-order curve, to keep neighbours close in memory.      
+/// Indices change on compaction and sorting, so each particle also has a     
+/// handle, that stays the same during its whole life. Positions and colours  
+/// can be published as a read-only view, that stays intact while the next    
+/// step is integrated into a second block, so renderers can map it without   
+/// copying. Each particle also has a state, and particles can be grouped by  
+/// state, so that per-state work runs over contiguous ranges                 
+///                                                                           
+struct Euclidean::ParticlePool {
+   /// Every stream of particle properties, one Real per particle             
+   enum Stream : uint8_t {
+      PositionX, PositionY, PositionZ,
+      VelocityX, VelocityY, VelocityZ,
+      Red, Green, Blue, Alpha,
+      // Seconds since emission                                         
+      Age,
+      // Seconds until death - a particle dies when its age reaches it  
+      Lifetime,
+
+      StreamCount
+   };
+
+   /// Identifies the state of a particle, see ParticleStates                 
+   using State = uint8_t;
+   static constexpr Count StateLimit = 256;
+
+   /// Everything required to emit a single particle                          
+   struct Particle {
+      Vec3 mPosition;
+      Vec3 mVelocity;
+      Real mRed = 1;
+      Real mGreen = 1;
+      Real mBlue = 1;
+      Real mAlpha = 1;
+      Real mLifetime = 1;
+      State mState = 0;
+   };
+
+   /// Stable identifier of a particle, valid until the particle dies         
+   using Handle = uint32_t;
+   static constexpr Handle InvalidHandle = static_cast<Handle>(-1);
+
+   /// Published positions and colours, for renderers and other modules       
+   struct View {
+      const Real* mPosition[3] {};
+      // Red, green, blue and alpha                                     
+      const Real* mColour[4] {};
+      Count mCount = 0;
+      // Incremented on each publish, zero if nothing was published     
+      uint64_t mGeneration = 0;
+   };
+
+private:
+   // All streams in a single block, each stream is mCapacity long      
+   std::vector<Real> mData;
+   // Spare block of the same size, used when reordering particles      
+   std::vector<Real> mScratch;
+   // Keys of all particles along the curve, and their sorted order     
+   std::vector<uint64_t> mKeys;
+   std::vector<uint32_t> mOrder;
+   Morton::Scratch mSortScratch;
+   // Block that the next step is integrated into, while the current    
+   // one may still be read through the published view                  
+   std::vector<Real> mBack;
+   Count mCapacity = 0;
+   Count mCount = 0;
+   // Curve fitted on the last sort, coherence is measured along it     
+   Morton::Quantizer mCurve {};
+   bool mSorted = false;
+
+   // Handle of each particle, moved along with the streams             
+   std::vector<Handle> mHandleOf;
+   // Current index of each handle, or InvalidHandle if unused          
+   std::vector<uint32_t> mIndexOf;
+   // Handles that aren't in use                                        
+   std::vector<Handle> mFreeHandles;
+
+   // State of each particle, moved along with the streams              
+   std::vector<State> mState;
+   // Where each state's group begins, as of the last grouping, with    
+   // the end of the last group at the back                             
+   std::vector<Offset> mGroups;
+   // Order of the particles, grouped by state, and their handles and   
+   // states, gathered while reordering                                 
+   std::vector<uint32_t> mGrouped;
+   std::vector<Handle> mGatheredHandles;
+   std::vector<State> mGatheredStates;
+
+   // The last two published views, the latest one is at the index of   
+   // the generation's lowest bit. Accessed only through atomic_ref, so 
+   // readers may copy them while the older one is being overwritten    
+   mutable View mViews[2];
+   alignas(std::atomic_ref<uint64_t>::required_alignment)
+   mutable uint64_t mGeneration = 0;
+
+   void FreeHandle(Offset) noexcept;
+   auto CountGroups(Count) noexcept -> bool;
+   void Reorder(const std::vector<uint32_t>&, Scheduler*);
+
+public:
+   ParticlePool(Count capacity = 0);
+
+   void SetCapacity(Count);
+   auto Emit(const Particle&) noexcept -> bool;
+   void Kill(Offset) noexcept;
+   auto Compact() noexcept -> Count;
+   void Clear() noexcept;
+   void Sort(Scheduler* = nullptr);
+   auto Group(Scheduler* = nullptr) -> bool;
+   auto MeasureCoherence(Count samples = 4096) const noexcept -> Real;
+   void Flip() noexcept;
+   void Publish() noexcept;
+
+   auto IsAlive(Offset) const noexcept -> bool;
+   auto GetParticle(Offset) const noexcept -> Particle;
+   auto GetHandle(Offset) const noexcept -> Handle;
+   auto GetIndex(Handle) const noexcept -> Offset;
+   auto GetGroup(State) const noexcept -> std::pair<Offset, Offset>;
+   auto GetGroupedCount() const noexcept -> Count;
+   auto GetStates() noexcept -> State*;
+   auto GetStates() const noexcept -> const State*;
+   auto GetStream(Stream) noexcept -> Real*;
+   auto GetStream(Stream) const noexcept -> const Real*;
+   auto GetBackStream(Stream) noexcept -> Real*;
+   auto GetView() const noexcept -> View;
+   auto GetGeneration() const noexcept -> uint64_t;
+   auto GetCount() const noexcept -> Count;
+   auto GetCapacity() const noexcept -> Count;
+};
+
+#include "ParticlePool.inl"
@@ -0,0 +1,505 @@
+///                                                                           
+/// Langulus::Module::Physics                                                 
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include "ParticlePool.hpp"
+#include <algorithm>
+#include <numeric>
+
+
+namespace Euclidean
+{
+
+   /// Create a pool                                                          
+   ///   @param capacity - the maximum number of live particles               
+   inline ParticlePool::ParticlePool(Count capacity) {
+      SetCapacity(capacity);
+   }
+
+   /// Change the maximum number of live particles                            
+   /// This is the only place where the pool allocates. Particles that don't  
+   /// fit in the new capacity are discarded                                  
+   ///   @param capacity - the new capacity                                   
+   inline void ParticlePool::SetCapacity(Count capacity) {
+      if (capacity == mCapacity)
+         return;
+
+      LANGULUS_ASSUME(DevAssumes, capacity < InvalidHandle, "Capacity too large");
+      while (mCount > capacity)
+         FreeHandle(--mCount);
+      const auto grouped = std::min(GetGroupedCount(), mCount);
+      mState.resize(capacity);
+      mGroups.resize(StateLimit + 1);
+      CountGroups(grouped);
+
+      std::vector<Real> data(capacity * StreamCount);
+      for (int s = 0; s < StreamCount; ++s) {
+         const auto from = mData.begin() + s * mCapacity;
+         std::copy(from, from + mCount, data.begin() + s * capacity);
+      }
+
+      mData = std::move(data);
+      mScratch.clear();
+      mScratch.shrink_to_fit();
+      mBack.assign(mData.size(), 0);
+      mHandleOf.resize(capacity);
+      mCapacity = capacity;
+
+      // The handle table never shrinks, so that handles of survivors   
+      // stay valid. New handles are given out lowest first             
+      const auto handles = static_cast<Handle>(mIndexOf.size());
+      if (capacity > handles) {
+         mIndexOf.resize(capacity, InvalidHandle);
+         std::vector<Handle> fresh(capacity - handles);
+         std::iota(fresh.rbegin(), fresh.rend(), handles);
+         fresh.insert(fresh.end(), mFreeHandles.begin(), mFreeHandles.end());
+         mFreeHandles = std::move(fresh);
+      }
+
+      // The published view points to the old block                     
+      if (GetGeneration())
+         Publish();
+   }
+
+   /// Give the handle of a particle back                                     
+   ///   @param i - the particle index                                        
+   inline void ParticlePool::FreeHandle(Offset i) noexcept {
+      const auto handle = mHandleOf[i];
+      mIndexOf[handle] = InvalidHandle;
+      mFreeHandles.push_back(handle);
+   }
+
+   /// Add a particle at the end of the live ones                             
+   ///   @param p - the particle to emit                                      
+   ///   @return false if the pool is full, and the particle wasn't emitted   
+   inline bool ParticlePool::Emit(const Particle& p) noexcept {
+      if (mCount == mCapacity)
+         return false;
+
+      const auto i = mCount++;
+      const auto handle = mFreeHandles.back();
+      mFreeHandles.pop_back();
+      mHandleOf[i] = handle;
+      mIndexOf[handle] = static_cast<uint32_t>(i);
+
+      auto at = [&](Stream s) -> Real& {
+         return mData[s * mCapacity + i];
+      };
+
+      at(PositionX) = p.mPosition.x;
+      at(PositionY) = p.mPosition.y;
+      at(PositionZ) = p.mPosition.z;
+      at(VelocityX) = p.mVelocity.x;
+      at(VelocityY) = p.mVelocity.y;
+      at(VelocityZ) = p.mVelocity.z;
+      at(Red)       = p.mRed;
+      at(Green)     = p.mGreen;
+      at(Blue)      = p.mBlue;
+      at(Alpha)     = p.mAlpha;
+      at(Age)       = 0;
+      at(Lifetime)  = p.mLifetime;
+      mState[i] = p.mState;
+      return true;
+   }
+
+   /// Mark a particle as dead - it's removed on the next compaction          
+   ///   @param i - the particle index                                        
+   inline void ParticlePool::Kill(Offset i) noexcept {
+      LANGULUS_ASSUME(DevAssumes, i < mCount, "Particle out of range");
+      GetStream(Lifetime)[i] = 0;
+   }
+
+   /// Remove all dead particles, moving the live ones towards the front      
+   /// Survivors keep their order                                             
+   ///   @return the number of removed particles                              
+   inline Count ParticlePool::Compact() noexcept {
+      const Real* age = GetStream(Age);
+      const Real* lifetime = GetStream(Lifetime);
+
+      // Find the first dead particle - everything before it stays      
+      Offset first = 0;
+      while (first < mCount and age[first] < lifetime[first])
+         ++first;
+      if (first == mCount)
+         return 0;
+
+      Real* streams[StreamCount];
+      for (int s = 0; s < StreamCount; ++s)
+         streams[s] = GetStream(static_cast<Stream>(s));
+
+      // Age and lifetime are moved along with everything else, but a   
+      // particle is never moved past the one being checked             
+      const auto grouped = GetGroupedCount();
+      Count removedFromGroups = 0;
+      Offset alive = first;
+      for (Offset i = first; i < mCount; ++i) {
+         if (not (age[i] < lifetime[i])) {
+            FreeHandle(i);
+            removedFromGroups += i < grouped;
+            continue;
+         }
+
+         for (auto stream : streams)
+            stream[alive] = stream[i];
+         mState[alive] = mState[i];
+         mHandleOf[alive] = mHandleOf[i];
+         mIndexOf[mHandleOf[alive]] = static_cast<uint32_t>(alive);
+         ++alive;
+      }
+
+      // Survivors keep their order, so the grouped ones stay grouped   
+      const auto removed = mCount - alive;
+      mCount = alive;
+      if (first < grouped)
+         CountGroups(grouped - removedFromGroups);
+      return removed;
+   }
+
+   /// Remove all particles, keeping the capacity                             
+   inline void ParticlePool::Clear() noexcept {
+      while (mCount)
+         FreeHandle(--mCount);
+      CountGroups(0);
+      if (GetGeneration())
+         Publish();
+   }
+
+   /// Reorder particles along a Z-order curve, fitted around all of them,    
+   /// so that particles close in space end up close in memory. Particles     
+   /// are grouped by state, and each group follows the curve. Handles        
+   /// follow their particles                                                 
+   ///   @param scheduler - threads to sort on, or nullptr to sort on the     
+   ///      calling thread only                                               
+   inline void ParticlePool::Sort(Scheduler* scheduler) {
+      // Number of particles reordered in a single chunk                
+      constexpr Count Chunk = 16384;
+      if (mCount < 2)
+         return;
+
+      const auto run = [&](auto&& body) {
+         if (scheduler)
+            scheduler->ParallelFor(0, mCount, Chunk, body);
+         else
+            body(Offset {0}, mCount);
+      };
+
+      const Real* x = GetStream(PositionX);
+      const Real* y = GetStream(PositionY);
+      const Real* z = GetStream(PositionZ);
+      mCurve = Morton::Quantizer::Fit(x, y, z, mCount);
+      mSorted = true;
+      const auto quantizer = mCurve;
+
+      mKeys.resize(mCount);
+      run([&](Offset from, Offset to) {
+         for (Offset i = from; i < to; ++i)
+            mKeys[i] = quantizer(x[i], y[i], z[i]);
+      });
+      Morton::Sort(mKeys, mOrder, mSortScratch, scheduler);
+
+      // Group by state, keeping the curve order inside each group      
+      mGrouped.resize(mCount);
+      CountGroups(mCount);
+      Offset cursor[StateLimit];
+      std::copy_n(mGroups.begin(), StateLimit, cursor);
+      for (Offset i = 0; i < mCount; ++i)
+         mGrouped[cursor[mState[mOrder[i]]]++] = mOrder[i];
+      Reorder(mGrouped, scheduler);
+   }
+
+   /// Group particles by state, so that each state's particles are in a      
+   /// contiguous range. Particles inside a group keep their order, so that   
+   /// grouping a sorted pool keeps each group sorted                         
+   ///   @param scheduler - threads to move particles on, or nullptr to move  
+   ///      them on the calling thread only                                   
+   ///   @return true if particles had to be moved                            
+   inline bool ParticlePool::Group(Scheduler* scheduler) {
+      if (CountGroups(mCount))
+         return false;
+
+      mGrouped.resize(mCount);
+      Offset cursor[StateLimit];
+      std::copy_n(mGroups.begin(), StateLimit, cursor);
+      for (Offset i = 0; i < mCount; ++i)
+         mGrouped[cursor[mState[i]]++] = static_cast<uint32_t>(i);
+      Reorder(mGrouped, scheduler);
+      return true;
+   }
+
+   /// Count the particles in each state, and find where each group begins    
+   ///   @param count - only particles below this one are counted             
+   ///   @return true if the counted particles are already grouped by state   
+   inline bool ParticlePool::CountGroups(Count count) noexcept {
+      std::fill(mGroups.begin(), mGroups.end(), 0);
+      bool grouped = true;
+      for (Offset i = 0; i < count; ++i) {
+         ++mGroups[mState[i] + 1];
+         grouped &= i == 0 or mState[i - 1] <= mState[i];
+      }
+
+      for (Count s = 0; s < StateLimit; ++s)
+         mGroups[s + 1] += mGroups[s];
+      return grouped;
+   }
+
+   /// Move all particles to a new order, handles follow their particles      
+   ///   @param order - the index each particle is taken from                 
+   ///   @param scheduler - threads to move particles on, or nullptr          
+   inline void ParticlePool::Reorder(const std::vector<uint32_t>& order, Scheduler* scheduler) {
+      // Number of particles reordered in a single chunk                
+      constexpr Count Chunk = 16384;
+      const auto run = [&](auto&& body) {
+         if (scheduler)
+            scheduler->ParallelFor(0, mCount, Chunk, body);
+         else
+            body(Offset {0}, mCount);
+      };
+
+      // Gather all streams in the spare block, and then swap blocks    
+      mGatheredHandles.resize(mCount);
+      mGatheredStates.resize(mCount);
+      mScratch.resize(mData.size());
+      run([&](Offset from, Offset to) {
+         for (int s = 0; s < StreamCount; ++s) {
+            const Real* src = mData.data() + s * mCapacity;
+            Real* dst = mScratch.data() + s * mCapacity;
+            for (Offset i = from; i < to; ++i)
+               dst[i] = src[order[i]];
+         }
+         for (Offset i = from; i < to; ++i) {
+            mGatheredHandles[i] = mHandleOf[order[i]];
+            mGatheredStates[i] = mState[order[i]];
+         }
+      });
+
+      mData.swap(mScratch);
+      std::copy(mGatheredStates.begin(), mGatheredStates.end(), mState.begin());
+      for (Offset i = 0; i < mCount; ++i) {
+         mHandleOf[i] = mGatheredHandles[i];
+         mIndexOf[mHandleOf[i]] = static_cast<uint32_t>(i);
+      }
+   }
+
+   /// Estimate how well particles are ordered along a Z-order curve          
+   /// Pairs of neighbouring particles are sampled over the whole pool, and   
+   /// their keys compared along the curve of the last sort, or along a       
+   /// curve fitted around the samples, if particles were never sorted        
+   ///   @param samples - the maximum number of pairs to sample               
+   ///   @return the part of the sampled pairs that are in order - one right  
+   ///      after sorting, about a half when particles are shuffled           
+   inline Real ParticlePool::MeasureCoherence(Count samples) const noexcept {
+      if (mCount < 2 or samples == 0)
+         return 1;
+
+      const Real* x = GetStream(PositionX);
+      const Real* y = GetStream(PositionY);
+      const Real* z = GetStream(PositionZ);
+      const Count pairs = std::min(samples, mCount - 1);
+      const Count step = (mCount - 1) / pairs;
+
+      auto quantizer = mCurve;
+      if (not mSorted) {
+         Vec3 lo {std::numeric_limits<Real>::max()};
+         Vec3 hi {std::numeric_limits<Real>::lowest()};
+         for (Offset p = 0; p < pairs; ++p) {
+            for (auto i : {p * step, p * step + 1}) {
+               lo.x = std::min(lo.x, x[i]); hi.x = std::max(hi.x, x[i]);
+               lo.y = std::min(lo.y, y[i]); hi.y = std::max(hi.y, y[i]);
+               lo.z = std::min(lo.z, z[i]); hi.z = std::max(hi.z, z[i]);
+            }
+         }
+
+         const Real lx[] {lo.x, hi.x}, ly[] {lo.y, hi.y}, lz[] {lo.z, hi.z};
+         quantizer = Morton::Quantizer::Fit(lx, ly, lz, 2);
+      }
+
+      Count ordered = 0;
+      for (Offset p = 0; p < pairs; ++p) {
+         const auto i = p * step;
+         ordered += quantizer(x[i], y[i], z[i])
+                 <= quantizer(x[i + 1], y[i + 1], z[i + 1]);
+      }
+      return Real(ordered) / Real(pairs);
+   }
+
+   /// Check if a particle is still alive                                     
+   ///   @param i - the particle index                                        
+   ///   @return true if the particle's age hasn't reached its lifetime       
+   inline bool ParticlePool::IsAlive(Offset i) const noexcept {
+      LANGULUS_ASSUME(DevAssumes, i < mCount, "Particle out of range");
+      return GetStream(Age)[i] < GetStream(Lifetime)[i];
+   }
+
+   /// Gather a particle from all streams                                     
+   ///   @param i - the particle index                                        
+   ///   @return the particle                                                 
+   inline auto ParticlePool::GetParticle(Offset i) const noexcept -> Particle {
+      LANGULUS_ASSUME(DevAssumes, i < mCount, "Particle out of range");
+      auto at = [&](Stream s) {
+         return mData[s * mCapacity + i];
+      };
+
+      return {
+         {at(PositionX), at(PositionY), at(PositionZ)},
+         {at(VelocityX), at(VelocityY), at(VelocityZ)},
+         at(Red), at(Green), at(Blue), at(Alpha),
+         at(Lifetime), mState[i]
+      };
+   }
+
+   /// Make the back block current, after a step was integrated into it       
+   /// The previous block stays intact, as long as it's published             
+   inline void ParticlePool::Flip() noexcept {
+      mData.swap(mBack);
+   }
+
+   /// Publish positions and colours of all current particles                 
+   /// The view stays valid while the next step is integrated with            
+   /// ParticleIntegrator::IntegrateToBack, and until the pool is flipped     
+   /// again, sorted, cleared or resized. Particles emitted in the meantime   
+   /// go after the published ones, and aren't seen through the view          
+   inline void ParticlePool::Publish() noexcept {
+      std::atomic_ref<uint64_t> generation {mGeneration};
+      const auto next = generation.load(std::memory_order_relaxed) + 1;
+      const auto store = [](auto& field, auto value) {
+         std::atomic_ref {field}.store(value, std::memory_order_relaxed);
+      };
+
+      // Overwrite the older view only after the previous generation is 
+      // visible, so readers that see any of the new fields also see    
+      // that the generation they started with is no longer the latest  
+      std::atomic_thread_fence(std::memory_order_release);
+      auto& view = mViews[next & 1];
+      for (int a = 0; a < 3; ++a)
+         store(view.mPosition[a], GetStream(static_cast<Stream>(PositionX + a)));
+      for (int c = 0; c < 4; ++c)
+         store(view.mColour[c], GetStream(static_cast<Stream>(Red + c)));
+      store(view.mCount, mCount);
+      store(view.mGeneration, next);
+      generation.store(next, std::memory_order_release);
+   }
+
+   /// Get the handle of a particle                                           
+   ///   @param i - the particle index                                        
+   ///   @return the handle, valid until the particle is compacted away       
+   inline ParticlePool::Handle ParticlePool::GetHandle(Offset i) const noexcept {
+      LANGULUS_ASSUME(DevAssumes, i < mCount, "Particle out of range");
+      return mHandleOf[i];
+   }
+
+   /// Find the current index of a particle                                   
+   ///   @param handle - the handle of the particle                           
+   ///   @return the index, or InvalidHandle if the particle is gone          
+   inline Offset ParticlePool::GetIndex(Handle handle) const noexcept {
+      if (handle >= mIndexOf.size() or mIndexOf[handle] == InvalidHandle)
+         return InvalidHandle;
+      return mIndexOf[handle];
+   }
+
+   /// Get the range of particles in a state, as of the last grouping or      
+   /// sorting. Compacting keeps the ranges valid, but particles emitted      
+   /// since are after all groups, and changing particle states invalidates   
+   /// the ranges until particles are grouped again                           
+   ///   @param state - the state                                             
+   ///   @return the first particle, and the one after the last               
+   inline auto ParticlePool::GetGroup(State state) const noexcept -> std::pair<Offset, Offset> {
+      return {mGroups[state], mGroups[state + 1]};
+   }
+
+   /// Get the number of particles in all groups - the ones after them were   
+   /// emitted since the last grouping, and may be in any state               
+   ///   @return the end of the last group                                    
+   inline Count ParticlePool::GetGroupedCount() const noexcept {
+      return mGroups.empty() ? 0 : mGroups.back();
+   }
+
+   /// Get the state of each particle                                         
+   ///   @return the array, valid until the capacity changes                  
+   inline auto ParticlePool::GetStates() noexcept -> State* {
+      return mState.data();
+   }
+
+   /// Get the state of each particle                                         
+   ///   @return the array, valid until the capacity changes                  
+   inline auto ParticlePool::GetStates() const noexcept -> const State* {
+      return mState.data();
+   }
+
+   /// Get a stream of particle properties                                    
+   ///   @param s - the stream                                                
+   ///   @return the array, valid until the capacity changes, or the          
+   ///      particles are sorted                                              
+   inline Real* ParticlePool::GetStream(Stream s) noexcept {
+      return mData.data() + s * mCapacity;
+   }
+
+   /// Get a stream of particle properties                                    
+   ///   @param s - the stream                                                
+   ///   @return the array, valid until the capacity changes, or the          
+   ///      particles are sorted                                              
+   inline const Real* ParticlePool::GetStream(Stream s) const noexcept {
+      return mData.data() + s * mCapacity;
+   }
+
+   /// Get a stream of the back block, that the next step is integrated into  
+   ///   @param s - the stream                                                
+   ///   @return the array, valid until the capacity changes                  
+   inline Real* ParticlePool::GetBackStream(Stream s) noexcept {
+      return mBack.data() + s * mCapacity;
+   }
+
+   /// Get the latest published view. Can be called from any thread, and      
+   /// never blocks the simulation                                            
+   ///   @return the view, or an empty view if nothing was published yet      
+   inline auto ParticlePool::GetView() const noexcept -> View {
+      std::atomic_ref<uint64_t> generation {mGeneration};
+      while (true) {
+         const auto latest = generation.load(std::memory_order_acquire);
+         if (not latest)
+            return {};
+
+         const auto load = [](auto& field) {
+            return std::atomic_ref {field}.load(std::memory_order_relaxed);
+         };
+
+         auto& from = mViews[latest & 1];
+         View view;
+         for (int a = 0; a < 3; ++a)
+            view.mPosition[a] = load(from.mPosition[a]);
+         for (int c = 0; c < 4; ++c)
+            view.mColour[c] = load(from.mColour[c]);
+         view.mCount = load(from.mCount);
+         view.mGeneration = load(from.mGeneration);
+
+         // Retry if anything was published while copying, because the  
+         // view might have been overwritten halfway through            
+         std::atomic_thread_fence(std::memory_order_acquire);
+         if (generation.load(std::memory_order_relaxed) == latest)
+            return view;
+      }
+   }
+
+   /// Get the number of times particles were published, to check if there    
+   /// is new data, without getting the view                                  
+   ///   @return the generation of the latest view                            
+   inline uint64_t ParticlePool::GetGeneration() const noexcept {
+      return std::atomic_ref<uint64_t> {mGeneration}.load(std::memory_order_acquire);
+   }
+
+   /// Get the number of live particles                                       
+   ///   @return the number of particles                                      
+   inline Count ParticlePool::GetCount() const noexcept {
+      return mCount;
+   }
+
+   /// Get the maximum number of live particles                               
+   ///   @return the capacity                                                 
+   inline Count ParticlePool::GetCapacity() const noexcept {
+      return mCapacity;
+   }
+
+} // namespace Euclidean
@@ -0,0 +1,51 @@
+///                                                                           
+/// Langulus::Module::Physics                                                 
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include "ParticleIntegrator.hpp"
+#include <limits>
+
+
+///                                                                           
+///   Particle state table                                                    
+///                                                                           
+/// Describes the states particles of a system go through, i.e. a spark       
+/// that turns into an ember, and then into smoke. Each state has its own     
+/// behavior, integrated over the state's group in the particle pool, and     
+/// a transition to another state, that happens at a given age. Transitions   
+/// are evaluated for a whole group at once, without branching on states      
+///                                                                           
+struct Euclidean::ParticleStates {
+   using State = ParticlePool::State;
+
+   /// Particles that transition to this state are killed                     
+   static constexpr State Die = ParticlePool::StateLimit - 1;
+
+   /// A single state                                                         
+   struct Description {
+      // Behavior of particles in this state                            
+      ParticleIntegrator::Parameters mParameters;
+      // Age since emission, at which particles leave this state        
+      Real mUntil = std::numeric_limits<Real>::infinity();
+      // The state particles go to                                      
+      State mNext = Die;
+   };
+
+private:
+   // Always contains at least the initial state                        
+   std::vector<Description> mStates {1};
+
+public:
+   auto Add(const Description&) -> State;
+   void Set(State, const Description&) noexcept;
+   auto Get(State) const noexcept -> const Description&;
+   auto GetCount() const noexcept -> Count;
+
+   auto Transition(ParticlePool&) const noexcept -> Count;
+};
+
+#include "ParticleStates.inl"
@@ -0,0 +1,82 @@
+///                                                                           
+/// Langulus::Module::Physics                                                 
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include "ParticleStates.hpp"
+
+
+namespace Euclidean
+{
+
+   /// Add a state to the table                                               
+   ///   @param state - the state description                                 
+   ///   @return the new state's identifier                                   
+   inline auto ParticleStates::Add(const Description& state) -> State {
+      LANGULUS_ASSUME(UserAssumes, mStates.size() < Die, "Too many particle states");
+      mStates.push_back(state);
+      return static_cast<State>(mStates.size() - 1);
+   }
+
+   /// Change a state, i.e. the initial one                                   
+   ///   @param id - the state                                                
+   ///   @param state - the new description                                   
+   inline void ParticleStates::Set(State id, const Description& state) noexcept {
+      LANGULUS_ASSUME(UserAssumes, id < mStates.size(), "Bad particle state");
+      mStates[id] = state;
+   }
+
+   /// Get a state description                                                
+   ///   @param id - the state                                                
+   ///   @return the description                                              
+   inline auto ParticleStates::Get(State id) const noexcept -> const Description& {
+      LANGULUS_ASSUME(UserAssumes, id < mStates.size(), "Bad particle state");
+      return mStates[id];
+   }
+
+   /// Get the number of states in the table                                  
+   ///   @return the number of states                                         
+   inline Count ParticleStates::GetCount() const noexcept {
+      return mStates.size();
+   }
+
+   /// Move particles that are old enough to their next state, or kill them   
+   /// The pool must be grouped by state, and should be grouped again if      
+   /// anything transitioned. Particles move at most one state per call       
+   ///   @param pool - the particles                                          
+   ///   @return the number of particles that transitioned or died            
+   inline Count ParticleStates::Transition(ParticlePool& pool) const noexcept {
+      const Real* age = pool.GetStream(ParticlePool::Age);
+      Real* lifetime = pool.GetStream(ParticlePool::Lifetime);
+      State* states = pool.GetStates();
+      Count transitioned = 0;
+
+      for (State s = 0; s < mStates.size(); ++s) {
+         const auto& state = mStates[s];
+         const auto [from, to] = pool.GetGroup(s);
+         if (from == to or not (state.mUntil < std::numeric_limits<Real>::infinity()))
+            continue;
+
+         // Same state for the whole range, so no branching per particle
+         if (state.mNext == Die) {
+            for (Offset i = from; i < to; ++i) {
+               const bool fires = age[i] >= state.mUntil;
+               lifetime[i] = fires ? 0 : lifetime[i];
+               transitioned += fires;
+            }
+         }
+         else {
+            for (Offset i = from; i < to; ++i) {
+               const bool fires = age[i] >= state.mUntil;
+               states[i] = fires ? state.mNext : s;
+               transitioned += fires;
+            }
+         }
+      }
+      return transitioned;
+   }
+
+} // namespace Euclidean
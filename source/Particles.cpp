@@ -27,7 +27,168 @@ void Particles::Refresh() {
 
 }
 
-/// Update the particle system                                                
-void Particles::Update(Real) {
+/// Update the particle system - advance all particles with the behavior of   
+/// their state, move them to their next states, remove the ones that died,   
+/// and publish the rest. Large systems are split in chunks, if the world     
+/// updates in parallel                                                       
+///   @param dt - time between updates, in seconds                            
+void Particles::Update(Real dt) {
+   // Number of particles integrated in a single chunk                  
+   constexpr Count ParticleChunk = 16384;
+   const auto world = GetProducer();
+   const auto isa = world->GetUpdateMode() == World::UpdateMode::Batched
+      ? Integrator::GetBestISA() : Integrator::ISA::Scalar;
+   const auto count = mParticles.GetCount();
+   const auto scheduler = world->IsParallel()
+      ? &world->GetProducer()->GetScheduler() : nullptr;
 
+   // Integrate into the back block, so that the published particles    
+   // can still be read while the update runs. Particles in states that 
+   // are missing from the table behave like the initial state          
+   const auto integrate = [&](Count state, Offset from, Offset to) {
+      if (state >= mStates.GetCount())
+         state = 0;
+
+      const auto& parameters = mStates.Get(static_cast<ParticlePool::State>(state)).mParameters;
+      if (scheduler and to - from > ParticleChunk) {
+         scheduler->ParallelFor(from, to, ParticleChunk,
+            [&](Offset f, Offset t) {
+               ParticleIntegrator::IntegrateToBack(isa, mParticles, parameters, f, t, dt);
+            });
+      }
+      else
+         ParticleIntegrator::IntegrateToBack(isa, mParticles, parameters, from, to, dt);
+   };
+
+   // Particles are grouped by state since the last update, except the  
+   // ones emitted since, which are integrated in runs of equal states  
+   for (Count state = 0; state < ParticlePool::StateLimit; ++state) {
+      const auto [from, to] = mParticles.GetGroup(static_cast<ParticlePool::State>(state));
+      if (from != to)
+         integrate(state, from, to);
+   }
+
+   const auto states = mParticles.GetStates();
+   for (Offset from = mParticles.GetGroupedCount(); from < count;) {
+      Offset to = from + 1;
+      while (to < count and states[to] == states[from])
+         ++to;
+      integrate(states[from], from, to);
+      from = to;
+   }
+
+   // The published block is the back one from here on, so particles    
+   // can be moved around freely                                        
+   mParticles.Flip();
+   mParticles.Compact();
+   mParticles.Group(scheduler);
+   if (mStates.Transition(mParticles)) {
+      mParticles.Compact();
+      mParticles.Group(scheduler);
+   }
+
+   // Keep neighbours close in memory, for the neighbour grid and for   
+   // whatever consumes the particles after the update                  
+   if ((mResortInterval and ++mFramesSinceSort >= mResortInterval)
+   or mParticles.MeasureCoherence() < mResortCoherence) {
+      mParticles.Sort(scheduler);
+      mFramesSinceSort = 0;
+   }
+
+   if (mInteractionRadius > 0) {
+      mNeighbours.Build(
+         mParticles.GetStream(ParticlePool::PositionX),
+         mParticles.GetStream(ParticlePool::PositionY),
+         mParticles.GetStream(ParticlePool::PositionZ),
+         mParticles.GetCount(), scheduler
+      );
+   }
+
+   mParticles.Publish();
+}
+
+/// Emit a single particle                                                    
+///   @param particle - the particle to emit                                  
+///   @return false if the system is at capacity                              
+bool Particles::Emit(const ParticlePool::Particle& particle) noexcept {
+   return mParticles.Emit(particle);
+}
+
+/// Change the maximum number of particles in the system                      
+///   @param capacity - the new capacity                                      
+void Particles::SetCapacity(Count capacity) {
+   mParticles.SetCapacity(capacity);
+}
+
+/// Change the behavior of particles in the initial state, keeping its        
+/// transition. Systems without other states use it for all particles         
+///   @param parameters - the new parameters                                  
+void Particles::SetParameters(const ParticleIntegrator::Parameters& parameters) noexcept {
+   auto initial = mStates.Get(0);
+   initial.mParameters = parameters;
+   mStates.Set(0, initial);
+}
+
+/// Change the states particles go through. Particles already in states that  
+/// are no longer in the table are killed                                     
+///   @param states - the state table                                         
+void Particles::SetStates(const ParticleStates& states) {
+   mStates = states;
+
+   auto stateOf = mParticles.GetStates();
+   for (Offset i = 0; i < mParticles.GetCount(); ++i) {
+      if (stateOf[i] >= mStates.GetCount())
+         mParticles.Kill(i);
+   }
+}
+
+/// Change the distance at which particles interact                           
+/// The neighbour grid uses it as its cell size, so that all neighbours of a  
+/// particle are within the surrounding cells                                 
+///   @param radius - the radius, or zero to not build the neighbour grid     
+void Particles::SetInteractionRadius(Real radius) noexcept {
+   mInteractionRadius = radius;
+   if (radius > 0)
+      mNeighbours.SetCellSize(radius);
+   else
+      mNeighbours.Clear();
+}
+
+/// Change how often particles are re-sorted along a Z-order curve            
+/// Sorting is stable and cheap compared to the cache misses it saves, but    
+/// isn't free, so it only happens when particles drifted apart in memory     
+///   @param interval - updates between sorts, or zero to sort only on        
+///      low coherence                                                        
+///   @param coherence - sort earlier, if less than this part of sampled      
+///      neighbouring particles are in order; zero to never sort earlier      
+void Particles::SetResorting(Count interval, Real coherence) noexcept {
+   mResortInterval = interval;
+   mResortCoherence = coherence;
+   mFramesSinceSort = 0;
+}
+
+/// Get the particles in the system                                           
+///   @return the particle pool                                               
+auto Particles::GetParticles() const noexcept -> const ParticlePool& {
+   return mParticles;
+}
+
+/// Get the positions and colours published by the last update, to map them   
+/// directly instead of copying them. Poll GetParticles().GetGeneration() to  
+/// know when there is new data                                               
+///   @return the view, valid while the next update runs                      
+auto Particles::GetView() const noexcept -> ParticlePool::View {
+   return mParticles.GetView();
+}
+
+/// Get the states particles go through                                       
+///   @return the state table                                                 
+auto Particles::GetStates() const noexcept -> const ParticleStates& {
+   return mStates;
+}
+
+/// Get the particles binned by position, as of the last update               
+///   @return the neighbour grid, with indices into the particle pool         
+auto Particles::GetNeighbours() const noexcept -> const SpatialHash& {
+   return mNeighbours;
 }
\ No newline at end of file
@@ -7,6 +7,8 @@
 ///                                                                           
 #pragma once
 #include "Instance.hpp"
+#include "ParticleStates.hpp"
+#include "SpatialHash.hpp"
 
 
 ///                                                                           
@@ -19,9 +21,39 @@ struct Euclidean::Particles : A::Particles, Instance {
    LANGULUS(PRODUCER) World;
    LANGULUS_BASES(A::Particles /*Instance base intentionally obscured*/);
 
+   /// Number of particles a system can hold, unless changed                  
+   static constexpr Count DefaultCapacity = 16384;
+
+private:
+   // Particle properties, preallocated for the system's capacity       
+   ParticlePool mParticles {DefaultCapacity};
+   // Behavior of particles in each state, and transitions between them 
+   ParticleStates mStates;
+   // Particles binned by position, rebuilt on each update, so that     
+   // neighbours can be found without testing every pair                
+   SpatialHash mNeighbours;
+   // Distance at which particles interact - zero disables the grid     
+   Real mInteractionRadius = 0;
+   // Particles are re-sorted along a Z-order curve every mResortInterval
+   // updates, or earlier if sampled coherence drops below a threshold  
+   Count mResortInterval = 60;
+   Real mResortCoherence = Real(0.75);
+   Count mFramesSinceSort = 0;
+
 public:
    Particles(World*, const Many&);
 
    void Update(Real);
    void Refresh() override;
+
+   auto Emit(const ParticlePool::Particle&) noexcept -> bool;
+   void SetCapacity(Count);
+   void SetParameters(const ParticleIntegrator::Parameters&) noexcept;
+   void SetStates(const ParticleStates&);
+   void SetInteractionRadius(Real) noexcept;
+   void SetResorting(Count interval, Real coherence) noexcept;
+   auto GetParticles() const noexcept -> const ParticlePool&;
+   auto GetView() const noexcept -> ParticlePool::View;
+   auto GetStates() const noexcept -> const ParticleStates&;
+   auto GetNeighbours() const noexcept -> const SpatialHash&;
 };
\ No newline at end of file
@@ -42,11 +42,24 @@ void Physics::Teardown() {
 }
 
 /// Module update routine                                                     
+/// Worlds share no state, so unless the concurrency is limited to one, each  
+/// world is stepped as its own task on the scheduler                         
 ///   @param dt - time from last update                                       
 bool Physics::Update(Time) {
    LANGULUS(PROFILE);
+   if (mWorldConcurrency == 1) {
+      for (auto& world : mWorlds)
+         world.Update();
+      return true;
+   }
+
+   std::vector<World*> worlds;
    for (auto& world : mWorlds)
-      world.Update();
+      worlds.push_back(&world);
+
+   mScheduler.RunTasks(worlds.size(), mWorldConcurrency, [&](Offset i) {
+      worlds[i]->Update();
+   });
    return true;
 }
 
@@ -54,4 +67,23 @@ bool Physics::Update(Time) {
 ///   @param verb - the creation/destruction verb                             
 void Physics::Create(Verb& verb) {
    mWorlds.Create(this, verb);
+}
+
+/// Get the thread pool, shared by all worlds                                 
+///   @return the scheduler                                                   
+Scheduler& Physics::GetScheduler() noexcept {
+   return mScheduler;
+}
+
+/// Limit the number of worlds that are updated at the same time              
+///   @param limit - one updates worlds one after another (the default),      
+///      zero updates as many worlds as there are threads                     
+void Physics::SetWorldConcurrency(Count limit) noexcept {
+   mWorldConcurrency = limit;
+}
+
+/// Get the maximum number of worlds that are updated at the same time        
+///   @return the limit, where zero means as many as there are threads        
+auto Physics::GetWorldConcurrency() const noexcept -> Count {
+   return mWorldConcurrency;
 }
\ No newline at end of file
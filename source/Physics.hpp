@@ -7,6 +7,7 @@
 ///                                                                           
 #pragma once
 #include "World.hpp"
+#include "Scheduler.hpp"
 #include <Langulus/Verbs/Create.hpp>
 
 
@@ -21,8 +22,15 @@ struct Euclidean::Physics final : A::PhysicalModule {
    LANGULUS_VERBS(Verbs::Create);
 
 private:
+   // Threads shared by all worlds that update in parallel              
+   // Declared first, so that it outlives the worlds                    
+   Scheduler mScheduler;
    // List of created worlds                                         
    TFactory<Euclidean::World> mWorlds;
+   // Maximum number of worlds that are updated at the same time.       
+   // One means that worlds update one after another, zero means as     
+   // many as there are threads                                         
+   Count mWorldConcurrency = 1;
 
 public:
    Physics(Runtime*, const Many&);
@@ -30,4 +38,8 @@ public:
    bool Update(Time);
    void Create(Verb&);
    void Teardown();
+
+   auto GetScheduler() noexcept -> Scheduler&;
+   void SetWorldConcurrency(Count) noexcept;
+   auto GetWorldConcurrency() const noexcept -> Count;
 };
\ No newline at end of file
@@ -0,0 +1,86 @@
+///                                                                           
+/// Langulus::Module::Physics                                                 
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include "amr/Mesh.hpp"
+#include <vector>
+
+
+///                                                                           
+///   Multigrid Poisson solver                                                
+///                                                                           
+/// Solves the Laplacian of a potential equals a source, i.e. for gravity or  
+/// electrostatic potential, over the leaves of an AMR tree, with the         
+/// potential being zero on the boundary of the tree's volume. The tree's     
+/// own levels are the multigrid hierarchy - each V-cycle smooths all nodes   
+/// of a level, restricts into their parents by downsampling, and corrects    
+/// them back by upsampling. Coarse nodes solve for the full approximation    
+/// (FAS), so leaves of all levels take part in the same cycle, and the work  
+/// per cycle is proportional to the number of nodes                          
+///                                                                           
+struct Euclidean::Poisson {
+   using Grid = AMR::AverageGrid<Real>;
+   using Config = AMR::MeshConfig<3, 8, Grid, Grid, Grid, Grid, Grid>;
+   using Node = AMR::Node<Config>;
+   using Tree = AMR::Tree<Config>;
+
+   static constexpr Count BlockSize = Config::BlockSize;
+
+   /// The grids of each block - set the Source on leaves, and read the       
+   /// Potential after solving. The rest are used by the solver               
+   enum : AMR::Index64 {
+      Potential,
+      Source,
+      // The residual on the way down, the correction on the way up     
+      Residual,
+      // The right hand side of each level - the source on leaves       
+      Target,
+      // The potential of coarse nodes, before they were solved         
+      Restricted
+   };
+
+private:
+   Tree mTree;
+   // The size of a cell of the root block                              
+   Vec3 mCellSize {1};
+   // Gauss-Seidel sweeps before and after each coarser level, and on   
+   // the root, where the cycle turns around                            
+   Count mPreSweeps = 2;
+   Count mPostSweeps = 2;
+   Count mCoarseSweeps = 32;
+   // Results of the last solve                                         
+   Count mCycles = 0;
+   Real mResidual = 0;
+   // All nodes of each level, gathered on each solve                   
+   std::vector<std::vector<Node*>> mLevels;
+
+   void Gather();
+   void Exchange(Count level);
+   void Smooth(Count level, Count sweeps);
+   void ComputeResidual(Count level);
+   void Restrict(Count level);
+   void Prolong(Count level);
+   auto Measure() -> Real;
+   auto GetInverseCellSquared(Count level) const noexcept -> Vec3;
+
+   template<class F>
+   static void ForEachCell(const Node&, F&&);
+   static auto Laplacian(const Real*, Offset dy, Offset dz, const Vec3&) noexcept -> Real;
+
+public:
+   void SetCellSize(const Vec3&) noexcept;
+   void SetSweeps(Count pre, Count post, Count coarse) noexcept;
+
+   auto Solve(Real tolerance, Count maxCycles = 32) -> Count;
+   void Cycle();
+
+   auto GetTree() noexcept -> Tree&;
+   auto GetCycles() const noexcept -> Count;
+   auto GetResidual() const noexcept -> Real;
+};
+
+#include "Poisson.inl"
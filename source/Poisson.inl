@@ -0,0 +1,358 @@
+///                                                                           
+/// Langulus::Module::Physics                                                 
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include "Poisson.hpp"
+#include <algorithm>
+#include <cmath>
+
+
+namespace Euclidean
+{
+
+   /// Change the size of the cells of the root block - each level below      
+   /// halves it                                                              
+   ///   @param size - the size of a root cell along each axis                
+   inline void Poisson::SetCellSize(const Vec3& size) noexcept {
+      LANGULUS_ASSUME(UserAssumes, size.x > 0 and size.y > 0 and size.z > 0,
+         "Degenerate cell size");
+      mCellSize = size;
+   }
+
+   /// Change the amount of smoothing in each cycle                           
+   ///   @param pre - sweeps on each level, before restricting to the coarser 
+   ///   @param post - sweeps on each level, after correcting from the coarser
+   ///   @param coarse - sweeps on the root                                   
+   inline void Poisson::SetSweeps(Count pre, Count post, Count coarse) noexcept {
+      mPreSweeps = pre;
+      mPostSweeps = post;
+      mCoarseSweeps = coarse;
+   }
+
+   /// Run V-cycles, until the largest residual on any leaf cell drops to the 
+   /// tolerance. The potential of the leaves is used as the initial guess,   
+   /// so solving again after the source changed a little is cheap            
+   ///   @param tolerance - the largest acceptable residual                   
+   ///   @param maxCycles - gives up after this many cycles                   
+   ///   @return the number of cycles it took                                 
+   inline Count Poisson::Solve(Real tolerance, Count maxCycles) {
+      Gather();
+      for (auto& level : mLevels) {
+         for (auto node : level) {
+            if (not node->isLeaf)
+               continue;
+
+            const auto& source = std::get<Source>(node->data);
+            auto& target = std::get<Target>(node->data);
+            ForEachCell(*node, [&](Offset i) {
+               target.data()[i] = source.data()[i];
+            });
+         }
+      }
+
+      mCycles = 0;
+      mResidual = Measure();
+      while (mResidual > tolerance and mCycles < maxCycles) {
+         Cycle();
+         ++mCycles;
+         mResidual = Measure();
+      }
+      return mCycles;
+   }
+
+   /// Run a single V-cycle, from the finest level to the root and back       
+   /// The levels must be gathered, and leaves must have their target set     
+   inline void Poisson::Cycle() {
+      const auto finest = mLevels.size() - 1;
+      for (auto level = finest; level > 0; --level) {
+         Smooth(level, mPreSweeps);
+         Exchange(level);
+         ComputeResidual(level);
+         Restrict(level);
+      }
+
+      Smooth(0, mCoarseSweeps);
+
+      for (Count level = 1; level <= finest; ++level) {
+         Prolong(level);
+         Smooth(level, mPostSweeps);
+      }
+   }
+
+   /// Collect the nodes of each level                                        
+   inline void Poisson::Gather() {
+      for (auto& level : mLevels)
+         level.clear();
+
+      const auto visit = [&](auto& self, Node* node) -> void {
+         if (mLevels.size() <= node->level)
+            mLevels.resize(node->level + 1);
+         mLevels[node->level].push_back(node);
+         if (node->isLeaf)
+            return;
+
+         AMR::Loop<3>(0, 2, [&](const auto& it) {
+            self(self, node->children[it]);
+         });
+      };
+      visit(visit, mTree.root);
+
+      while (mLevels.back().empty())
+         mLevels.pop_back();
+   }
+
+   /// Fill the halos of all nodes of a level from their neighbours. On the   
+   /// boundary of the volume, the halo mirrors the potential with the        
+   /// opposite sign, so that it's zero on the boundary itself                
+   ///   @param level - the level                                             
+   inline void Poisson::Exchange(Count level) {
+      constexpr auto S = BlockSize;
+      for (auto node : mLevels[level]) {
+         node->synchronize();
+
+         auto& potential = std::get<Potential>(node->data);
+         for (int a = 0; a < 3; ++a) {
+            for (AMR::u64 side : {AMR::u64 {0}, AMR::u64 {2}}) {
+               typename Node::Vu64 direction {1};
+               direction[a] = side;
+               if (node->adjacent[direction])
+                  continue;
+
+               const int b = (a + 1) % 3;
+               const int c = (a + 2) % 3;
+               typename Node::Vu64 halo, inner;
+               halo[a] = side ? S + 1 : 0;
+               inner[a] = side ? S : 1;
+               for (AMR::u64 j = 1; j <= S; ++j) {
+                  for (AMR::u64 k = 1; k <= S; ++k) {
+                     halo[b] = inner[b] = j;
+                     halo[c] = inner[c] = k;
+                     potential[halo] = -potential[inner];
+                  }
+               }
+            }
+         }
+      }
+   }
+
+   /// Red-black Gauss-Seidel sweeps over all nodes of a level. Halos are     
+   /// exchanged before each colour, so each colour sees the other one's      
+   /// latest values, even across blocks                                      
+   ///   @param level - the level                                             
+   ///   @param sweeps - the number of sweeps                                 
+   inline void Poisson::Smooth(Count level, Count sweeps) {
+      constexpr auto S = BlockSize;
+      const auto k = GetInverseCellSquared(level);
+      const Real diagonal = 2 * (k.x + k.y + k.z);
+
+      for (Count sweep = 0; sweep < sweeps; ++sweep) {
+         for (AMR::u64 colour = 0; colour < 2; ++colour) {
+            Exchange(level);
+
+            for (auto node : mLevels[level]) {
+               auto& potential = std::get<Potential>(node->data);
+               const auto& target = std::get<Target>(node->data);
+               Real* u = potential.data();
+               const Real* t = target.data();
+               const auto first = potential.indexOf(typename Node::Vu64 {0});
+               const auto dy = potential.getStride(1);
+               const auto dz = potential.getStride(2);
+               const auto parity = node->position[0] + node->position[1] + node->position[2] + colour;
+
+               for (AMR::u64 z = 1; z <= S; ++z) {
+                  for (AMR::u64 y = 1; y <= S; ++y) {
+                     const auto row = first + z * dz + y * dy;
+                     // Cells of this colour have an even sum of global 
+                     // coordinates, once the colour is added           
+                     for (auto x = 1 + ((parity + y + z) & 1); x <= S; x += 2) {
+                        const auto i = row + x;
+                        const Real neighbours =
+                             k.x * (u[i - 1]  + u[i + 1])
+                           + k.y * (u[i - dy] + u[i + dy])
+                           + k.z * (u[i - dz] + u[i + dz]);
+                        u[i] = (neighbours - t[i]) / diagonal;
+                     }
+                  }
+               }
+            }
+         }
+      }
+   }
+
+   /// Compute the residual of all nodes of a level, whose halos must be      
+   /// up to date                                                             
+   ///   @param level - the level                                             
+   inline void Poisson::ComputeResidual(Count level) {
+      const auto k = GetInverseCellSquared(level);
+      for (auto node : mLevels[level]) {
+         const Real* u = std::get<Potential>(node->data).data();
+         const Real* t = std::get<Target>(node->data).data();
+         Real* r = std::get<Residual>(node->data).data();
+         const auto dy = std::get<Potential>(node->data).getStride(1);
+         const auto dz = std::get<Potential>(node->data).getStride(2);
+         ForEachCell(*node, [&](Offset i) {
+            r[i] = t[i] - Laplacian(u + i, dy, dz, k);
+         });
+      }
+   }
+
+   /// Restrict the potential and the residual of a level into the parents,   
+   /// and set up the parents' full approximation problem - the restricted    
+   /// residual, plus the coarse operator applied on the restricted potential 
+   ///   @param level - the finer level, must be above the root               
+   inline void Poisson::Restrict(Count level) {
+      const auto coarse = level - 1;
+      for (auto node : mLevels[coarse]) {
+         if (node->isLeaf)
+            continue;
+
+         node->downsampleGrid<Grid, Potential>();
+         node->downsampleGrid<Grid, Residual>();
+
+         const Real* u = std::get<Potential>(node->data).data();
+         Real* restricted = std::get<Restricted>(node->data).data();
+         ForEachCell(*node, [&](Offset i) {
+            restricted[i] = u[i];
+         });
+      }
+
+      Exchange(coarse);
+
+      const auto k = GetInverseCellSquared(coarse);
+      for (auto node : mLevels[coarse]) {
+         if (node->isLeaf)
+            continue;
+
+         const Real* u = std::get<Potential>(node->data).data();
+         const Real* r = std::get<Residual>(node->data).data();
+         Real* t = std::get<Target>(node->data).data();
+         const auto dy = std::get<Potential>(node->data).getStride(1);
+         const auto dz = std::get<Potential>(node->data).getStride(2);
+         ForEachCell(*node, [&](Offset i) {
+            t[i] = r[i] + Laplacian(u + i, dy, dz, k);
+         });
+      }
+   }
+
+   /// Correct a level by what its parents changed since they were restricted 
+   ///   @param level - the finer level, must be above the root               
+   inline void Poisson::Prolong(Count level) {
+      for (auto node : mLevels[level - 1]) {
+         if (node->isLeaf)
+            continue;
+
+         const Real* u = std::get<Potential>(node->data).data();
+         const Real* restricted = std::get<Restricted>(node->data).data();
+         Real* e = std::get<Residual>(node->data).data();
+         ForEachCell(*node, [&](Offset i) {
+            e[i] = u[i] - restricted[i];
+         });
+
+         node->upsampleGrid<Grid, Residual>();
+         AMR::Loop<3>(0, 2, [&](const auto& it) {
+            const auto child = node->children[it];
+            Real* cu = std::get<Potential>(child->data).data();
+            const Real* ce = std::get<Residual>(child->data).data();
+            ForEachCell(*child, [&](Offset i) {
+               cu[i] += ce[i];
+            });
+         });
+      }
+   }
+
+   /// Find the largest residual of any leaf cell. Coarse nodes get the       
+   /// restricted potential first, so leaves next to finer ones see it        
+   ///   @return the residual                                                 
+   inline Real Poisson::Measure() {
+      for (auto level = mLevels.size() - 1; level > 0; --level) {
+         for (auto node : mLevels[level - 1]) {
+            if (not node->isLeaf)
+               node->downsampleGrid<Grid, Potential>();
+         }
+      }
+
+      Real largest = 0;
+      for (Count level = 0; level < mLevels.size(); ++level) {
+         Exchange(level);
+         const auto k = GetInverseCellSquared(level);
+         for (auto node : mLevels[level]) {
+            if (not node->isLeaf)
+               continue;
+
+            const Real* u = std::get<Potential>(node->data).data();
+            const Real* t = std::get<Target>(node->data).data();
+            const auto dy = std::get<Potential>(node->data).getStride(1);
+            const auto dz = std::get<Potential>(node->data).getStride(2);
+            ForEachCell(*node, [&](Offset i) {
+               largest = std::max(largest, std::abs(t[i] - Laplacian(u + i, dy, dz, k)));
+            });
+         }
+      }
+      return largest;
+   }
+
+   /// Get the inverse of the squared size of the cells of a level, which     
+   /// weighs each neighbour in the Laplacian                                 
+   ///   @param level - the level, zero for the root                          
+   ///   @return the weights along each axis                                  
+   inline auto Poisson::GetInverseCellSquared(Count level) const noexcept -> Vec3 {
+      const Real scale = Real(AMR::u64 {1} << level);
+      Vec3 result;
+      for (int a = 0; a < 3; ++a)
+         result[a] = scale * scale / (mCellSize[a] * mCellSize[a]);
+      return result;
+   }
+
+   /// Invoke a function with the index of each inner cell of a block         
+   ///   @param node - the node whose block to iterate                        
+   ///   @param call - invoked with the index, the same in all grids          
+   template<class F>
+   void Poisson::ForEachCell(const Node& node, F&& call) {
+      constexpr auto S = BlockSize;
+      const auto& grid = std::get<Potential>(node.data);
+      const auto first = grid.indexOf(typename Node::Vu64 {0});
+      const auto dy = grid.getStride(1);
+      const auto dz = grid.getStride(2);
+      for (AMR::u64 z = 1; z <= S; ++z) {
+         for (AMR::u64 y = 1; y <= S; ++y) {
+            const auto row = first + z * dz + y * dy;
+            for (AMR::u64 x = 1; x <= S; ++x)
+               call(row + x);
+         }
+      }
+   }
+
+   /// Apply the seven-point Laplacian on a single cell                       
+   ///   @param u - the cell                                                  
+   ///   @param dy, dz - distances to the neighbours along Y and Z            
+   ///   @param k - the inverse squared cell size along each axis             
+   ///   @return the Laplacian                                                
+   inline Real Poisson::Laplacian(const Real* u, Offset dy, Offset dz, const Vec3& k) noexcept {
+      return k.x * (*(u - 1)  + *(u + 1)  - 2 * u[0])
+           + k.y * (*(u - dy) + *(u + dy) - 2 * u[0])
+           + k.z * (*(u - dz) + *(u + dz) - 2 * u[0]);
+   }
+
+   /// Get the tree, to refine it and to set the source on its leaves         
+   ///   @return the tree                                                     
+   inline auto Poisson::GetTree() noexcept -> Tree& {
+      return mTree;
+   }
+
+   /// Get the number of cycles the last solve took                           
+   ///   @return the number of cycles                                         
+   inline Count Poisson::GetCycles() const noexcept {
+      return mCycles;
+   }
+
+   /// Get the largest residual of any leaf cell, after the last solve        
+   ///   @return the residual                                                 
+   inline Real Poisson::GetResidual() const noexcept {
+      return mResidual;
+   }
+
+} // namespace Euclidean
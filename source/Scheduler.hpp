@@ -0,0 +1,93 @@
+///                                                                           
+/// Langulus::Module::Physics                                                 
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include "Common.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+///                                                                           
+///   Work-stealing scheduler                                                 
+///                                                                           
+/// A pool of threads, each with its own queue of chunks. Work is split in    
+/// chunks that are spread over all queues, and idle threads steal chunks     
+/// from the back of other queues. The thread that submits work takes part    
+/// in executing it, and returns only when all its chunks are done, which     
+/// makes every ParallelFor a barrier. Nesting is allowed, because waiting    
+/// threads keep executing chunks of the job they wait for. They never start  
+/// chunks of other jobs, so work never runs on top of an unrelated job that  
+/// is only half done on the same thread                                      
+///                                                                           
+struct Euclidean::Scheduler {
+private:
+   /// Type-erased work, shared by all of its chunks                          
+   struct Job {
+      void (*mCall)(const void*, Offset, Offset);
+      const void* mContext;
+      std::atomic<Count> mPending;
+   };
+
+   /// A contiguous range of a job                                            
+   struct Chunk {
+      Job*   mJob;
+      Offset mFrom;
+      Offset mTo;
+   };
+
+   /// A queue of chunks, owned by a thread, but open for stealing            
+   struct Queue {
+      std::mutex mMutex;
+      std::deque<Chunk> mChunks;
+   };
+
+   // Queue 0 belongs to threads outside the pool, the rest to workers  
+   std::vector<std::unique_ptr<Queue>> mQueues;
+   std::vector<std::jthread> mThreads;
+   // Number of worker threads, started lazily on first use             
+   Count mThreadCount;
+   std::once_flag mStarted;
+
+   // Idle workers sleep here, until something gets queued              
+   std::mutex mSleepMutex;
+   std::condition_variable mWake;
+   std::atomic<Count> mQueued {0};
+   std::atomic<bool>  mStop {false};
+
+   // Each worker remembers its scheduler and queue index               
+   static inline thread_local const Scheduler* tOwner = nullptr;
+   static inline thread_local Offset tQueue = 0;
+
+   void Start();
+   void Work(Offset queue);
+   auto GetOwnQueue() const noexcept -> Offset;
+   bool RunOne(Offset queue, const Job* = nullptr);
+
+public:
+   Scheduler(Count threads = DefaultThreadCount());
+   Scheduler(const Scheduler&) = delete;
+   Scheduler(Scheduler&&) = delete;
+   ~Scheduler();
+
+   Scheduler& operator = (const Scheduler&) = delete;
+   Scheduler& operator = (Scheduler&&) = delete;
+
+   static auto DefaultThreadCount() noexcept -> Count;
+   auto GetThreadCount() const noexcept -> Count;
+
+   template<class F>
+   void ParallelFor(Offset from, Offset to, Count grain, F&& body);
+   template<class F>
+   void RunTasks(Count count, Count limit, F&& body);
+};
+
+#include "Scheduler.inl"
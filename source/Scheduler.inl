@@ -0,0 +1,208 @@
+///                                                                           
+/// Langulus::Module::Physics                                                 
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include "Scheduler.hpp"
+#include <algorithm>
+
+
+namespace Euclidean
+{
+
+   /// Create a scheduler                                                     
+   /// No threads are started until work is submitted                         
+   ///   @param threads - number of worker threads, excluding the callers;    
+   ///      zero means that all work is done on the calling thread            
+   inline Scheduler::Scheduler(Count threads)
+      : mThreadCount {threads} {}
+
+   /// Stop and join all workers                                              
+   inline Scheduler::~Scheduler() {
+      {
+         std::scoped_lock lock {mSleepMutex};
+         mStop = true;
+      }
+      mWake.notify_all();
+      mThreads.clear();
+   }
+
+   /// Get the default number of worker threads - one less than the number    
+   /// of hardware threads, because the submitting thread also works          
+   ///   @return the number of threads                                        
+   inline Count Scheduler::DefaultThreadCount() noexcept {
+      const Count hardware = std::thread::hardware_concurrency();
+      return hardware > 1 ? hardware - 1 : 0;
+   }
+
+   /// Get the number of worker threads                                       
+   ///   @return the number of threads                                        
+   inline Count Scheduler::GetThreadCount() const noexcept {
+      return mThreadCount;
+   }
+
+   /// Allocate queues and start the workers                                  
+   inline void Scheduler::Start() {
+      std::call_once(mStarted, [this] {
+         for (Offset i = 0; i <= mThreadCount; ++i)
+            mQueues.emplace_back(std::make_unique<Queue>());
+         for (Offset i = 1; i <= mThreadCount; ++i)
+            mThreads.emplace_back([this, i] { Work(i); });
+      });
+   }
+
+   /// Worker thread routine                                                  
+   ///   @param queue - the queue that belongs to this worker                 
+   inline void Scheduler::Work(Offset queue) {
+      tOwner = this;
+      tQueue = queue;
+
+      while (not mStop) {
+         if (RunOne(queue))
+            continue;
+
+         std::unique_lock lock {mSleepMutex};
+         mWake.wait(lock, [this] { return mStop or mQueued > 0; });
+      }
+   }
+
+   /// Get the queue that belongs to the calling thread                       
+   ///   @return the queue index                                              
+   inline Offset Scheduler::GetOwnQueue() const noexcept {
+      return tOwner == this ? tQueue : 0;
+   }
+
+   /// Execute a single chunk - from the front of our own queue if possible,  
+   /// otherwise stolen from the back of another queue                        
+   ///   @param queue - the queue that belongs to the calling thread          
+   ///   @param only - if not nullptr, only chunks of this job are executed   
+   ///   @return true if a chunk was executed                                 
+   inline bool Scheduler::RunOne(Offset queue, const Job* only) {
+      Chunk chunk;
+      bool found = false;
+      const Count queues = mQueues.size();
+      const auto matches = [only](const Chunk& candidate) {
+         return not only or candidate.mJob == only;
+      };
+
+      for (Offset i = 0; i < queues and not found; ++i) {
+         auto& victim = *mQueues[(queue + i) % queues];
+         std::scoped_lock lock {victim.mMutex};
+         auto& chunks = victim.mChunks;
+         if (i == 0) {
+            const auto at = std::find_if(chunks.begin(), chunks.end(), matches);
+            if (at == chunks.end())
+               continue;
+            chunk = *at;
+            chunks.erase(at);
+         }
+         else {
+            const auto at = std::find_if(chunks.rbegin(), chunks.rend(), matches);
+            if (at == chunks.rend())
+               continue;
+            chunk = *at;
+            chunks.erase(std::next(at).base());
+         }
+         found = true;
+      }
+
+      if (not found)
+         return false;
+
+      --mQueued;
+      const auto job = chunk.mJob;
+      job->mCall(job->mContext, chunk.mFrom, chunk.mTo);
+      // The job may go out of scope right after this                   
+      job->mPending.fetch_sub(1, std::memory_order_release);
+      return true;
+   }
+
+   /// Execute body(from, to) over a range, split in chunks of grain size,    
+   /// on all threads. Returns only after every chunk has been executed       
+   ///   @param from - start of the range                                     
+   ///   @param to - end of the range (exclusive)                             
+   ///   @param grain - maximum size of a chunk; zero picks one automatically 
+   ///   @param body - the function to call for each chunk                    
+   template<class F>
+   void Scheduler::ParallelFor(Offset from, Offset to, Count grain, F&& body) {
+      if (to <= from)
+         return;
+
+      const Count count = to - from;
+      if (grain == 0)
+         grain = count / ((mThreadCount + 1) * 4) + 1;
+
+      if (mThreadCount == 0 or count <= grain) {
+         // Not worth distributing                                      
+         body(from, to);
+         return;
+      }
+
+      Start();
+
+      Job job;
+      job.mCall = [](const void* context, Offset a, Offset b) {
+         (*static_cast<std::remove_reference_t<F>*>(
+            const_cast<void*>(context)))(a, b);
+      };
+      job.mContext = &body;
+      job.mPending = (count + grain - 1) / grain;
+
+      // Count the chunks before they become visible, so that workers   
+      // never see more chunks than the counter                         
+      mQueued += job.mPending.load();
+
+      // Spread the chunks over all queues, starting with our own       
+      const auto own = GetOwnQueue();
+      const Count queues = mQueues.size();
+      Offset target = own;
+      for (Offset at = from; at < to; at += grain) {
+         auto& queue = *mQueues[target];
+         {
+            std::scoped_lock lock {queue.mMutex};
+            queue.mChunks.push_back({&job, at, std::min(at + grain, to)});
+         }
+         target = (target + 1) % queues;
+      }
+
+      {
+         // Lock, so that no worker misses the notification             
+         std::scoped_lock lock {mSleepMutex};
+      }
+      mWake.notify_all();
+
+      // Help out until our own job is done. Chunks of other jobs might 
+      // belong to work that is only half done on this thread, deeper in
+      // the stack, so they're left to the other threads                
+      while (job.mPending.load(std::memory_order_acquire) > 0) {
+         if (not RunOne(own, &job))
+            std::this_thread::yield();
+      }
+   }
+
+   /// Execute body(index) for a number of independent tasks, with at most    
+   /// a limited number of them running at the same time. Tasks are claimed   
+   /// one by one as threads become free, so a long task never holds back     
+   /// the ones after it. Returns only after every task has been executed     
+   ///   @param count - number of tasks                                       
+   ///   @param limit - maximum number of concurrent tasks; zero means one    
+   ///      for each thread, including the calling one                        
+   ///   @param body - the function to call for each task index               
+   template<class F>
+   void Scheduler::RunTasks(Count count, Count limit, F&& body) {
+      if (limit == 0 or limit > mThreadCount + 1)
+         limit = mThreadCount + 1;
+      if (limit > count)
+         limit = count;
+
+      std::atomic<Offset> next = 0;
+      ParallelFor(0, limit, 1, [&](Offset, Offset) {
+         for (Offset i = next++; i < count; i = next++)
+            body(i);
+      });
+   }
+
+} // namespace Euclidean
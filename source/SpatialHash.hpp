@@ -0,0 +1,64 @@
+///                                                                           
+/// Langulus::Module::Physics                                                 
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include "Morton.hpp"
+#include <vector>
+
+
+///                                                                           
+///   Spatial hash grid                                                       
+///                                                                           
+/// Points are binned into uniform cells, and cells are hashed into a table   
+/// of buckets. The grid is rebuilt from scratch by radix sorting points by   
+/// bucket, which leaves the indices of all points in a bucket next to each   
+/// other and in ascending order, so iterating neighbours streams through     
+/// contiguous memory, in the same order regardless of threads. Building      
+/// can run in parallel on a Scheduler, and querying is reentrant             
+///                                                                           
+struct Euclidean::SpatialHash {
+   /// Index of a point, as given to Build                                    
+   using Index = uint32_t;
+
+private:
+   Real mCellSize;
+   Real mInverseCellSize;
+   // Number of buckets minus one - the table size is a power of two    
+   uint32_t mMask = 0;
+
+   // Bucket of each point, sorted along with mIndices                  
+   std::vector<uint64_t> mKeys;
+   Morton::Scratch mScratch;
+   // Where each bucket begins inside mIndices, plus one past the end   
+   std::vector<uint32_t> mBucketStart;
+   // Point indices, sorted by bucket                                   
+   std::vector<Index> mIndices;
+
+   // Positions the grid was built from, used for exact distance tests  
+   const Real* mX = nullptr;
+   const Real* mY = nullptr;
+   const Real* mZ = nullptr;
+
+   auto GetCell(Real) const noexcept -> int64_t;
+   auto Hash(int64_t, int64_t, int64_t) const noexcept -> uint32_t;
+
+public:
+   SpatialHash(Real cellSize = 1);
+
+   void SetCellSize(Real) noexcept;
+   void Build(const Real* x, const Real* y, const Real* z, Count, Scheduler* = nullptr);
+   void Clear() noexcept;
+
+   template<class F>
+   void Query(const Vec3& center, Real radius, F&&) const;
+
+   auto GetCellSize() const noexcept -> Real;
+   auto GetBucketCount() const noexcept -> Count;
+   auto GetCount() const noexcept -> Count;
+};
+
+#include "SpatialHash.inl"
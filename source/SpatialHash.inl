@@ -0,0 +1,184 @@
+///                                                                           
+/// Langulus::Module::Physics                                                 
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include "SpatialHash.hpp"
+#include <atomic>
+#include <bit>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+
+namespace Euclidean
+{
+
+   /// Create an empty grid                                                   
+   ///   @param cellSize - size of a cell, usually the interaction radius     
+   inline SpatialHash::SpatialHash(Real cellSize) {
+      SetCellSize(cellSize);
+   }
+
+   /// Change the size of a cell - takes effect on the next build             
+   ///   @param cellSize - size of a cell, usually the interaction radius     
+   inline void SpatialHash::SetCellSize(Real cellSize) noexcept {
+      LANGULUS_ASSUME(DevAssumes, cellSize > 0, "Bad cell size");
+      mCellSize = cellSize;
+      mInverseCellSize = Real(1) / cellSize;
+   }
+
+   /// Get the cell coordinate along a single axis                            
+   ///   @param x - the coordinate of a point                                 
+   ///   @return the cell coordinate                                          
+   inline int64_t SpatialHash::GetCell(Real x) const noexcept {
+      return static_cast<int64_t>(std::floor(x * mInverseCellSize));
+   }
+
+   /// Hash a cell into a bucket                                              
+   ///   @param x, y, z - cell coordinates                                    
+   ///   @return the bucket index                                             
+   inline uint32_t SpatialHash::Hash(int64_t x, int64_t y, int64_t z) const noexcept {
+      const auto h = static_cast<uint64_t>(x) * 73856093u
+                   ^ static_cast<uint64_t>(y) * 19349663u
+                   ^ static_cast<uint64_t>(z) * 83492791u;
+      return static_cast<uint32_t>(h ^ (h >> 32)) & mMask;
+   }
+
+   /// Rebuild the grid from scratch                                          
+   /// The positions must stay valid and unchanged while querying             
+   ///   @param x, y, z - position streams                                    
+   ///   @param count - number of points                                      
+   ///   @param scheduler - threads to build on, or nullptr to build on the   
+   ///      calling thread only                                               
+   inline void SpatialHash::Build(const Real* x, const Real* y, const Real* z, Count count, Scheduler* scheduler) {
+      // Number of points hashed in a single chunk                      
+      constexpr Count Chunk = 16384;
+      LANGULUS_ASSUME(DevAssumes, count < std::numeric_limits<Index>::max(),
+         "Too many points");
+
+      mX = x;
+      mY = y;
+      mZ = z;
+
+      // About two buckets per point keeps collisions rare              
+      const auto buckets = std::bit_ceil(std::max(count * 2, Count {64}));
+      mMask = static_cast<uint32_t>(buckets - 1);
+      mKeys.resize(count);
+      mBucketStart.assign(buckets + 1, 0);
+
+      // Hash every point, and count the points in each bucket - counts 
+      // don't depend on the order they were added in                   
+      const auto hash = [&](Offset from, Offset to) {
+         for (Offset i = from; i < to; ++i) {
+            const auto bucket = Hash(GetCell(x[i]), GetCell(y[i]), GetCell(z[i]));
+            mKeys[i] = bucket;
+            std::atomic_ref {mBucketStart[bucket + 1]}.fetch_add(1, std::memory_order_relaxed);
+         }
+      };
+
+      if (scheduler)
+         scheduler->ParallelFor(0, count, Chunk, hash);
+      else
+         hash(Offset {0}, count);
+
+      // Turn counts into offsets                                       
+      for (Offset b = 1; b <= buckets; ++b)
+         mBucketStart[b] += mBucketStart[b - 1];
+
+      // Sort indices by bucket - the sort is stable and uses per-chunk 
+      // histograms, so each bucket lists its points in ascending order 
+      Morton::Sort(mKeys, mIndices, mScratch, scheduler,
+         static_cast<uint32_t>(std::bit_width(mMask)));
+   }
+
+   /// Remove all points                                                      
+   inline void SpatialHash::Clear() noexcept {
+      mKeys.clear();
+      mIndices.clear();
+      mBucketStart.clear();
+      mMask = 0;
+   }
+
+   /// Find all points within a radius                                        
+   /// Only buckets of cells that the sphere's bounds touch are visited, and  
+   /// each point is tested against the exact distance                        
+   ///   @param center - the center of the sphere                             
+   ///   @param radius - the radius of the sphere                             
+   ///   @param call - invoked with the index of each point inside the sphere 
+   template<class F>
+   void SpatialHash::Query(const Vec3& center, Real radius, F&& call) const {
+      if (mIndices.empty())
+         return;
+
+      const Real radius2 = radius * radius;
+      const auto visit = [&](uint32_t bucket) {
+         for (auto at = mBucketStart[bucket]; at < mBucketStart[bucket + 1]; ++at) {
+            const auto i = mIndices[at];
+            const Real dx = mX[i] - center.x;
+            const Real dy = mY[i] - center.y;
+            const Real dz = mZ[i] - center.z;
+            if (dx * dx + dy * dy + dz * dz <= radius2)
+               call(i);
+         }
+      };
+
+      const auto x0 = GetCell(center.x - radius), x1 = GetCell(center.x + radius);
+      const auto y0 = GetCell(center.y - radius), y1 = GetCell(center.y + radius);
+      const auto z0 = GetCell(center.z - radius), z1 = GetCell(center.z + radius);
+
+      // Spheres that touch more cells than there are buckets visit all 
+      // buckets instead                                                
+      const Count buckets = mMask + Count {1};
+      if (double(x1 - x0 + 1) * double(y1 - y0 + 1) * double(z1 - z0 + 1) >= double(buckets)) {
+         for (uint32_t bucket = 0; bucket <= mMask; ++bucket)
+            visit(bucket);
+         return;
+      }
+
+      // Different cells may hash into the same bucket, so gather the   
+      // buckets first, and visit each of them once. Usual radii touch  
+      // only a few cells, and fit on the stack                         
+      const auto cells = static_cast<Count>((x1 - x0 + 1) * (y1 - y0 + 1) * (z1 - z0 + 1));
+      uint32_t local[64];
+      std::vector<uint32_t> heap;
+      uint32_t* touched = local;
+      if (cells > std::size(local)) {
+         heap.resize(cells);
+         touched = heap.data();
+      }
+
+      Count n = 0;
+      for (auto cx = x0; cx <= x1; ++cx)
+      for (auto cy = y0; cy <= y1; ++cy)
+      for (auto cz = z0; cz <= z1; ++cz)
+         touched[n++] = Hash(cx, cy, cz);
+
+      std::sort(touched, touched + n);
+      const auto end = std::unique(touched, touched + n);
+      for (auto bucket = touched; bucket != end; ++bucket)
+         visit(*bucket);
+   }
+
+   /// Get the size of a cell                                                 
+   ///   @return the size                                                     
+   inline Real SpatialHash::GetCellSize() const noexcept {
+      return mCellSize;
+   }
+
+   /// Get the number of buckets in the table                                 
+   ///   @return the number of buckets                                        
+   inline Count SpatialHash::GetBucketCount() const noexcept {
+      return mBucketStart.empty() ? 0 : mBucketStart.size() - 1;
+   }
+
+   /// Get the number of points in the grid                                   
+   ///   @return the number of points                                         
+   inline Count SpatialHash::GetCount() const noexcept {
+      return mIndices.size();
+   }
+
+} // namespace Euclidean
@@ -0,0 +1,65 @@
+///                                                                           
+/// Langulus::Module::Physics                                                 
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include "Integrator.hpp"
+#include "amr/Mesh.hpp"
+#include <vector>
+
+
+///                                                                           
+///   Transport stencil kernels                                               
+///                                                                           
+/// Explicit diffusion and advection steps over whole blocks of an AMR tree,  
+/// i.e. for heat or concentration fields. Each new cell value is a weighted  
+/// sum of the cell and its six face neighbours, with the weights computed    
+/// once per block, and the neighbours on the block's border read from the    
+/// halo that the tree synchronizes. Rows along the first axis are            
+/// contiguous, so they're processed several cells per instruction, using     
+/// the same instruction sets as the Integrator, picked at runtime. Every     
+/// kernel performs the same operations in the same order, so results are     
+/// bit-identical across all of them                                          
+///                                                                           
+namespace Euclidean::Stencil
+{
+   using Integrator::ISA;
+
+   /// Weights of a cell and its neighbours in the cell's new value           
+   struct Weights {
+      Real mCenter = 1;
+      // Neighbours before and after the cell, along each axis          
+      Real mLow[3] {};
+      Real mHigh[3] {};
+
+      static auto Transport(Real diffusion, const Vec3& velocity,
+                            const Vec3& cell, Real dt) noexcept -> Weights;
+      auto IsStable() const noexcept -> bool;
+   };
+
+   /// A cubic block of cells, surrounded by a halo one cell thick            
+   /// Source and target share the same layout, with the first axis           
+   /// contiguous in memory                                                   
+   struct Block {
+      // The first halo cell                                            
+      const Real* mSource;
+      Real* mTarget;
+      // Distance between neighbours along the second and third axis    
+      Offset mStrideY;
+      Offset mStrideZ;
+      // Number of inner cells along each axis                          
+      Count mSize;
+   };
+
+   void Apply(ISA, const Block&, const Weights&) noexcept;
+
+   template<AMR::Config C, AMR::Index64 I = 0>
+   void Transport(ISA, AMR::Tree<C>&, std::vector<Real>& scratch,
+                  const Vec3& rootCell, Real diffusion, const Vec3& velocity, Real dt);
+
+} // namespace Euclidean::Stencil
+
+#include "Stencil.inl"
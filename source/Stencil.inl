@@ -0,0 +1,216 @@
+///                                                                           
+/// Langulus::Module::Physics                                                 
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include "Stencil.hpp"
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+
+namespace Euclidean::Stencil
+{
+
+   /// Compute the weights of a single explicit step of diffusion, and of     
+   /// upwind advection, with a uniform velocity                              
+   ///   @param diffusion - how quickly values spread, in units squared per   
+   ///      second                                                            
+   ///   @param velocity - the velocity the values are carried with           
+   ///   @param cell - the size of a cell along each axis                     
+   ///   @param dt - the time step, in seconds                                
+   ///   @return the weights                                                  
+   inline Weights Weights::Transport(
+      Real diffusion, const Vec3& velocity, const Vec3& cell, Real dt
+   ) noexcept {
+      Weights result;
+      for (int a = 0; a < 3; ++a) {
+         // Diffusion takes from both sides, advection only from the    
+         // side the flow comes from                                    
+         const Real spread = diffusion * dt / (cell[a] * cell[a]);
+         const Real flow = velocity[a] * dt / cell[a];
+         result.mLow[a] = spread + std::max(flow, Real(0));
+         result.mHigh[a] = spread + std::max(-flow, Real(0));
+         result.mCenter -= result.mLow[a] + result.mHigh[a];
+      }
+      return result;
+   }
+
+   /// Check if the step can't amplify values, i.e. no weight is negative     
+   /// Otherwise the time step must be reduced, or the cells enlarged         
+   ///   @return true if the step is stable                                   
+   inline bool Weights::IsStable() const noexcept {
+      return mCenter >= 0;
+   }
+
+   namespace Inner
+   {
+
+      /// Compute the new value of a single cell                              
+      ///   @param c - the cell in the source block                           
+      ///   @param out - the cell in the target block                         
+      ///   @param dy, dz - distances to the neighbours along Y and Z         
+      ///   @param w - the weights                                            
+      LANGULUS(INLINED)
+      void Step(const Real* c, Real* out, Offset dy, Offset dz, const Weights& w) noexcept {
+         *out = c[0] * w.mCenter
+              + *(c - 1)  * w.mLow[0] + *(c + 1)  * w.mHigh[0]
+              + *(c - dy) * w.mLow[1] + *(c + dy) * w.mHigh[1]
+              + *(c - dz) * w.mLow[2] + *(c + dz) * w.mHigh[2];
+      }
+
+      /// Compute the inner cells of a block, one at a time                   
+      ///   @param b - the block                                              
+      ///   @param w - the weights                                            
+      inline void Run(const Block& b, const Weights& w) noexcept {
+         for (Offset z = 1; z <= b.mSize; ++z) {
+            for (Offset y = 1; y <= b.mSize; ++y) {
+               const auto row = z * b.mStrideZ + y * b.mStrideY;
+               for (Offset x = 1; x <= b.mSize; ++x)
+                  Step(b.mSource + row + x, b.mTarget + row + x, b.mStrideY, b.mStrideZ, w);
+            }
+         }
+      }
+
+   #if PHYSICS_SIMD_X86()
+      /// Compute W consecutive cells of a row with a single vector per       
+      /// neighbour. Must only be inlined in functions that target a wide     
+      /// enough ISA                                                          
+      ///   @tparam W - number of cells processed at once                     
+      ///   @param c - the first cell in the source block                     
+      ///   @param out - the first cell in the target block                   
+      ///   @param dy, dz - distances to the neighbours along Y and Z         
+      ///   @param w - the weights                                            
+      template<Count W>
+      LANGULUS(INLINED)
+      void StepPack(const Real* c, Real* out, Offset dy, Offset dz, const Weights& w) noexcept {
+         typedef Real V __attribute__((vector_size(W * sizeof(Real))));
+         V center, lowX, highX, lowY, highY, lowZ, highZ;
+         std::memcpy(&center, c,      sizeof(V));
+         std::memcpy(&lowX,   c - 1,  sizeof(V));
+         std::memcpy(&highX,  c + 1,  sizeof(V));
+         std::memcpy(&lowY,   c - dy, sizeof(V));
+         std::memcpy(&highY,  c + dy, sizeof(V));
+         std::memcpy(&lowZ,   c - dz, sizeof(V));
+         std::memcpy(&highZ,  c + dz, sizeof(V));
+
+         // Same operations as in Step, in the same order               
+         const V result = center * w.mCenter
+                        + lowX * w.mLow[0] + highX * w.mHigh[0]
+                        + lowY * w.mLow[1] + highY * w.mHigh[1]
+                        + lowZ * w.mLow[2] + highZ * w.mHigh[2];
+         std::memcpy(out, &result, sizeof(V));
+      }
+
+      /// Compute each row in packs of W cells, and the remainder one by one  
+      ///   @tparam W - number of cells processed at once                     
+      template<Count W>
+      LANGULUS(INLINED)
+      void RunPacked(const Block& b, const Weights& w) noexcept {
+         for (Offset z = 1; z <= b.mSize; ++z) {
+            for (Offset y = 1; y <= b.mSize; ++y) {
+               const auto row = z * b.mStrideZ + y * b.mStrideY;
+               Offset x = 1;
+               for (; x + W <= b.mSize + 1; x += W)
+                  StepPack<W>(b.mSource + row + x, b.mTarget + row + x, b.mStrideY, b.mStrideZ, w);
+               for (; x <= b.mSize; ++x)
+                  Step(b.mSource + row + x, b.mTarget + row + x, b.mStrideY, b.mStrideZ, w);
+            }
+         }
+      }
+
+      PHYSICS_TARGET("sse4.1")
+      inline void RunSSE4(const Block& b, const Weights& w) noexcept {
+         RunPacked<16 / sizeof(Real)>(b, w);
+      }
+
+      PHYSICS_TARGET("avx2")
+      inline void RunAVX2(const Block& b, const Weights& w) noexcept {
+         RunPacked<32 / sizeof(Real)>(b, w);
+      }
+
+      PHYSICS_TARGET("avx512f")
+      inline void RunAVX512(const Block& b, const Weights& w) noexcept {
+         RunPacked<64 / sizeof(Real)>(b, w);
+      }
+   #endif
+
+   } // namespace Euclidean::Stencil::Inner
+
+
+   /// Compute the inner cells of a block into the target. The halo of the    
+   /// target isn't touched                                                   
+   /// Falls back to the scalar kernel if the instruction set is unsupported  
+   ///   @param isa - the instruction set to use                              
+   ///   @param b - the block                                                 
+   ///   @param w - the weights                                               
+   inline void Apply(ISA isa, const Block& b, const Weights& w) noexcept {
+      if (not Integrator::IsSupported(isa))
+         isa = ISA::Scalar;
+
+      switch (isa) {
+   #if PHYSICS_SIMD_X86()
+      case ISA::SSE4:
+         return Inner::RunSSE4(b, w);
+      case ISA::AVX2:
+         return Inner::RunAVX2(b, w);
+      case ISA::AVX512:
+         return Inner::RunAVX512(b, w);
+   #endif
+      default:
+         return Inner::Run(b, w);
+      }
+   }
+
+   /// Make a single explicit diffusion and advection step over all leaves    
+   /// of a tree. Like applyKernel, this reads halos as they are, so the tree 
+   /// must be synchronized before each step - synchronizing usually costs    
+   /// more than the step itself, so do it only as often as needed            
+   ///   @tparam C - the mesh configuration                                   
+   ///   @tparam I - the index of the grid to transport                       
+   ///   @param isa - the instruction set to use                              
+   ///   @param tree - the tree                                               
+   ///   @param scratch - holds the new values of a block, reused between     
+   ///      steps, and never shared by two steps that might run at once       
+   ///   @param rootCell - the size of a cell of the root block               
+   ///   @param diffusion - how quickly values spread, in units squared per   
+   ///      second                                                            
+   ///   @param velocity - the velocity the values are carried with           
+   ///   @param dt - the time step, in seconds                                
+   template<AMR::Config C, AMR::Index64 I>
+   void Transport(ISA isa, AMR::Tree<C>& tree, std::vector<Real>& scratch,
+                  const Vec3& rootCell, Real diffusion, const Vec3& velocity, Real dt) {
+      static_assert(C::Dimension == 3, "Stencils are three dimensional");
+      static_assert(std::is_same_v<typename C::template Data<I>, Real>,
+         "Stencils work on grids of Real");
+      constexpr auto S = C::BlockSize;
+
+      tree.forEachLeaf([&](AMR::Node<C>& node) {
+         const Real scale = Real(1) / Real(AMR::u64 {1} << node.level);
+         const auto weights = Weights::Transport(diffusion, velocity, rootCell * scale, dt);
+         LANGULUS_ASSUME(UserAssumes, weights.IsStable(),
+            "Time step is too large for the finest cells");
+
+         auto& grid = std::get<I>(node.data);
+         Real* first = grid.data() + grid.indexOf(typename C::Vu64 {0});
+         const auto dy = grid.getStride(1);
+         const auto dz = grid.getStride(2);
+         scratch.resize(dz * C::BlockExtent);
+         Apply(isa, {first, scratch.data(), dy, dz, S}, weights);
+
+         // The new values replace the old ones only after the whole    
+         // block is computed, because the kernel reads its neighbours  
+         for (Offset z = 1; z <= S; ++z) {
+            for (Offset y = 1; y <= S; ++y) {
+               const auto row = z * dz + y * dy + 1;
+               std::memcpy(first + row, scratch.data() + row, S * sizeof(Real));
+            }
+         }
+      });
+   }
+
+} // namespace Euclidean::Stencil
@@ -9,6 +9,9 @@
 #include "Physics.hpp"
 #include <Langulus/Flow/Time.hpp>
 #include <Langulus/Math/Gradient.hpp>
+#include <algorithm>
+#include <bit>
+#include <limits>
 
 using namespace Euclidean;
 
@@ -32,6 +35,13 @@ void World::Teardown() {
    mInstances.Teardown();
    mBonds.Teardown();
    mParticles.Teardown();
+   for (auto owner : mPool.mOwners)
+      owner->mSlot = InstancePool::InvalidSlot;
+   mPool.Clear();
+   mIslands.Clear();
+   mBroadphase.Clear();
+   mOctaves.Clear();
+   mAggregates.Clear();
 }
 
 /// Refresh the world component on environment change                         
@@ -50,19 +60,620 @@ void World::Update() {
    }
 
    // Calculate the real delta time factor with required precision      
+   const auto start = std::chrono::steady_clock::now();
    const auto timeAsReal = GetFlow()->GetDeltaTime().Seconds();
+   Advance(timeAsReal);
+
+   mUpdateTime = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - start);
+   VERBOSE_PHYSICS("Advanced ", timeAsReal, " seconds");
+}
+
+/// Advance the simulation by the time elapsed since the last update. With a  
+/// fixed step, the time is consumed in steps of that size, and the rest is   
+/// carried over to the next update                                           
+///   @param elapsed - the elapsed time, in seconds                           
+void World::Advance(Real elapsed) {
+   const auto isa = mUpdateMode == UpdateMode::Batched
+      ? Integrator::GetBestISA() : Integrator::ISA::Scalar;
+
+   if (mFixedStep > 0) {
+      // Consume the elapsed time in fixed steps, and carry the rest    
+      // over to the next update                                        
+      mAccumulator += elapsed;
+      Count steps = 0;
+      while (mAccumulator >= mFixedStep and steps < mMaxSubsteps) {
+         Step(mFixedStep, isa);
+         mAccumulator -= mFixedStep;
+         ++steps;
+      }
+
+      if (mAccumulator >= mFixedStep) {
+         // Fell too far behind - drop the time that wasn't simulated,  
+         // instead of trying to catch up on the following updates      
+         VERBOSE_PHYSICS(Logger::DarkYellow, "Dropped ",
+            mAccumulator - std::fmod(mAccumulator, mFixedStep), " seconds");
+         mAccumulator = std::fmod(mAccumulator, mFixedStep);
+      }
+
+      mInterpolation = mAccumulator / mFixedStep;
+   }
+   else {
+      Step(elapsed, isa);
+      mInterpolation = 1;
+   }
+}
+
+/// Advance the simulation by a single step                                   
+///   @param dt - time to advance, in seconds                                 
+///   @param isa - the instruction set to integrate instances with            
+void World::Step(Real dt, Integrator::ISA isa) {
+   if (mParallel)
+      return UpdateParallel(dt, isa);
 
    // Update all components of the simulation                           
    for (auto& field : mFields)
-      field.Update(timeAsReal);
-   for (auto& instance : mInstances)
-      instance.Update(timeAsReal);
-   for (auto& bonds : mBonds)
-      bonds.Update(timeAsReal);
+      field.Update(dt);
+   ApplyFields(dt);
+   if (mFixedStep > 0)
+      mPool.SavePrevious(0, mPool.GetActiveCount());
+   mPool.Integrate(dt, isa);
+   SolveBonds(dt);
+   UpdateBroadphase(dt);
+   UpdateOctaves();
+   UpdateAggregates();
+   UpdateSleeping();
    for (auto& particle : mParticles)
-      particle.Update(timeAsReal);
+      particle.Update(dt);
+}
 
-   VERBOSE_PHYSICS("Advanced ", timeAsReal, " seconds");
+/// Update all units produced by a factory in parallel, one unit per chunk    
+///   @param scheduler - the threads to use                                   
+///   @param factory - the factory to update                                  
+///   @param dt - time between updates, in seconds                            
+template<class T>
+static void UpdateUnits(Scheduler& scheduler, TFactory<T>& factory, Real dt) {
+   // Factories aren't randomly accessible, so gather the units first   
+   std::vector<T*> units;
+   for (auto& unit : factory)
+      units.push_back(&unit);
+
+   scheduler.ParallelFor(0, units.size(), 1, [&](Offset from, Offset to) {
+      for (Offset i = from; i < to; ++i)
+         units[i]->Update(dt);
+   });
+}
+
+/// Update the world, splitting each phase in chunks that are executed on     
+/// all threads. Each phase completes before the next one begins, so the      
+/// fields -> instances -> bonds -> particles order is preserved              
+///   @param dt - time between updates, in seconds                            
+///   @param isa - the instruction set to integrate instances with            
+void World::UpdateParallel(Real dt, Integrator::ISA isa) {
+   // Number of instances integrated in a single chunk                  
+   constexpr Count InstanceChunk = 4096;
+   auto& scheduler = GetProducer()->GetScheduler();
+
+   UpdateUnits(scheduler, mFields, dt);
+   ApplyFields(dt, &scheduler);
+   scheduler.ParallelFor(0, mPool.GetActiveCount(), InstanceChunk,
+      [&](Offset from, Offset to) {
+         if (mFixedStep > 0)
+            mPool.SavePrevious(from, to);
+         mPool.Integrate(from, to, dt, isa);
+      });
+   SolveBonds(dt, &scheduler);
+   UpdateBroadphase(dt);
+   UpdateOctaves();
+   UpdateAggregates();
+   UpdateSleeping();
+   UpdateUnits(scheduler, mParticles, dt);
+}
+
+/// Accelerate the instances inside each field. Instead of evaluating every   
+/// field at every instance, the instances inside a field's volume are found  
+/// through the broadphase, sorted along a Z-order curve aligned with the     
+/// field's blocks, and sampled in chunks - so each block is located once per 
+/// chunk, and its cells stay in cache. Only solid instances have proxies,    
+/// so only they are affected, and the field refines its blocks only around   
+/// them. Sleeping instances are woken up only if the field would speed them  
+/// up past the sleeping threshold                                            
+///   @param dt - time between updates, in seconds                            
+///   @param scheduler - threads to sort and sample on, or nullptr to do it   
+///      on this thread                                                       
+void World::ApplyFields(Real dt, Scheduler* scheduler) {
+   // Number of instances sampled in a single chunk                     
+   constexpr Count SampleChunk = 1024;
+
+   for (auto& field : mFields) {
+      const auto& values = field.GetValues();
+      const Broadphase::Box volume {
+         values.GetOrigin(), values.GetOrigin() + values.GetSize()
+      };
+
+      // The field's own instance, and static ones, are never moved     
+      mFieldSlots.clear();
+      mBroadphase.Query(volume, [&](Broadphase::Proxy proxy) {
+         const auto slot = mBroadphase.GetData(proxy);
+         if (not mPool.mStatic[slot] and mPool.mOwners[slot] != &field)
+            mFieldSlots.push_back(slot);
+         return true;
+      });
+      if (mFieldSlots.empty()) {
+         field.Adapt(nullptr, nullptr, nullptr, nullptr, 0);
+         continue;
+      }
+
+      // A curve over the whole volume, with a power of two cells along 
+      // each axis, visits every block of the field in one go           
+      constexpr Real cells = Real(1u << Morton::AxisBits);
+      const Morton::Quantizer curve {volume.mMin, Vec3 {
+         cells / values.GetSize().x,
+         cells / values.GetSize().y,
+         cells / values.GetSize().z
+      }};
+
+      const auto count = mFieldSlots.size();
+      const auto active = mPool.GetActiveCount();
+      mFieldKeys.resize(count);
+      for (Offset i = 0; i < count; ++i) {
+         const auto at = mPool.mPosition.Get(mFieldSlots[i]);
+         mFieldKeys[i] = curve(at.x, at.y, at.z);
+      }
+      Morton::Sort(mFieldKeys, mFieldOrder, mFieldScratch, scheduler);
+
+      for (auto& stream : mFieldSamples)
+         stream.resize(count);
+      mFieldMoving.resize(count);
+      for (Offset i = 0; i < count; ++i) {
+         const auto slot = mFieldSlots[mFieldOrder[i]];
+         const auto at = mPool.mPosition.Get(slot);
+         mFieldSamples[0][i] = at.x;
+         mFieldSamples[1][i] = at.y;
+         mFieldSamples[2][i] = at.z;
+         mFieldMoving[i] = slot < active;
+      }
+
+      // Refine around the sorted instances, so that blocks are located 
+      // in the same order they're sampled in                           
+      field.Adapt(mFieldSamples[0].data(), mFieldSamples[1].data(),
+         mFieldSamples[2].data(), mFieldMoving.data(), count);
+
+      const auto sample = [&](Offset from, Offset to) {
+         values.Sample(
+            mFieldSamples[0].data() + from, mFieldSamples[1].data() + from,
+            mFieldSamples[2].data() + from, to - from,
+            mFieldSamples[3].data() + from, mFieldSamples[4].data() + from,
+            mFieldSamples[5].data() + from
+         );
+      };
+      if (scheduler)
+         scheduler->ParallelFor(0, count, SampleChunk, sample);
+      else
+         sample(0, count);
+
+      const Real wake = mSleepSpeed * mSleepSpeed;
+      mFieldWoken.clear();
+      for (Offset i = 0; i < count; ++i) {
+         const auto slot = mFieldSlots[mFieldOrder[i]];
+         const Vec3 change {
+            mFieldSamples[3][i] * dt, mFieldSamples[4][i] * dt, mFieldSamples[5][i] * dt
+         };
+         if (slot < active) {
+            mPool.mSimVelocity.mX[slot] += change.x;
+            mPool.mSimVelocity.mY[slot] += change.y;
+            mPool.mSimVelocity.mZ[slot] += change.z;
+         }
+         else if (change.x * change.x + change.y * change.y + change.z * change.z > wake)
+            mFieldWoken.emplace_back(mPool.mProxy[slot], i);
+      }
+
+      // Waking reorders slots, so they're found through the proxies    
+      for (const auto& [proxy, at] : mFieldWoken) {
+         const auto slot = Wake(mBroadphase.GetData(proxy));
+         mPool.mSimVelocity.mX[slot] += mFieldSamples[3][at] * dt;
+         mPool.mSimVelocity.mY[slot] += mFieldSamples[4][at] * dt;
+         mPool.mSimVelocity.mZ[slot] += mFieldSamples[5][at] * dt;
+      }
+   }
+}
+
+/// Keep bonded instances at their rest distance. Each island of bonds is     
+/// solved on its own, straight from the columns of the bond table - islands  
+/// large enough are split in colours between all threads, one after          
+/// another, and the rest are solved at the same time, one island per task.   
+/// Islands are solved right after integration, so the broadphase is refit    
+/// with the solved positions                                                 
+///   @param dt - time between updates, in seconds                            
+///   @param scheduler - threads to solve on, or nullptr to solve on this     
+///      thread                                                               
+void World::SolveBonds(Real dt, Scheduler* scheduler) {
+   // Islands with fewer bonds are solved on a single thread            
+   constexpr Count LargeIsland = 4096;
+
+   mIslands.Group();
+
+   // An island is solved as a whole, so a single awake member wakes up 
+   // all the others, and islands without one are skipped entirely.     
+   // Waking swaps slots, which the islands patch in place              
+   mAwakeIslands.clear();
+   for (Offset island = 0; island < mIslands.GetIslandCount(); ++island) {
+      bool awake = false;
+      mIslands.ForEachInIsland(island, [&](uint32_t bond) {
+         awake |= mIslands.GetSlot(bond, 0) < mPool.GetActiveCount()
+               or mIslands.GetSlot(bond, 1) < mPool.GetActiveCount();
+      });
+      if (not awake)
+         continue;
+
+      // Members rest for as long as the most recently moving one, so   
+      // that they fall asleep together, instead of waking each other   
+      uint32_t rest = std::numeric_limits<uint32_t>::max();
+      mIslands.ForEachInIsland(island, [&](uint32_t bond) {
+         for (Offset end = 0; end < 2; ++end) {
+            auto slot = mIslands.GetSlot(bond, end);
+            if (mPool.mStatic[slot])
+               continue;
+            if (slot >= mPool.GetActiveCount())
+               slot = Wake(slot);
+            rest = std::min(rest, mPool.mRest[slot]);
+         }
+      });
+      mIslands.ForEachInIsland(island, [&](uint32_t bond) {
+         for (Offset end = 0; end < 2; ++end) {
+            const auto slot = mIslands.GetSlot(bond, end);
+            if (not mPool.mStatic[slot])
+               mPool.mRest[slot] = rest;
+         }
+      });
+      mAwakeIslands.push_back(island);
+   }
+
+   const BondSolver::State state {
+      mPool.mPosition.mX.data(), mPool.mPosition.mY.data(), mPool.mPosition.mZ.data(),
+      mPool.mVelocity.mX.data(), mPool.mVelocity.mY.data(), mPool.mVelocity.mZ.data(),
+      mPool.mStatic.data()
+   };
+   // Islands don't share movable instances, so they can be solved in   
+   // any order, on any thread, with the same results                   
+   mIslandStats.resize(mAwakeIslands.size());
+   mSmallIslands.clear();
+   for (Offset task = 0; task < mAwakeIslands.size(); ++task) {
+      const auto island = mAwakeIslands[task];
+      if (not scheduler or mIslands.GetIslandSize(island) < LargeIsland) {
+         mSmallIslands.push_back(task);
+         continue;
+      }
+
+      mIslandStats[task] = mBondSolver.Solve(state, mIslands.GetTable(island), dt, scheduler);
+   }
+
+   const auto solve = [&](Offset index) {
+      // Declared here, so that each thread has its own solver. Small   
+      // islands are solved without the scheduler, so the solver never  
+      // waits, and a waiting thread only helps with the job it waits   
+      // for, so no thread enters the solver while it is already in it  
+      thread_local BondSolver tSolver;
+      const auto task = mSmallIslands[index];
+      mIslandStats[task] = tSolver.Solve(state, mIslands.GetTable(mAwakeIslands[task]), dt);
+   };
+   if (scheduler)
+      scheduler->RunTasks(mSmallIslands.size(), 0, solve);
+   else for (Offset index = 0; index < mSmallIslands.size(); ++index)
+      solve(index);
+
+   mBondStats = {};
+   for (const auto& stats : mIslandStats) {
+      mBondStats.mBonds += stats.mBonds;
+      mBondStats.mColours = std::max(mBondStats.mColours, stats.mColours);
+      mBondStats.mIterations = std::max(mBondStats.mIterations, stats.mIterations);
+      mBondStats.mResidual = std::max(mBondStats.mResidual, stats.mResidual);
+   }
+}
+
+/// Refit the broadphase after instances have moved. Only active instances    
+/// are visited, and only those that escaped their fat boxes change the tree. 
+/// Sleeping instances, whose boxes are touched by a reinserted box, are      
+/// woken up                                                                  
+///   @param dt - time between updates, in seconds                            
+void World::UpdateBroadphase(Real dt) {
+   mTouched.clear();
+
+   const auto active = mPool.GetActiveCount();
+   for (Offset slot = 0; slot < active; ++slot) {
+      if (not RefitProxy(slot, dt))
+         continue;
+
+      const auto& box = mBroadphase.GetFatBox(mPool.mProxy[slot]);
+      mBroadphase.Query(box, [&](Broadphase::Proxy other) {
+         if (mBroadphase.GetData(other) >= active)
+            mTouched.push_back(other);
+         return true;
+      });
+   }
+
+   // Waking reorders slots, so they're found through the proxies       
+   for (auto proxy : mTouched)
+      Wake(mBroadphase.GetData(proxy));
+}
+
+/// Update the broadphase proxy of a single instance. Instances that became   
+/// solid or stopped being solid are inserted or removed                      
+///   @param slot - the slot inside the instance pool                         
+///   @param dt - time between updates, in seconds                            
+///   @return true if the proxy was inserted or reinserted in the tree        
+bool World::RefitProxy(Offset slot, Real dt) {
+   auto& proxy = mPool.mProxy[slot];
+   if (not mPool.mSolid[slot]) {
+      if (proxy != Broadphase::InvalidProxy) {
+         mBroadphase.Remove(proxy);
+         proxy = Broadphase::InvalidProxy;
+      }
+      return false;
+   }
+
+   const auto box = mPool.GetBox(slot);
+   const auto displacement = mPool.mVelocity.Get(slot) * dt;
+   if (proxy == Broadphase::InvalidProxy) {
+      proxy = mBroadphase.Insert(box, slot, displacement);
+      return true;
+   }
+   return mBroadphase.Move(proxy, box, displacement);
+}
+
+/// Move active instances whose level changed during integration to the       
+/// bucket of their new octave                                                
+void World::UpdateOctaves() {
+   const auto active = mPool.GetActiveCount();
+   for (Offset slot = 0; slot < active; ++slot)
+      MoveToOctave(slot, OctaveOf(mPool.mLevel[slot]));
+}
+
+/// Move a slot to the bucket of another octave, if its octave changed, and   
+/// invalidate the point clouds of both octaves                               
+///   @param slot - the slot                                                  
+///   @param octave - the octave of the slot's current level                  
+void World::MoveToOctave(Offset slot, int octave) {
+   const auto previous = mOctaves.GetOctave(slot);
+   if (not mOctaves.Update(slot, octave))
+      return;
+
+   mAggregates.Invalidate(previous);
+   mAggregates.Invalidate(octave);
+}
+
+/// Bring the point clouds of all octaves up to date. Must happen before      
+/// instances are put to sleep, because sleeping points aren't rewritten      
+void World::UpdateAggregates() {
+   mAggregates.Refresh(mOctaves, mPool.GetBounds(), mPool.GetActiveCount());
+}
+
+/// Put active instances to sleep, if they've been resting long enough        
+/// Static instances are put to sleep right away                              
+void World::UpdateSleeping() {
+   if (not mSleepFrames)
+      return;
+
+   for (Offset slot = 0; slot < mPool.GetActiveCount();) {
+      auto& rest = mPool.mRest[slot];
+      if (not mPool.IsResting(slot, mSleepSpeed))
+         rest = 0;
+      else if (mPool.mStatic[slot] or ++rest >= mSleepFrames) {
+         // The last active slot takes this one's place, so check it    
+         // without advancing                                           
+         Sleep(slot);
+         continue;
+      }
+      ++slot;
+   }
+}
+
+/// Exchange two slots in the instance pool, and in everything that indexes   
+/// it, including the instances that own them                                 
+///   @param a - the first slot                                               
+///   @param b - the second slot                                              
+void World::SwapSlots(Offset a, Offset b) noexcept {
+   if (a == b)
+      return;
+
+   mPool.Swap(a, b);
+   mOctaves.Swap(a, b);
+   mIslands.Swap(a, b);
+   for (auto slot : {a, b}) {
+      mPool.mOwners[slot]->mSlot = slot;
+      if (mPool.mProxy[slot] != Broadphase::InvalidProxy)
+         mBroadphase.SetData(mPool.mProxy[slot], slot);
+   }
+}
+
+/// Move an active instance to the sleeping partition                         
+/// Its remaining velocity is discarded, so that it wakes up at rest          
+///   @param slot - the active slot                                           
+void World::Sleep(Offset slot) noexcept {
+   LANGULUS_ASSUME(DevAssumes, slot < mPool.GetActiveCount(),
+      "Instance is already sleeping");
+   mPool.mVelocity.Set(slot, {});
+   mPool.mPrevious.Set(slot, mPool.mPosition.Get(slot));
+   mPool.mRest[slot] = 0;
+   SwapSlots(slot, --mPool.mActiveCount);
+}
+
+/// Move a sleeping instance to the active partition                          
+/// Static instances can't be woken up                                        
+///   @param slot - the slot inside the instance pool                         
+///   @return the new slot of the instance                                    
+auto World::Wake(Offset slot) noexcept -> Offset {
+   mPool.mRest[slot] = 0;
+   if (slot < mPool.GetActiveCount() or mPool.mStatic[slot])
+      return slot;
+
+   const auto to = mPool.mActiveCount++;
+   SwapSlots(slot, to);
+   return to;
+}
+
+/// Find pairs of solid instances, whose bounds might be overlapping          
+///   @param pairs - [out] pool slots of each pair are appended here          
+void World::FindCandidatePairs(std::vector<Broadphase::Pair>& pairs) const {
+   mBroadphase.FindPairs(pairs);
+}
+
+/// Convert the frustum of a LOD state to planes that the culling kernels use 
+///   @param lod - the lod state                                              
+///   @return the frustum planes                                              
+static auto GetFrustum(const LOD& lod) noexcept -> Culling::Frustum {
+   Culling::Frustum result;
+   for (Offset i = 0; i < Culling::Frustum::Planes; ++i) {
+      const auto& plane = lod.mFrustum.mPlanes[i];
+      result.SetPlane(i, {plane[0], plane[1], plane[2]}, plane[3]);
+   }
+   return result;
+}
+
+/// Cull all instances in the world at once                                   
+/// Octaves below the observer are skipped as a whole. Boxes in the default   
+/// octave are tested in batches, straight from the instance pool, when the   
+/// observer is in the default octave, too. Instances in other octaves, or    
+/// with degenerate scale, are culled one by one with Instance::Cull          
+///   @param lod - the lod state to test                                      
+///   @param visible - [out] one bit per pool slot, set if the instance       
+///      intersects the frustum                                               
+void World::Cull(const LOD& lod, std::vector<Culling::Word>& visible) const {
+   // Number of instances tested in a single chunk - must be a multiple 
+   // of the word size, so that chunks never write to the same word     
+   constexpr Count CullChunk = 16384;
+   static_assert(CullChunk % Culling::WordBits == 0);
+
+   const auto count = mPool.GetCount();
+   visible.assign(Culling::GetWordCount(count), 0);
+   const bool batched = lod.mLevel == Level {};
+   if (batched) {
+      const auto frustum = GetFrustum(lod);
+      const auto bounds = mPool.GetBounds();
+      const auto isa = Integrator::GetBestISA();
+      const auto test = [&](Offset from, Offset to) {
+         Culling::Test(isa, frustum, bounds, from, to, visible.data());
+      };
+
+      if (mParallel)
+         GetProducer()->GetScheduler().ParallelFor(0, count, CullChunk, test);
+      else
+         test(0, count);
+   }
+
+   const auto set = [&](Offset slot, bool value) {
+      const auto bit = Culling::Word {1} << (slot % Culling::WordBits);
+      auto& word = visible[slot / Culling::WordBits];
+      word = value ? word | bit : word & ~bit;
+   };
+
+   const auto observer = OctaveOf(lod.mLevel);
+   mOctaves.ForEach([&](int octave, const OctaveIndex::Bucket& bucket) {
+      if (not OctaveIndex::CanBeVisible(octave, observer)) {
+         // The whole octave is too small to be seen                    
+         if (batched) {
+            for (auto slot : bucket)
+               set(slot, false);
+         }
+         return;
+      }
+
+      for (auto slot : bucket) {
+         // Pool bounds are only valid in the default octave            
+         if (batched and mPool.mLevel[slot] == Level {} and not mPool.mUnbounded[slot])
+            continue;
+         set(slot, not mPool.mOwners[slot]->Cull(lod));
+      }
+   });
+}
+
+/// Cull all instances in the world at once, and gather the visible ones      
+///   @param lod - the lod state to test                                      
+///   @param slots - [out] pool slots of the visible instances are appended,  
+///      in increasing order                                                  
+void World::CollectVisible(const LOD& lod, std::vector<Offset>& slots) const {
+   const std::scoped_lock lock {mVisibleLock};
+   Cull(lod, mVisible);
+
+   for (Offset w = 0; w < mVisible.size(); ++w) {
+      for (auto word = mVisible[w]; word; word &= word - 1)
+         slots.push_back(w * Culling::WordBits + std::countr_zero(word));
+   }
+}
+
+/// Register an instance's dynamic state in the world                         
+///   @param owner - the instance                                             
+///   @param data - the initial state                                         
+///   @return the slot inside the instance pool                               
+auto World::Register(Instance* owner, const Math::TInstance<Vec3>& data) -> Offset {
+   const auto slot = mPool.Allocate(owner);
+   mPool.Load(slot, data);
+   mOctaves.Insert(slot, OctaveOf(data.mLevel));
+   mIslands.Insert(slot, mPool.mStatic[slot]);
+   mAggregates.Invalidate(OctaveOf(data.mLevel));
+
+   // Sleeping instances aren't refitted, so insert the proxy right away
+   RefitProxy(slot, 0);
+   return Wake(slot);
+}
+
+/// Unregister an instance's dynamic state from the world                     
+///   @param slot - the slot inside the instance pool                         
+void World::Unregister(Offset slot) noexcept {
+   // Bonds can't outlive either of their ends                          
+   for (auto bond = mIslands.GetFirst(slot); bond != BondIslands::Invalid;
+             bond = mIslands.GetFirst(slot)) {
+      mIslands.GetOwner(bond)->Detach();
+      mIslands.Unbind(bond);
+   }
+
+   if (mPool.mProxy[slot] != Broadphase::InvalidProxy) {
+      mBroadphase.Remove(mPool.mProxy[slot]);
+      mPool.mProxy[slot] = Broadphase::InvalidProxy;
+   }
+
+   // Move the slot to the end of its partition, and then to the end    
+   // of the pool, so that releasing it doesn't mix the partitions      
+   if (slot < mPool.GetActiveCount()) {
+      SwapSlots(slot, mPool.GetActiveCount() - 1);
+      slot = --mPool.mActiveCount;
+   }
+
+   const Offset last = mPool.GetCount() - 1;
+   SwapSlots(slot, last);
+   mPool.Release(last);
+   mAggregates.Invalidate(mOctaves.GetOctave(last));
+   mOctaves.Remove(last);
+   mIslands.Remove(last);
+}
+
+/// Overwrite an instance's dynamic state, after it was changed from outside  
+/// of the simulation, i.e. by a Move verb. The instance is woken up          
+///   @param slot - the slot inside the instance pool                         
+///   @param data - the new state                                             
+void World::Reload(Offset slot, const Math::TInstance<Vec3>& data) {
+   mPool.Load(slot, data);
+   mIslands.SetAnchor(slot, mPool.mStatic[slot]);
+   MoveToOctave(slot, OctaveOf(data.mLevel));
+   // Static instances are never woken up, and only the points of active
+   // instances are rewritten, so the whole cloud has to be rebuilt     
+   mAggregates.Invalidate(OctaveOf(data.mLevel));
+   RefitProxy(slot, 0);
+   Wake(slot);
+}
+
+/// Add a bond between two instances to the bond islands                      
+///   @param owner - the bond unit                                            
+///   @param a, b - the slots of the bonded instances                         
+///   @return the index of the bond, valid until it is unbound                
+auto World::Bind(Bond* owner, Offset a, Offset b) -> uint32_t {
+   return mIslands.Bind(a, b, owner);
+}
+
+/// Remove a bond from the bond islands                                       
+///   @param bond - the index returned by Bind                                
+void World::Unbind(uint32_t bond) noexcept {
+   mIslands.Unbind(bond);
 }
 
 /// Introduce instances, particles, etc.                                      
@@ -72,4 +683,131 @@ void World::Create(Verb& verb) {
    mParticles.Create(this, verb);
    mBonds.Create(this, verb);
    mFields.Create(this, verb);
+}
+
+/// Get the pool with the dynamic state of all instances in the world         
+///   @return the pool                                                        
+InstancePool& World::GetPool() noexcept {
+   return mPool;
+}
+
+/// Get the instances in the world, bucketed by octave                        
+///   @return the octave index, with slots inside the instance pool           
+auto World::GetOctaves() const noexcept -> const OctaveIndex& {
+   return mOctaves;
+}
+
+/// Get the point clouds of all octaves, as of the last update                
+/// Draw the ones returned by Aggregates::ForEachHidden, instead of the       
+/// instances that Instance::Cull discards for being too small                
+///   @return the point clouds                                                
+auto World::GetAggregates() const noexcept -> const Aggregates& {
+   return mAggregates;
+}
+
+/// Change the way instances are integrated                                   
+/// Both modes give bit-identical results                                     
+///   @param mode - the new update mode                                       
+void World::SetUpdateMode(UpdateMode mode) noexcept {
+   mUpdateMode = mode;
+   VERBOSE_PHYSICS("Integrating with ", mode == UpdateMode::Batched
+      ? Integrator::GetName(Integrator::GetBestISA()) : "Scalar", " kernel");
+}
+
+/// Get the way instances are integrated                                      
+///   @return the update mode                                                 
+auto World::GetUpdateMode() const noexcept -> UpdateMode {
+   return mUpdateMode;
+}
+
+/// Toggle updating on all threads of the physics module                      
+///   @param parallel - whether or not to update in parallel                  
+void World::SetParallel(bool parallel) noexcept {
+   mParallel = parallel;
+}
+
+/// Check if the world updates on all threads of the physics module           
+///   @return true if updating in parallel                                    
+auto World::IsParallel() const noexcept -> bool {
+   return mParallel;
+}
+
+/// Get the wall-clock time the last update took, useful for finding worlds   
+/// that take a disproportionate part of the physics module's update          
+///   @return the duration of the last World::Update                          
+auto World::GetUpdateTime() const noexcept -> std::chrono::nanoseconds {
+   return mUpdateTime;
+}
+
+/// Configure when instances are put to sleep                                 
+///   @param speed - instances slower than this are considered resting        
+///   @param frames - number of consecutive updates an instance has to rest   
+///      before it's put to sleep; zero disables sleeping                     
+void World::SetSleeping(Real speed, Count frames) noexcept {
+   mSleepSpeed = speed;
+   mSleepFrames = frames;
+}
+
+/// Get the number of instances that are integrated on each update            
+///   @return the number of awake instances                                   
+auto World::GetActiveCount() const noexcept -> Count {
+   return mPool.GetActiveCount();
+}
+
+/// Get the number of instances that are skipped on each update               
+///   @return the number of sleeping and static instances                     
+auto World::GetSleepingCount() const noexcept -> Count {
+   return mPool.GetCount() - mPool.GetActiveCount();
+}
+
+/// Switch between fixed and variable time steps                              
+/// In fixed step mode, the elapsed time is accumulated and consumed in       
+/// steps of the same size, and transforms are interpolated between the last  
+/// two steps, so that the simulation rate doesn't depend on the frame rate   
+///   @param step - the fixed step in seconds, zero to step with the elapsed  
+///      time of each update                                                  
+///   @param maxSubsteps - the maximum number of steps in a single update     
+void World::SetFixedStep(Real step, Count maxSubsteps) noexcept {
+   LANGULUS_ASSUME(UserAssumes, maxSubsteps > 0, "Bad substep limit");
+   mFixedStep = step;
+   mMaxSubsteps = maxSubsteps;
+   mAccumulator = 0;
+   mInterpolation = 1;
+
+   // Nothing to interpolate from, until the first step                 
+   mPool.SavePrevious(0, mPool.GetCount());
+}
+
+/// Get the fixed time step                                                   
+///   @return the step in seconds, or zero if stepping with elapsed time      
+auto World::GetFixedStep() const noexcept -> Real {
+   return mFixedStep;
+}
+
+/// Get how far the accumulated time is between the last two fixed steps      
+///   @return zero at the previous step, one at the last step                 
+auto World::GetInterpolation() const noexcept -> Real {
+   return mInterpolation;
+}
+
+/// Get the statistics of the last bond solve, over all islands               
+///   @return the number of solved bonds, the most colours and iterations     
+///      of any island, and the largest difference between a bond's length    
+///      and its rest length                                                  
+auto World::GetBondStats() const noexcept -> const BondSolver::Stats& {
+   return mBondStats;
+}
+
+/// Get the table with the ends and parameters of all bonds, grouped in       
+/// islands as of the last update                                             
+///   @return the bond table                                                  
+auto World::GetBondIslands() noexcept -> BondIslands& {
+   return mIslands;
+}
+
+/// Get the table with the ends and parameters of all bonds, grouped in       
+/// islands as of the last update                                             
+///   @return the bond table                                                  
+auto World::GetBondIslands() const noexcept -> const BondIslands& {
+   return mIslands;
 }
\ No newline at end of file
@@ -9,8 +9,12 @@
 #include "Instance.hpp"
 #include "Particles.hpp"
 #include "Bond.hpp"
+#include "BondSolver.hpp"
 #include "Field.hpp"
+#include "Aggregates.hpp"
 #include <Langulus/Verbs/Create.hpp>
+#include <chrono>
+#include <mutex>
 
 
 ///                                                                           
@@ -24,7 +28,40 @@ struct Euclidean::World final : A::World, ProducedFrom<Physics> {
    LANGULUS_BASES(A::World);
    LANGULUS_VERBS(Verbs::Create);
 
+   /// How instances are integrated on each update                            
+   enum class UpdateMode {
+      // One instance at a time                                         
+      Scalar,
+      // Several instances per instruction, using the widest            
+      // instruction set that the CPU supports at runtime               
+      Batched
+   };
+
 private:
+   // Dynamic state of all instances, kept contiguous so that           
+   // integration streams through memory.                               
+   // Declared first, so that it outlives everything that indexes it    
+   InstancePool mPool;
+   // Fat bounding boxes of all solid instances, used to find pairs of  
+   // instances that might be colliding, without testing every pair     
+   Broadphase mBroadphase;
+   // Sleeping proxies touched by reinserted ones, during a refit       
+   std::vector<Broadphase::Proxy> mTouched;
+   // Pool slots, bucketed by the octave of their level, so that whole  
+   // octaves can be skipped when culling from a higher octave          
+   OctaveIndex mOctaves;
+   // A point cloud for each octave, so that instances too small to be  
+   // drawn one by one can be drawn as points, a whole octave at once   
+   Aggregates mAggregates;
+   // Visibility of each slot, gathered when collecting visible ones.   
+   // Renderers may cull from several threads, so they take turns       
+   mutable std::mutex mVisibleLock;
+   mutable std::vector<Culling::Word> mVisible;
+   // Ends and parameters of all bonds, packed in columns, and grouped  
+   // into islands that are connected through the instances they move,  
+   // so that each island is solved on its own                          
+   BondIslands mIslands;
+
    // Particle systems are optimized for large quantity of              
    // instances that share the same physical behavior                   
    TFactory<Particles> mParticles;
@@ -34,11 +71,30 @@ private:
    TFactory<Instance> mInstances;
    // Forces that act upon specific instances                           
    // Can be used to compose complex multi-instance/entity objects,     
-   // whose parts have different behaviors like ragdolls and structures 
+   // whose parts have different behaviors like ragdolls and structures.
+   // Units are only handles into mIslands                              
    TFactory<Bond> mBonds;
+   // Solves islands large enough to be split between all threads       
+   BondSolver mBondSolver;
+   // Islands solved on the last update, and the results of each        
+   std::vector<Offset> mAwakeIslands;
+   std::vector<BondSolver::Stats> mIslandStats;
+   BondSolver::Stats mBondStats;
+   // Awake islands too small to be split, solved one per thread        
+   std::vector<Offset> mSmallIslands;
    // Heat, fluid, electromagnetic, whatever - fields describe          
    // behavior over a volume, affecting particles and instances         
    TFactory<Field> mFields;
+   // Instances inside the volume of the field being applied, their keys
+   // along the field's curve, their sorted positions and samples, which
+   // of them are awake, and the sleeping ones that the field wakes up  
+   std::vector<Offset> mFieldSlots;
+   std::vector<uint64_t> mFieldKeys;
+   std::vector<uint32_t> mFieldOrder;
+   Morton::Scratch mFieldScratch;
+   std::vector<Real> mFieldSamples[6];
+   std::vector<uint8_t> mFieldMoving;
+   std::vector<std::pair<Broadphase::Proxy, Offset>> mFieldWoken;
 
 
    // Lowest world volume limit. Zeroes mean that the smallest unit     
@@ -59,11 +115,76 @@ private:
    // volume of the initial adaptive grid.                              
    Adaptive<Vec3> mLimit;
 
+   // How instances are integrated                                      
+   UpdateMode mUpdateMode = UpdateMode::Scalar;
+   // Whether updates are split in chunks and executed on all threads   
+   bool mParallel = false;
+   // Wall-clock time the last update took                              
+   std::chrono::nanoseconds mUpdateTime {};
+   // Instances slower than this, for mSleepFrames consecutive updates, 
+   // are put to sleep and no longer integrated, until woken up         
+   Real mSleepSpeed = Real(0.01);
+   // Zero disables sleeping                                            
+   Count mSleepFrames = 60;
+
+   // Size of a single simulation step, zero to step with the elapsed   
+   // time of each update                                               
+   Real mFixedStep = 0;
+   // Limits the steps in a single update, so that a slow update doesn't
+   // cause even more steps in the next one                             
+   Count mMaxSubsteps = 8;
+   // Elapsed time that wasn't simulated yet                            
+   Real mAccumulator = 0;
+   // How far the accumulated time is between the last two steps        
+   Real mInterpolation = 1;
+
+   void Step(Real, Integrator::ISA);
+   void UpdateParallel(Real, Integrator::ISA);
+   void ApplyFields(Real, Scheduler* = nullptr);
+   void SolveBonds(Real, Scheduler* = nullptr);
+   void UpdateBroadphase(Real);
+   void UpdateOctaves();
+   void UpdateAggregates();
+   void MoveToOctave(Offset, int);
+   void UpdateSleeping();
+   auto RefitProxy(Offset, Real) -> bool;
+   void SwapSlots(Offset, Offset) noexcept;
+   void Sleep(Offset) noexcept;
+
 public:
    World(Physics*, const Many&);
 
    void Refresh();
    void Update();
+   void Advance(Real);
    void Create(Verb&);
    void Teardown();
+
+   auto Register(Instance*, const Math::TInstance<Vec3>&) -> Offset;
+   void Unregister(Offset) noexcept;
+   void Reload(Offset, const Math::TInstance<Vec3>&);
+   auto Bind(Bond*, Offset a, Offset b) -> uint32_t;
+   void Unbind(uint32_t) noexcept;
+   auto Wake(Offset) noexcept -> Offset;
+   void FindCandidatePairs(std::vector<Broadphase::Pair>&) const;
+   void Cull(const LOD&, std::vector<Culling::Word>&) const;
+   void CollectVisible(const LOD&, std::vector<Offset>&) const;
+
+   auto GetPool() noexcept -> InstancePool&;
+   auto GetOctaves() const noexcept -> const OctaveIndex&;
+   auto GetAggregates() const noexcept -> const Aggregates&;
+   void SetUpdateMode(UpdateMode) noexcept;
+   auto GetUpdateMode() const noexcept -> UpdateMode;
+   void SetParallel(bool) noexcept;
+   auto IsParallel() const noexcept -> bool;
+   auto GetUpdateTime() const noexcept -> std::chrono::nanoseconds;
+   void SetSleeping(Real speed, Count frames) noexcept;
+   void SetFixedStep(Real step, Count maxSubsteps = 8) noexcept;
+   auto GetFixedStep() const noexcept -> Real;
+   auto GetInterpolation() const noexcept -> Real;
+   auto GetActiveCount() const noexcept -> Count;
+   auto GetSleepingCount() const noexcept -> Count;
+   auto GetBondStats() const noexcept -> const BondSolver::Stats&;
+   auto GetBondIslands() noexcept -> BondIslands&;
+   auto GetBondIslands() const noexcept -> const BondIslands&;
 };
\ No newline at end of file
@@ -30,13 +30,13 @@ namespace AMR
    };
 
 
-   /// A D-dimensional array                                                  
-   /// interfaces a part of a buffer???
+   /// A D-dimensional array, interfacing a region of a buffer                
    ///   @tparam T - the type of contained data                               
    ///   @tparam D - the number of dimensions                                 
    template<CT::Data T, u8 D>
    struct Array {
       LANGULUS(TYPED) T;
+      static constexpr u8 Dimension = D;
       using Vu64 = TVector<u64, D>;
       using Vi64 = TVector<i64, D>;
 
@@ -61,29 +61,31 @@ namespace AMR
       auto operator[](const Vu64& coords) const -> T const&;
       auto operator[](const Vu64& coords)       -> T&;
 
-      /// @brief ??????
+      auto indexOf(const Vu64& coords) const noexcept -> u64;
+      auto getStride(u8 dimension) const noexcept -> u64;
+      auto data() const noexcept -> T*;
+
+      /// Accesses the array relative to a base cell, used by grids to        
+      /// upsample and downsample between levels                              
       struct Getter {
+         static constexpr u8 Dimension = D;
+
          Array&     mArray;
          const Vu64 mBase;
 
          template<class...XS>
-         auto operator()(i64 x1, XS...xs) const -> const T& {
+         auto operator()(i64 x1, XS...xs) const -> T& {
             return mArray[mBase + Vi64 {x1, xs...}];
          }
 
-         template<class...XS>
-         auto operator()(i64 x1, XS...xs) -> T& {
-            return mArray[mBase + Vi64 {x1, xs...}];
+         auto operator[](const Vi64& offset) const -> T& {
+            return mArray[mBase + offset];
          }
       };
 
       auto getter(const Vu64& base) -> Getter {
          return Getter {*this, base};
       }
-
-      auto getter(const Vu64& base) const -> const Getter {
-         return Getter {*this, base};
-      }
    };
 
 } // namespace AMR
@@ -22,7 +22,7 @@ namespace AMR
          bufferSize *= static_cast<Offset>(mSize[i]);
       }
 
-      mData = new T[bufferSize];
+      mData = new T[bufferSize] {};
    }
 
    /// Construct a buffer interface array                                     
@@ -38,30 +38,49 @@ namespace AMR
       // Calculate the 1D offset into mData inside the buffer           
       mOffset = mPosition[0];
       for (u8 i = 0; i < D - 1; ++i)
-         mOffset += mSize[i] * mPosition[i + 1];
+         mOffset += mPosition[i + 1] * mBuffer->mStride[i];
    }
 
    /// Create both a buffer and an array interface for it with single call    
    ///   @param size - the size of the buffer and array                       
    TME()::createWithBuffer(const Vu64& size) -> Array {
-      return {Ref<Buffer<T, D>>{}.New(size), 0, size};
+      Ref<Buffer<T, D>> buffer;
+      buffer.New(size);
+      return {buffer, 0, size};
    }
 
-   /// Get the T at the given D-dimensional array coordinates                 
-   ///   @param coords - the D-dimensional coordinates                        
-   ///   @return a reference to the contained data                            
-   TME()::operator[](const Vu64& coords) -> T& {
-      // Get the absolute index in the mData array of the buffer        
+   /// Get the index of an element inside the whole buffer                    
+   ///   @param coords - the D-dimensional array coordinates                  
+   ///   @return the absolute index in the mData array of the buffer          
+   TME()::indexOf(const Vu64& coords) const noexcept -> u64 {
       auto index = mOffset + coords[0];
       for (u8 i = 0; i < D - 1; ++i)
          index += coords[i + 1] * mBuffer->mStride[i];
+      return index;
+   }
+
+   /// Get the distance between consecutive elements along a dimension        
+   ///   @param dimension - the dimension                                     
+   ///   @return the distance, in elements                                    
+   TME()::getStride(u8 dimension) const noexcept -> u64 {
+      return dimension == 0 ? 1 : mBuffer->mStride[dimension - 1];
+   }
 
-      // Return the data                                                
-      return mBuffer->mData[index];
+   /// Get the contents of the whole buffer, index with indexOf()             
+   ///   @return the buffer's data                                            
+   TME()::data() const noexcept -> T* {
+      return mBuffer->mData;
+   }
+
+   /// Get the T at the given D-dimensional array coordinates                 
+   ///   @param coords - the D-dimensional coordinates                        
+   ///   @return a reference to the contained data                            
+   TME()::operator[](const Vu64& coords) -> T& {
+      return mBuffer->mData[indexOf(coords)];
    }
 
    TME()::operator[](const Vu64& coords) const -> T const& {
-      return const_cast<Array*>(this)->operator[](coords);
+      return mBuffer->mData[indexOf(coords)];
    }
 
 } // namespace AMR
@@ -12,10 +12,12 @@ namespace AMR
       }, items);
    }
 
+   /// Iterates dimension M-1, so that the first dimension, which is the      
+   /// contiguous one inside buffers, is iterated innermost                   
    template<u8 N, u8 M>
    struct LoopImpl {
       using Vu64 = TVector<u64, N>;
-      static constexpr u8 R = N - M;
+      static constexpr u8 R = M - 1;
 
       static void run(const Vu64& from, const Vu64& to, auto&& body, Vu64& i) {
          for (i[R] = from[R]; i[R] < to[R]; ++i[R])
@@ -2,7 +2,7 @@
 #include "Buffer.hpp"
 #include "Control.hpp"
 #include "Util.hpp"
-#include <vector>
+#include <tuple>
 
 
 namespace AMR
@@ -23,9 +23,7 @@ namespace AMR
    template<class T>
    struct GridConfig;
 
-   template<Config> struct MeshHelper;
    template<Config> struct Mesh;
-   template<Config> struct RefinePlan;
    template<Config> struct Node;
    template<Config> struct DataView;
    template<Config> struct Tree;
@@ -33,63 +31,94 @@ namespace AMR
 
    /// Mesh configuration                                                     
    ///   @tparam D - number of dimensions                                     
-   ///   @tparam S - size of block ???
+   ///   @tparam S - number of cells along each side of a block               
    ///   @tparam G... - used grids configurations                             
    template<u8 D, u64 S, Grid...G>
    struct MeshConfig {
+      static_assert(S > 0 and S % 2 == 0, "Blocks must split in halves");
+
       static constexpr bool CTTI_MeshConfigTag = true;
       static constexpr u8  Dimension = D;
       static constexpr u64 BlockSize = S;
+      // Each block is surrounded by a layer of halo cells, that mirror 
+      // the neighbouring blocks after synchronization                  
+      static constexpr u64 Halo = 1;
+      static constexpr u64 BlockExtent = S + 2 * Halo;
 
       using Vu64    = TVector<u64, Dimension>;
       using Vi64    = TVector<i64, Dimension>;
-      using Grids   = Types<G...>;
-      using Datas   = LangulusTypegen(Grids, ([]<class T>{ return TypeOf<T>{}; }));
-      using Arrays  = LangulusTypegen(Datas, ([]<class T>{ return Types<Array<T, D>> {}; }));
-      using Buffers = LangulusTypegen(Datas, ([]<class T>{ return Ref<Buffer<T, D>> {}; }));
+      using Grids   = std::tuple<G...>;
+      using Arrays  = std::tuple<Array<TypeOf<G>, D>...>;
+      using Buffers = std::tuple<Ref<Buffer<TypeOf<G>, D>>...>;
+
+      /// The type of data in a grid                                          
+      template<Index64 I>
+      using Data = TypeOf<std::tuple_element_t<I, Grids>>;
 
-      static auto createBuffers(const Vu64& size) -> Buffers::Tuple;
+      static auto createBuffers(const Vu64& size) -> Buffers;
+      static auto createArrays(const Vu64& size) -> Arrays;
+      static void forEachGrid(auto&&);
    };
 
 
    /// Grid configuration                                                     
    /// Used as base to classes that implement upsample/downsample             
-   ///   @tparam T - type of contained data?                                  
+   ///   @tparam T - type of contained data                                   
    template<class T>
    struct GridConfig {
       static constexpr bool CTTI_GridConfigTag = true;
       LANGULUS(TYPED) T;
 
-      static void upsample(auto src, auto dst) {
-         static_assert(false, "You have to implement this");
+      static void upsample(auto src, auto) {
+         static_assert(sizeof(src) == 0, "You have to implement this");
       }
-      static void downsample(auto src, auto dst) {
-         static_assert(false, "You have to implement this");
+      static void downsample(auto src, auto) {
+         static_assert(sizeof(src) == 0, "You have to implement this");
       }
    };
 
 
+   /// A grid that copies a coarse cell to all the fine cells it covers, and  
+   /// averages fine cells into the coarse cell that covers them              
+   ///   @tparam T - type of contained data                                   
+   template<class T>
+   struct AverageGrid : GridConfig<T> {
+      static void upsample(auto src, auto dst);
+      static void downsample(auto src, auto dst);
+   };
+
+
    /// A node                                                                 
+   /// Each node owns a block of BlockSize cells along each dimension, plus   
+   /// the halo around them. Leaf nodes hold the finest data, the rest hold   
+   /// their children's data, downsampled                                     
    ///   @tparam C - the mesh configuration                                   
    template<Config C>
    struct Node {
       static constexpr auto Dimension = C::Dimension;
       using Arrays     = typename C::Arrays;
-      using Buffers    = typename C::Buffers;
       using Vu64       = typename C::Vu64;
+      using Vi64       = typename C::Vi64;
       using NodeArray  = Array<Node*, Dimension>;
 
       bool isLeaf = true;
       NodeArray children;
       Node* parent = nullptr;
-      Arrays::Tuple data;
+      Arrays data;
       Action action = Action::None;
+      // Whether the data wasn't computed - it's empty, or came from    
+      // another level by a split or merge. Cleared by whoever computes 
+      // the data                                                       
+      bool stale = true;
       u32 level = 0;
+      // Index of the node among its siblings, zero or one per dimension
       Vu64 index = 0;
-      std::vector<RefinePlan<C>*> refinePlan;
+      // Offset of the node's first cell, in cells of the node's level  
+      Vu64 position = 0;
+      // Nodes around this one, and this one in the middle. Neighbours  
+      // are of the same level, or are coarser leaves, where the mesh   
+      // isn't as refined. Missing neighbours are outside the mesh      
       NodeArray adjacent;
-      bool sync = false;
-      bool propagate = false;
 
    public:
       Node(const Node&) = delete;
@@ -98,10 +127,11 @@ namespace AMR
       Node& operator = (const Node&) = delete;
       Node& operator = (Node&&) = delete;
 
-      Node(Node*, const Buffers::Tuple&, const Vu64& position, const Vu64& indices);
+      Node(Node*, const Vu64& index);
       Node();
+      ~Node();
 
-      void split(const Buffers::Tuple&, const Vu64& position);
+      void split();
       void merge();
 
       template<Grid, Index64>
@@ -112,30 +142,19 @@ namespace AMR
       void downsampleGrid();
       void downsampleAll();
 
-      template<Grid, Index64>
-      void upsampleGridRange(const Vu64& fromSrc, const Vu64& toSrc, const Vu64& toDst, Node* child);
-      void upsampleAllRange (const Vu64& fromSrc, const Vu64& toSrc, const Vu64& toDst, const Vu64& child);
-
       void updateAdjacency();
-      void calculateRefinePlan();
-      void calculateRefinePlanRecursive();
-
-      void restructure();
+      auto restructure() -> bool;
 
       void propagateUp();
-      void propagateDown();
 
-      static bool isInSameBuffer  (Node* node1, Node* node2);
-      template<Index64>
-      static void exchangeHaloGrid(Node* node1, Node* node2, const Vu64& fromSrc, const Vu64& toSrc, const Vu64& fromDst);
-      static void exchangeHaloAll (Node* node1, Node* node2, const Vu64& fromSrc, const Vu64& toSrc, const Vu64& fromDst);
       void synchronize();
       void synchronizeRecursive();
       void applyKernel(auto&&);
+      void forEachLeaf(auto&&);
    };
 
 
-   ///                                                                        
+   /// Access to the cells around a single cell, passed to kernels            
    template<Config C>
    struct DataView {
       static constexpr auto Dimension = C::Dimension;
@@ -158,65 +177,35 @@ namespace AMR
       }
 
       template<Index32 I, class...XS>
-      auto get(i64 x1, XS...xs) -> typename C::Datas::template At<I>& {
+      auto get(i64 x1, XS...xs) -> typename C::template Data<I>& {
          return std::get<I>(node.data)[base + Vi64 {x1, xs...}];
       }
    };
-   
-
-   ///                                                                        
-   template<Config C>
-   struct RefinePlan {
-      static constexpr auto Dimension = C::Dimension;
-      using Vu64 = typename C::Vu64;
-      using NodeArray = Array<Node<C>*, Dimension>;
-
-      u32  level = 0;
-      Vu64 position = 0;
-      Vu64 size = 0;
-      NodeArray nodes;
-      bool propagate = true;
-
-   public:
-      RefinePlan(Node<C>*);
-      RefinePlan();
-
-      void propagateUp(const Vu64& index, u32 currentLevel);
-      bool merge(RefinePlan*, u32 level);
-   };
-
-
-
-
-
-
-
-
-
-
-
 
 
+   /// A hierarchy of nodes, refined and coarsened by the actions kernels     
+   /// request on its leaves                                                  
    template<Config C>
    struct Tree {
       static constexpr auto Dimension = C::Dimension;
       using Vu64 = typename C::Vu64;
 
-      Mesh<C>* mesh;
-      Vu64  selfPosition;
       Node<C>* root;
 
    public:
       Tree(const Tree&) = delete;
       Tree(Tree&&) = delete;
-      Tree(Mesh<C>*, Vu64 selfPosition);
+      Tree();
+      ~Tree();
 
       Tree& operator = (const Tree&) = delete;
       Tree& operator = (Tree&&) = delete;
 
-      void restructure();
+      void clear();
+      auto restructure() -> bool;
       void synchronize();
       void applyKernel(auto&&);
+      void forEachLeaf(auto&&) const;
    };
 
    template<Config C>
@@ -233,4 +222,6 @@ namespace AMR
       //void applyKernel(auto&&);
    };
 
-} // namespace AMR
\ No newline at end of file
+} // namespace AMR
+
+#include "Mesh.inl"
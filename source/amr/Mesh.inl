@@ -2,6 +2,8 @@
 #include "Mesh.hpp"
 #include "Control.hpp"
 #include "Util.hpp"
+#include <algorithm>
+#include <utility>
 
 
 namespace AMR
@@ -11,50 +13,98 @@ namespace AMR
    ///   @param size - the dynamic size of the buffers                        
    ///   @return a tuple with all allocated buffers                           
    template<u8 D, u64 S, Grid...G>
-   auto MeshConfig<D, S, G...>::createBuffers(const Vu64& size) -> Buffers::Tuple {
-      return Buffers::GenerateData([&]<class T> {
-         return T {}.New(size);
+   auto MeshConfig<D, S, G...>::createBuffers(const Vu64& size) -> Buffers {
+      Buffers buffers;
+      forEachGrid([&]<Grid, Index64 I>() {
+         std::get<I>(buffers).New(size);
       });
+      return buffers;
+   }
+
+   /// Allocate a buffer for each grid, and interface all of it               
+   ///   @param size - the dynamic size of the buffers                        
+   ///   @return a tuple with an array for each grid                          
+   template<u8 D, u64 S, Grid...G>
+   auto MeshConfig<D, S, G...>::createArrays(const Vu64& size) -> Arrays {
+      return Arrays {Array<TypeOf<G>, D>::createWithBuffer(size)...};
+   }
+
+   /// Invoke a function template for each grid, in order                     
+   ///   @param call - a template lambda, taking the grid and its index       
+   template<u8 D, u64 S, Grid...G>
+   void MeshConfig<D, S, G...>::forEachGrid(auto&& call) {
+      [&]<Index64...I>(std::integer_sequence<Index64, I...>) {
+         (call.template operator()<std::tuple_element_t<I, Grids>, I>(), ...);
+      }(std::make_integer_sequence<Index64, sizeof...(G)> {});
+   }
+
+   /// Copy a coarse cell to all the fine cells it covers                     
+   ///   @param src - the coarse cell                                         
+   ///   @param dst - the first of the fine cells                             
+   template<class T>
+   void AverageGrid<T>::upsample(auto src, auto dst) {
+      constexpr auto D = decltype(src)::Dimension;
+      Loop<D>(0, 2, [&](const auto& it) {
+         dst[it] = src[0];
+      });
+   }
+
+   /// Average fine cells into the coarse cell that covers them               
+   ///   @param src - the first of the fine cells                             
+   ///   @param dst - the coarse cell                                         
+   template<class T>
+   void AverageGrid<T>::downsample(auto src, auto dst) {
+      constexpr auto D = decltype(src)::Dimension;
+      T sum {};
+      Loop<D>(0, 2, [&](const auto& it) {
+         sum += src[it];
+      });
+      dst[0] = sum / static_cast<T>(branch_factor(D));
    }
 
    /// Child node constructor                                                 
-   /// Relies on externally allocated buffers                                 
    ///   @param parent - the parent node (from the upper level)               
-   ///   @param buffers - the preallocated buffers                            
-   ///   @param position - starting positions in buffers                      
-   ///   @param index ??
+   ///   @param index - index of the child, zero or one along each dimension  
    template<Config C>
-   Node<C>::Node(Node* parent, const Buffers::Tuple& buffers, const Vu64& position, const Vu64& index)
+   Node<C>::Node(Node* parent, const Vu64& index)
       : children(NodeArray::createWithBuffer(2))
       , parent(parent)
-      , data(mapTuple(buffers, [&]<class T>(const T& buffer) {
-            return Array<TypeOf<TypeOf<T>>, Dimension>(buffer, position, C::BlockSize);
-         }))
-      , level(parent? parent->level + 1 : 0)
+      , data(C::createArrays(C::BlockExtent))
+      , level(parent->level + 1)
       , index(index)
+      , position(parent->position * 2 + index * C::BlockSize)
       , adjacent(NodeArray::createWithBuffer(3)) {}
 
    /// Root node construction                                                 
-   /// Allocates the first buffers itself                                     
    template<Config C>
    Node<C>::Node()
       : children(NodeArray::createWithBuffer(2))
-      , data(mapTuple(C::createBuffers(C::BlockSize), [&]<class T>(const T& buffer) {
-            return Array<TypeOf<TypeOf<T>>, Dimension>(buffer, 0, C::BlockSize);
-         }))
+      , data(C::createArrays(C::BlockExtent))
       , adjacent(NodeArray::createWithBuffer(3)) {}
 
-   /// Upsample grids in all dimensions                                       
+   /// Node destruction, destroys all children, too                           
+   template<Config C>
+   Node<C>::~Node() {
+      if (isLeaf)
+         return;
+
+      Loop<Dimension>(0, 2, [&](const auto& it) {
+         delete children[it];
+      });
+   }
+
+   /// Upsample a grid into all children                                      
    template<Config C> template<Grid G, Index64 I>
    void Node<C>::upsampleGrid() {
       LANGULUS_ASSUME(DevAssumes, not isLeaf, "Node is a leaf node");
+      constexpr u64 Half = C::BlockSize / 2;
+      auto& source = std::get<I>(data);
       Loop<Dimension>(0, 2, [&](const auto& it1) {
-         Loop<Dimension>(0, C::BlockSize / 2, [&](const auto& it2) {
-            const auto src = it2 + C::BlockSize / 2 * it1;
-            const auto dst = 2ul * it2;
+         auto& target = std::get<I>(children[it1]->data);
+         Loop<Dimension>(0, Half, [&](const auto& it2) {
             G::upsample(
-               std::get<I>(data).getter(src),
-               std::get<I>(children[it1]->data).getter(dst)
+               source.getter(it2 + it1 * Half + C::Halo),
+               target.getter(it2 * 2 + C::Halo)
             );
          });
       });
@@ -62,41 +112,23 @@ namespace AMR
 
    template<Config C>
    void Node<C>::upsampleAll() {
-      C::Grids::ForEachIndexed([&]<Grid G, auto INDEX>() {
+      C::forEachGrid([&]<Grid G, Index64 INDEX>() {
          upsampleGrid<G, INDEX>();
       });
    }
 
-   template<Config C> template<Grid G, Index64 I>
-   void Node<C>::upsampleGridRange(const Vu64& fromSrc, const Vu64& toSrc, const Vu64& toDst, Node* child) {
-      LANGULUS_ASSUME(DevAssumes, not isLeaf, "Node is a leaf node");
-      Loop<Dimension>(fromSrc, toSrc, [&](const auto& it) {
-         const auto dst = toDst + (it - fromSrc) * 2;
-         G::upsample(
-            std::get<I>(data).getter(it),
-            std::get<I>(child->data).getter(dst)
-         );
-      });
-   }
-
-   template<Config C>
-   void Node<C>::upsampleAllRange(const Vu64& fromSrc, const Vu64& toSrc, const Vu64& toDst, const Vu64& child) {
-      auto childNode = children[child];
-      C::Grids::ForEachIndexed([&]<Grid G, auto INDEX>() {
-         upsampleGridRange<G, INDEX>(fromSrc, toSrc, toDst, childNode);
-      });
-   }
-
+   /// Downsample a grid from all children                                    
    template<Config C> template<Grid G, Index64 I>
    void Node<C>::downsampleGrid() {
       LANGULUS_ASSUME(DevAssumes, not isLeaf, "Node is a leaf node");
+      constexpr u64 Half = C::BlockSize / 2;
+      auto& target = std::get<I>(data);
       Loop<Dimension>(0, 2, [&](const auto& it1) {
-         Loop<Dimension>(0, C::BlockSize / 2, [&](const auto& it2) {
-            const auto dst = it2 + C::BlockSize / 2 * it1;
-            const auto src = 2 * it2;
+         auto& source = std::get<I>(children[it1]->data);
+         Loop<Dimension>(0, Half, [&](const auto& it2) {
             G::downsample(
-               std::get<I>(children[it1]->data).getter(src),
-               std::get<I>(data).getter(dst)
+               source.getter(it2 * 2 + C::Halo),
+               target.getter(it2 + it1 * Half + C::Halo)
             );
          });
       });
@@ -104,42 +136,34 @@ namespace AMR
 
    template<Config C>
    void Node<C>::downsampleAll() {
-      C::Grids::ForEachIndexed([&]<Grid G, auto INDEX>() {
+      C::forEachGrid([&]<Grid G, Index64 INDEX>() {
          downsampleGrid<G, INDEX>();
       });
    }
 
+   /// Find the neighbours of this node and of all its descendants            
+   /// The parent's neighbours must be up to date                             
    template<Config C>
    void Node<C>::updateAdjacency() {
       Loop<Dimension>(0, 3, [&](const auto& it) {
-         adjacent[it] = nullptr;
-      });
-
-      adjacent[1] = this;
-
-      if (parent) {
-         sync = false;
-         propagate = false;
-         TVector<i64, 6> t {0, 1, 1, 1, 1, 2};
-
-         Loop<Dimension>(0, 3, [&](const auto& it) {
-            Node*& adj = adjacent[it];
-            auto x = index * 3 + it;
+         Node* adj = nullptr;
+         if (parent) {
+            // The neighbour is a child of the parent's neighbour, or of
+            // the parent itself, or that node, if it's a leaf          
+            Vu64 x;
             for (u8 i = 0; i < Dimension; ++i)
-               x[i] = t[x[i]];
+               x[i] = (index[i] + it[i] + 1) / 2;
 
             adj = parent->adjacent[x];
-
             if (adj and not adj->isLeaf)
-               adj = adj->children[(index + it) % 2];
+               adj = adj->children[(index + it + 1) % 2];
+         }
 
-            if (adj and (adj->isLeaf or isLeaf))
-               sync = true;
-         });
+         adjacent[it] = adj;
+      });
 
-         if (parent->sync or parent->propagate)
-            propagate = true;
-      }
+      if (not parent)
+         adjacent[Vu64 {1}] = this;
 
       if (not isLeaf) {
          Loop<Dimension>(0, 2, [&](const auto& it) {
@@ -148,84 +172,21 @@ namespace AMR
       }
    }
 
+   /// Split a leaf into children, upsampling its data into them              
    template<Config C>
-   RefinePlan<C>::RefinePlan(Node<C>* node)
-      : level(node->level)
-      , size(1)
-      , nodes(NodeArray::createWithBuffer(size)) {
-      nodes[position] = node;
-   }
-
-   template<Config C>
-   RefinePlan<C>::RefinePlan()
-      : nodes(NodeArray::createWithBuffer(size)) {}
-
-   template<Config C>
-   void Node<C>::calculateRefinePlan() {
-      if (isLeaf) {
-         if (not (action & Action::Refine))
-            return;
-
-         refinePlan.emplace_back(new RefinePlan(this));
-      }
-      else {
-         Loop<Dimension>(0, 2, [&](const auto& it) {
-            auto child = children[it];
-            for (auto rpit = child->refinePlan.begin();
-               rpit != child->refinePlan.end();) {
-               if ((*rpit)->propagate) {
-                  (*rpit)->propagateUp(it, level);
-                  refinePlan.push_back(std::move(*rpit));
-                  rpit = child->refinePlan.erase(rpit);
-               }
-               else rpit++;
-            }
-         });
-
-         bool changed;
-         do {
-            changed = false;
-            for (size_t pi = 0; pi < refinePlan.size(); ++pi) {
-               auto& plan1 = refinePlan[pi];
-               for (size_t pj = pi + 1; pj < refinePlan.size(); ++pj) {
-                  auto& plan2 = refinePlan[pj];
-                  if (plan1->merge(plan2, level)) {
-                     delete refinePlan[pj];
-                     refinePlan.erase(refinePlan.begin() + pj);
-                  }
-
-                  changed = true;
-                  pj--;
-               }
-            }
-         } while (changed);
-      }
-   }
-
-   template<Config C>
-   void Node<C>::calculateRefinePlanRecursive() {
-      if (not isLeaf) {
-         Loop<Dimension>(0, 2, [&](const auto& it) {
-            children[it]->calculateRefinePlanRecursive();
-         });
-      }
-
-      calculateRefinePlan();
-   }
-
-   template<Config C>
-   void Node<C>::split(const Buffers::Tuple& buffers, const Vu64& position) {
+   void Node<C>::split() {
       LANGULUS_ASSUME(DevAssumes, isLeaf, "Node isn't a leaf node");
 
       Loop<Dimension>(0, 2, [&](const auto& it) {
-         auto childPosition = position + it * C::BlockSize;
-         children[it] = new Node(this, buffers, childPosition, it);
+         children[it] = new Node(this, it);
       });
 
       isLeaf = false;
       upsampleAll();
    }
 
+   /// Merge all children, downsampling their data first - the node becomes   
+   /// a stale leaf                                                           
    template<Config C>
    void Node<C>::merge() {
       LANGULUS_ASSUME(DevAssumes, not isLeaf, "Node is a leaf node");
@@ -239,140 +200,139 @@ namespace AMR
       });
 
       isLeaf = true;
+      stale = true;
    }
 
+   /// Carry out the actions requested on leaves - split the ones that asked  
+   /// for refinement, and merge nodes whose children all asked for           
+   /// coarsening. Nodes change by at most one level, and all actions are     
+   /// reset. Adjacency must be updated afterwards                            
+   ///   @return true if any node was split or merged                         
    template<Config C>
-   void executeRefinePlan(const RefinePlan<C>& plan) {
-      auto size = plan.size * C::BlockSize * 2 + 2;
-      auto buffers = C::createBuffers(size);
-      Loop<C::Dimension>(0, plan.size, [&](const auto& it) {
-         plan.nodes[it]->split(buffers, it);
-      });
-   }
-
-   template<Config C>
-   void Node<C>::restructure() {
-      if (not isLeaf) {
-         int action = Action::Coarsen;
-         Loop<Dimension>(0, 2, [&](const auto& it) {
-            action &= children[it]->action;
-         });
-
-         if (action & Action::Coarsen) {
-            merge();
-            return;
-         }
-
-         Loop<Dimension>(0, 2, [&](const auto& it) {
-            action &= children[it]->action;
-         });
-      }
-
-      for (size_t i = 0; i < refinePlan.size(); ++i)
-         executeRefinePlan<C>(*refinePlan[i]);
-
+   auto Node<C>::restructure() -> bool {
+      const auto requested = action;
       action = Action::None;
-      refinePlan.clear();
-   }
 
-   template<Config C> template<Index64 I>
-   void Node<C>::exchangeHaloGrid(Node* node1, Node* node2, const Vu64& fromSrc, const Vu64& toSrc, const Vu64& fromDst) {
-      if (not node1 or not node2) {
-         // TODO: boundary conditions
-         return;
-      }
+      if (isLeaf) {
+         if (requested != Action::Refine)
+            return false;
 
-      if (isInSameBuffer(node1, node2))
-         return;
+         split();
+         return true;
+      }
 
-      Loop<Dimension>(fromSrc, toSrc, [&](auto& it) {
-         std::get<I>(node1->data)[fromDst + it - fromSrc] = std::get<I>(node2->data)[it];
+      bool coarsen = true;
+      Loop<Dimension>(0, 2, [&](const auto& it) {
+         coarsen &= children[it]->isLeaf
+                and children[it]->action == Action::Coarsen;
       });
-   }
 
-   template<Config C>
-   bool Node<C>::isInSameBuffer(Node* node1, Node* node2) {
-      return std::get<0>(node1->data).buffer == std::get<0>(node2->data).buffer;
-   }
+      if (coarsen) {
+         merge();
+         return true;
+      }
 
-   template<Config C>
-   void Node<C>::exchangeHaloAll(Node* node1, Node* node2, const Vu64& fromSrc, const Vu64& toSrc, const Vu64& fromDst) {
-      C::Grids::ForEachIndex([&]<Grid G, auto INDEX>() {
-         exchangeHaloGrid<INDEX>(node1, node2, fromSrc, toSrc, fromDst);
+      bool changed = false;
+      Loop<Dimension>(0, 2, [&](const auto& it) {
+         changed |= children[it]->restructure();
       });
+      return changed;
    }
 
+   /// Fill the halo around the node's block from its neighbours, or with     
+   /// the nearest inner cell, where the node is at the edge of the mesh.     
+   /// Neighbours that are coarser leaves provide the cell that covers each   
+   /// halo cell                                                              
    template<Config C>
    void Node<C>::synchronize() {
-      Loop<Dimension>(0, 3, [&](auto& it) {
-         Vu64 fromSrc, toSrc, fromDst;
+      constexpr u64 S = C::BlockSize;
 
+      Loop<Dimension>(0, 3, [&](const auto& it) {
+         Vu64 from, to;
+         bool center = true;
          for (u8 i = 0; i < Dimension; ++i) {
-            fromSrc[i] = it[i] == 0 ? C::BlockSize : 1;
-            toSrc  [i] = it[i] == 2 ? 2 : C::BlockSize + 1;
-            fromDst[i] = it[i] == 0 ? 1 : C::BlockSize;
+            from[i] = it[i] == 0 ? 0 : it[i] == 1 ? C::Halo : S + C::Halo;
+            to[i] = from[i] + (it[i] == 1 ? S : C::Halo);
+            center &= it[i] == 1;
          }
 
-         exchangeHaloAll(this, adjacent[it], fromSrc, toSrc, fromDst);
+         if (center)
+            return;
+
+         const Node* source = adjacent[it];
+         const Node& owner = source ? *source : *this;
+         const u32 shift = source ? level - source->level : 0;
+
+         Loop<Dimension>(from, to, [&](const auto& cell) {
+            Vu64 at;
+            for (u8 i = 0; i < Dimension; ++i) {
+               if (source) {
+                  const auto global = static_cast<i64>(position[i] + cell[i]) - static_cast<i64>(C::Halo);
+                  at[i] = static_cast<u64>((global >> shift) - static_cast<i64>(source->position[i])) + C::Halo;
+               }
+               else at[i] = std::clamp<u64>(cell[i], C::Halo, S);
+            }
+
+            C::forEachGrid([&]<Grid, Index64 I>() {
+               std::get<I>(data)[cell] = std::get<I>(owner.data)[at];
+            });
+         });
       });
    }
 
    template<Config C>
    void Node<C>::synchronizeRecursive() {
-      if (sync)
-         synchronize();
+      synchronize();
 
       if (not isLeaf) {
-         Loop<Dimension>(0, 2, [&](auto& it) {
-            children[it]->synchronize();
+         Loop<Dimension>(0, 2, [&](const auto& it) {
+            children[it]->synchronizeRecursive();
          });
       }
    }
 
+   /// Invoke a kernel for each inner cell of each leaf. Leaves are marked    
+   /// for coarsening, unless a kernel invocation says otherwise              
+   ///   @param func - the kernel, taking a DataView                          
    template<Config C>
    void Node<C>::applyKernel(auto&& func) {
       if (isLeaf) {
          action = Action::Coarsen;
-         Loop<Dimension>(1, C::BlockSize, [&](auto& it) {
+         Loop<Dimension>(C::Halo, C::BlockSize + C::Halo, [&](const auto& it) {
             func(DataView<C>(*this, it));
          });
       }
       else {
-         Loop<Dimension>(0, 2, [&](auto& it) {
+         Loop<Dimension>(0, 2, [&](const auto& it) {
             children[it]->applyKernel(func);
          });
       }
    }
 
+   /// Invoke a function for each leaf below this node                        
+   ///   @param func - the function, taking a Node&                           
    template<Config C>
-   void Node<C>::propagateUp() {
-      if (not isLeaf) {
-         Loop<Dimension>(0, 2, [&](auto& it) {
-            children[it]->propagateUp();
+   void Node<C>::forEachLeaf(auto&& func) {
+      if (isLeaf)
+         func(*this);
+      else {
+         Loop<Dimension>(0, 2, [&](const auto& it) {
+            children[it]->forEachLeaf(func);
          });
       }
-
-      if (propagate)
-         downsampleAll();
    }
 
+   /// Downsample leaf data into all coarser nodes, bottom up                 
    template<Config C>
-   void Node<C>::propagateDown() {
+   void Node<C>::propagateUp() {
       if (isLeaf)
          return;
 
-      if (propagate or sync) {
-         Loop<Dimension>(0, 3, [&](auto& it) {
-            Vu64 fromSrc, toSrc, fromDst;
+      Loop<Dimension>(0, 2, [&](const auto& it) {
+         children[it]->propagateUp();
+      });
 
-            for (u8 i = 0; i < Dimension; ++i) {
-               fromSrc[i] = it[i] == 0 ? C::BlockSize + 1 : -1;
-               toSrc  [i] = it[i] == 2 ?  1 : C::BlockSize + 2;
-               fromDst[i] = it[i] == 0 ? -1 : C::BlockSize + 1;
-               upsampleAllRange(fromSrc, toSrc, fromDst, 0);
-            }
-         });
-      }
+      downsampleAll();
    }
 
    template<Config C>
@@ -381,93 +341,40 @@ namespace AMR
       , base(base) {}
 
    template<Config C>
-   void RefinePlan<C>::propagateUp(const Vu64& index, u32 currentLevel) {
-      // TODO: set propagate
-      LANGULUS_ASSUME(DevAssumes, propagate, "Propagation should be true");
-      u64 offset = 1 << (level - currentLevel - 1);
-      position = index * offset;
+   Tree<C>::Tree()
+      : root(new Node<C>) {
+      root->updateAdjacency();
    }
 
    template<Config C>
-   bool RefinePlan<C>::merge(RefinePlan* other, u32 level) {
-      if (level != other->level)
-         return false;
-
-      RefinePlan merged;
-      merged.level = level;
-      merged.propagate = false;
-
-      int diffCoord = -1;
-      for (u8 i = 0; i < Dimension; ++i) {
-         if (position[i] == other->position[i] and size[i] == other->size[i]) {
-            merged.position[i] = position[i];
-            merged.size[i] = size[i];
-         }
-         else if (diffCoord != -1) {
-            return false;
-         }
-         else if (position[i] + size[i] == other->position[i]) {
-            merged.position[i] = position[i];
-            merged.size[i] = size[i] + other->size[i];
-            diffCoord = i;
-         }
-         else if (other->position[i] + other->size[i] == position[i]) {
-            merged.position[i] = other->position[i];
-            merged.size[i] = size[i] + other->size[i];
-            diffCoord = i;
-         }
-         else return false;
-
-         if (merged.position[i] + merged.size[i] == 1 << (merged.level - level) or merged.position[i] == 0)
-            merged.propagate = true;
-      }
-
-      LANGULUS_ASSUME(DevAssumes, diffCoord != -1, "Invalid difference");
-
-      auto nodesBuffer = Ref<Buffer<Node<C>*, Dimension>>::New(merged.size);
-      Vu64 pos1 = 0;
-      Vu64 pos2 = 0;
-      for (u8 i = 0; i < Dimension; ++i) {
-         if (i == diffCoord) {
-            if (position[i] > other->position[i])
-               pos1[i] = other->size[i];
-            else
-               pos2[i] = size[i];
-         }
-      }
-
-      NodeArray array1(nodesBuffer, size, pos1);
-      Loop<Dimension>(0, size, [&](auto& it) {
-         array1[it] = nodes[it];
-      });
-
-      NodeArray array2(nodesBuffer, other->size, pos2);
-      Loop<Dimension>(0, other->size, [&](auto& it) {
-         array2[it] = other->nodes[it];
-      });
-
-      merged.nodes = NodeArray(nodesBuffer, merged.size, 0);
-      *this = merged;
-      return true;
+   Tree<C>::~Tree() {
+      delete root;
    }
 
+   /// Remove all nodes, leaving a single empty root                          
    template<Config C>
-   Tree<C>::Tree(Mesh<C>* mesh, Vu64 selfPosition)
-      : root(new Node<C>)
-      , mesh(mesh)
-      , selfPosition(selfPosition) {}
+   void Tree<C>::clear() {
+      delete root;
+      root = new Node<C>;
+      root->updateAdjacency();
+   }
 
+   /// Split and merge nodes, as requested by their actions                   
+   ///   @return true if the tree changed                                     
    template<Config C>
-   void Tree<C>::restructure() {
-      root->calculateRefinePlanRecursive();
-      root->restructure();
+   auto Tree<C>::restructure() -> bool {
+      if (not root->restructure())
+         return false;
+
       root->updateAdjacency();
+      return true;
    }
 
+   /// Bring coarse nodes and all halos up to date with the leaves            
    template<Config C>
    void Tree<C>::synchronize() {
       root->propagateUp();
-      root->synchronize();
+      root->synchronizeRecursive();
    }
 
    template<Config C>
@@ -475,6 +382,11 @@ namespace AMR
       root->applyKernel(func);
    }
 
+   template<Config C>
+   void Tree<C>::forEachLeaf(auto&& func) const {
+      root->forEachLeaf(func);
+   }
+
    /*template<Config C>
    Mesh<C>::Mesh(const Vu64& size)
       : trees(Array<Tree, Dimension>::createWithBuffer(size)) {
@@ -500,4 +412,4 @@ namespace AMR
       });
    }*/
 
-} // namespace AMR
\ No newline at end of file
+} // namespace AMR
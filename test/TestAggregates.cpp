@@ -0,0 +1,169 @@
+///                                                                           
+/// Langulus::Module::Physics                                                 
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "../source/Aggregates.hpp"
+#include <Langulus/Testing.hpp>
+#include <random>
+
+using namespace Euclidean;
+
+
+/// Positions and extents of slots, laid out like an InstancePool             
+struct SlotBounds {
+   std::vector<Real> mArrays[6];
+
+   void Push(std::mt19937& rng) {
+      std::uniform_real_distribution<Real> place {-100, 100};
+      std::uniform_real_distribution<Real> size {0, 1};
+      for (int a = 0; a < 6; ++a)
+         mArrays[a].push_back(a < 3 ? place(rng) : size(rng));
+   }
+
+   /// Remove a slot the way the pool does it - the last one takes its place  
+   void Remove(Offset slot) {
+      for (auto& array : mArrays) {
+         array[slot] = array.back();
+         array.pop_back();
+      }
+   }
+
+   auto Get() const noexcept -> Culling::Bounds {
+      return {
+         mArrays[0].data(), mArrays[1].data(), mArrays[2].data(),
+         mArrays[3].data(), mArrays[4].data(), mArrays[5].data()
+      };
+   }
+};
+
+/// Check that clouds match the index exactly, and that bounds contain all    
+/// points of their cloud                                                     
+bool MatchesIndex(const Aggregates& clouds, const OctaveIndex& index, const SlotBounds& slots) {
+   Aggregates fresh;
+   fresh.Refresh(index, slots.Get(), 0);
+   if (fresh.GetCloudCount() != clouds.GetCloudCount())
+      return false;
+
+   bool valid = true;
+   index.ForEach([&](int octave, const OctaveIndex::Bucket&) {
+      const auto a = clouds.GetCloud(octave);
+      const auto b = fresh.GetCloud(octave);
+      valid &= a and b and a->mPoints.size() == b->mPoints.size();
+      if (not valid)
+         return;
+
+      for (Offset i = 0; i < a->mPoints.size(); ++i) {
+         valid &= a->mPoints[i].mX == b->mPoints[i].mX
+              and a->mPoints[i].mY == b->mPoints[i].mY
+              and a->mPoints[i].mZ == b->mPoints[i].mZ
+              and a->mPoints[i].mRadius == b->mPoints[i].mRadius;
+      }
+
+      valid &= a->mBounds.Contains(b->mBounds);
+   });
+   return valid;
+}
+
+
+SCENARIO("Aggregating instances by octave", "[aggregates]") {
+   std::mt19937 rng {11};
+   std::uniform_int_distribution<int> pick {-3, 3};
+
+   GIVEN("Slots in random octaves, with the first half active") {
+      OctaveIndex index;
+      SlotBounds slots;
+      Aggregates clouds;
+      for (Offset slot = 0; slot < 1000; ++slot) {
+         slots.Push(rng);
+         index.Insert(slot, pick(rng));
+      }
+      clouds.Refresh(index, slots.Get(), 500);
+
+      THEN("There is a tightly fitted cloud for each octave") {
+         REQUIRE(clouds.GetCloudCount() == 7);
+         REQUIRE(MatchesIndex(clouds, index, slots));
+
+         const auto cloud = clouds.GetCloud(0);
+         REQUIRE(cloud);
+         for (const auto& p : cloud->mPoints) {
+            REQUIRE(p.mX - p.mRadius >= cloud->mBounds.mMin.x);
+            REQUIRE(p.mX + p.mRadius <= cloud->mBounds.mMax.x);
+         }
+      }
+
+      WHEN("Active slots move, and some change octaves") {
+         std::uniform_real_distribution<Real> nudge {-5, 5};
+         for (int frame = 0; frame < 10; ++frame) {
+            for (Offset slot = 0; slot < 500; ++slot) {
+               for (int a = 0; a < 3; ++a)
+                  slots.mArrays[a][slot] += nudge(rng);
+
+               if (slot % 37 == 0) {
+                  const auto previous = index.GetOctave(slot);
+                  if (index.Update(slot, pick(rng))) {
+                     clouds.Invalidate(previous);
+                     clouds.Invalidate(index.GetOctave(slot));
+                  }
+               }
+            }
+            clouds.Refresh(index, slots.Get(), 500);
+         }
+
+         THEN("Clouds match the index") {
+            REQUIRE(MatchesIndex(clouds, index, slots));
+         }
+      }
+
+      WHEN("Slots are swapped, and others are removed") {
+         for (Offset slot = 0; slot < 400; slot += 2) {
+            index.Swap(slot, 999 - slot);
+            for (auto& array : slots.mArrays)
+               std::swap(array[slot], array[999 - slot]);
+         }
+
+         for (Offset slot = 0; slot < 300; ++slot) {
+            const Offset removed = slot * 2;
+            clouds.Invalidate(index.GetOctave(removed));
+            index.Remove(removed);
+            slots.Remove(removed);
+         }
+         clouds.Refresh(index, slots.Get(), 0);
+
+         THEN("Clouds match the index") {
+            REQUIRE(index.GetCount() == 700);
+            REQUIRE(MatchesIndex(clouds, index, slots));
+         }
+      }
+
+      WHEN("A whole octave is emptied") {
+         for (Offset slot = index.GetCount(); slot > 0; --slot) {
+            if (index.GetOctave(slot - 1) != 3)
+               continue;
+            clouds.Invalidate(3);
+            index.Remove(slot - 1);
+            slots.Remove(slot - 1);
+         }
+         clouds.Refresh(index, slots.Get(), 0);
+
+         THEN("Its cloud is gone") {
+            REQUIRE(clouds.GetCloud(3) == nullptr);
+            REQUIRE(clouds.GetCloudCount() == 6);
+            REQUIRE(MatchesIndex(clouds, index, slots));
+         }
+      }
+
+      WHEN("Looking from octave 1") {
+         std::vector<int> hidden;
+         clouds.ForEachHidden(1, [&](int octave, const Aggregates::Cloud&) {
+            hidden.push_back(octave);
+         });
+
+         THEN("Only octaves too small to be seen are reported") {
+            REQUIRE(hidden == std::vector<int> {-3, -2, -1});
+         }
+      }
+   }
+}
@@ -0,0 +1,244 @@
+///                                                                           
+/// Langulus::Module::Physics                                                 
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "../source/BondIslands.hpp"
+#include <Langulus/Testing.hpp>
+#include <cmath>
+#include <random>
+#include <set>
+#include <vector>
+
+using namespace Euclidean;
+
+
+/// Bond consecutive slots in [from, to)                                      
+void BindIslandChain(BondIslands& islands, Offset from, Offset to) {
+   for (Offset i = from + 1; i < to; ++i)
+      islands.Bind(i - 1, i);
+}
+
+/// Collect the islands as sets of bonds, so they can be compared in any order
+auto CollectIslands(const BondIslands& islands) {
+   std::set<std::set<uint32_t>> result;
+   for (Offset i = 0; i < islands.GetIslandCount(); ++i) {
+      std::set<uint32_t> island;
+      islands.ForEachInIsland(i, [&](uint32_t bond) { island.insert(bond); });
+      result.insert(island);
+   }
+   return result;
+}
+
+/// Find the islands from scratch, by flooding through unanchored slots       
+auto FloodIslands(const BondIslands& islands, const std::vector<uint8_t>& anchors,
+                  const std::vector<uint32_t>& bonds) {
+   std::set<std::set<uint32_t>> result;
+   std::set<uint32_t> visited;
+   for (auto seed : bonds) {
+      if (visited.count(seed))
+         continue;
+
+      std::set<uint32_t> island;
+      std::vector<uint32_t> stack {seed};
+      visited.insert(seed);
+      while (not stack.empty()) {
+         const auto bond = stack.back();
+         stack.pop_back();
+         island.insert(bond);
+         for (Offset end = 0; end < 2; ++end) {
+            const auto slot = islands.GetSlot(bond, end);
+            if (anchors[slot])
+               continue;
+            islands.ForEachBond(slot, [&](uint32_t other) {
+               if (visited.insert(other).second)
+                  stack.push_back(other);
+            });
+         }
+      }
+      result.insert(island);
+   }
+   return result;
+}
+
+
+SCENARIO("Bond islands", "[bonds]") {
+   GIVEN("Three separate chains") {
+      BondIslands islands;
+      for (Offset i = 0; i < 30; ++i)
+         islands.Insert(i, false);
+      BindIslandChain(islands, 0, 10);
+      BindIslandChain(islands, 10, 20);
+      BindIslandChain(islands, 20, 30);
+      islands.Group();
+
+      THEN("There are three islands") {
+         REQUIRE(islands.GetCount() == 27);
+         REQUIRE(islands.GetIslandCount() == 3);
+      }
+
+      WHEN("Two chains are linked, and then unlinked") {
+         const auto link = islands.Bind(9, 10);
+         islands.Group();
+         REQUIRE(islands.GetIslandCount() == 2);
+         REQUIRE(islands.GetRegroupedCount() == 0);
+
+         islands.Unbind(link);
+         islands.Group();
+
+         THEN("Only the linked island is regrouped") {
+            REQUIRE(islands.GetIslandCount() == 3);
+            REQUIRE(islands.GetRegroupedCount() == 18);
+         }
+      }
+
+      WHEN("A chain is closed into a loop") {
+         islands.Bind(0, 9);
+         islands.Group();
+
+         THEN("Its island grows, and nothing is regrouped") {
+            REQUIRE(islands.GetIslandCount() == 3);
+            REQUIRE(islands.GetRegroupedCount() == 0);
+            REQUIRE(CollectIslands(islands).count({0, 1, 2, 3, 4, 5, 6, 7, 8, 27}) == 1);
+         }
+      }
+
+      WHEN("A chain is cut in the middle") {
+         islands.Unbind(islands.GetFirst(5));
+         islands.Group();
+
+         THEN("It splits in two") {
+            REQUIRE(islands.GetCount() == 26);
+            REQUIRE(islands.GetIslandCount() == 4);
+            REQUIRE(islands.GetRegroupedCount() == 8);
+         }
+      }
+
+      WHEN("Slots are swapped") {
+         const auto before = CollectIslands(islands);
+         islands.Swap(0, 29);
+         islands.Swap(5, 15);
+         islands.Group();
+
+         THEN("Bonds refer to the new slots, and islands don't change") {
+            REQUIRE(CollectIslands(islands) == before);
+            islands.ForEachBond(29, [&](uint32_t bond) {
+               REQUIRE((islands.GetSlot(bond, 0) == 29 or islands.GetSlot(bond, 1) == 29));
+            });
+            REQUIRE(islands.GetFirst(0) != BondIslands::Invalid);
+         }
+      }
+
+      WHEN("The middle of a chain is anchored") {
+         islands.SetAnchor(5, true);
+         islands.Group();
+
+         THEN("The anchor doesn't connect the two halves") {
+            REQUIRE(islands.GetIslandCount() == 4);
+         }
+
+         AND_WHEN("It is released") {
+            islands.SetAnchor(5, false);
+            islands.Group();
+
+            THEN("The halves are connected again") {
+               REQUIRE(islands.GetIslandCount() == 3);
+            }
+         }
+      }
+   }
+
+   GIVEN("Two stretched chains, each hanging from an anchor") {
+      constexpr Count slots = 10;
+      BondIslands islands;
+      std::vector<Real> x(slots), y(slots), z(slots), vx(slots), vy(slots), vz(slots);
+      std::vector<uint8_t> anchors(slots);
+      for (Offset i = 0; i < slots; ++i) {
+         anchors[i] = i % 5 == 0;
+         x[i] = Real(i % 5) * 2;
+         y[i] = Real(i / 5);
+         islands.Insert(i, anchors[i]);
+      }
+      for (Offset i = 0; i < slots; ++i) {
+         if (i % 5 == 0)
+            continue;
+         const auto bond = islands.Bind(i - 1, i);
+         islands.SetRestLength(bond, 1);
+         islands.SetDamping(bond, Real(0.5));
+      }
+      islands.Group();
+
+      WHEN("Each island is solved straight from the table") {
+         const BondSolver::State state {
+            x.data(), y.data(), z.data(), vx.data(), vy.data(), vz.data(), anchors.data()
+         };
+         BondSolver solver;
+         solver.SetIterations(200, Real(1e-5));
+         for (Offset island = 0; island < islands.GetIslandCount(); ++island) {
+            const auto table = islands.GetTable(island);
+            REQUIRE(table.mCount == 4);
+            REQUIRE(solver.Solve(state, table, Real(1) / Real(60)).mResidual <= Real(1e-3));
+         }
+
+         THEN("Every bond is back at its rest length") {
+            REQUIRE(islands.GetIslandCount() == 2);
+            REQUIRE(islands.GetStiffness(0) == std::numeric_limits<Real>::infinity());
+            for (Offset i = 0; i < slots; ++i) {
+               if (i % 5 == 0)
+                  continue;
+               const Real dx = x[i] - x[i - 1];
+               const Real dy = y[i] - y[i - 1];
+               REQUIRE(std::sqrt(dx * dx + dy * dy) == Approx(1).margin(1e-3));
+            }
+         }
+      }
+   }
+
+   GIVEN("Random bonds, bound and unbound over many groupings") {
+      constexpr Count slots = 200;
+      BondIslands islands;
+      std::vector<uint8_t> anchors(slots);
+      std::mt19937 random {7};
+      for (Offset i = 0; i < slots; ++i) {
+         anchors[i] = random() % 10 == 0;
+         islands.Insert(i, anchors[i]);
+      }
+
+      std::vector<uint32_t> bonds;
+      bool matches = true;
+      for (int round = 0; round < 50; ++round) {
+         for (int i = 0; i < 8; ++i) {
+            const Offset a = random() % slots;
+            const Offset b = (a + 1 + random() % (slots - 1)) % slots;
+            bonds.push_back(islands.Bind(a, b));
+         }
+         for (int i = 0; i < 5 and not bonds.empty(); ++i) {
+            const auto at = random() % bonds.size();
+            islands.Unbind(bonds[at]);
+            bonds[at] = bonds.back();
+            bonds.pop_back();
+         }
+         if (round % 7 == 0) {
+            const Offset slot = random() % slots;
+            anchors[slot] = not anchors[slot];
+            islands.SetAnchor(slot, anchors[slot]);
+         }
+         if (round % 5 == 0) {
+            const Offset a = random() % slots;
+            const Offset b = random() % slots;
+            islands.Swap(a, b);
+            std::swap(anchors[a], anchors[b]);
+         }
+
+         islands.Group();
+         matches &= CollectIslands(islands) == FloodIslands(islands, anchors, bonds);
+      }
+
+      THEN("Islands always match the ones found from scratch") {
+         REQUIRE(matches);
+         REQUIRE(islands.GetCount() == bonds.size());
+      }
+   }
+}
@@ -0,0 +1,185 @@
+///                                                                           
+/// Langulus::Module::Physics                                                 
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "../source/BondSolver.hpp"
+#include <Langulus/Testing.hpp>
+#include <cmath>
+#include <vector>
+
+using namespace Euclidean;
+
+
+/// Positions, velocities and static flags of a number of slots               
+struct BondBodies {
+   std::vector<Real> mX, mY, mZ;
+   std::vector<Real> mVelocityX, mVelocityY, mVelocityZ;
+   std::vector<uint8_t> mStatic;
+
+   BondBodies(Count count)
+      : mX(count), mY(count), mZ(count)
+      , mVelocityX(count), mVelocityY(count), mVelocityZ(count)
+      , mStatic(count) {}
+
+   auto GetState() -> BondSolver::State {
+      return {
+         mX.data(), mY.data(), mZ.data(),
+         mVelocityX.data(), mVelocityY.data(), mVelocityZ.data(),
+         mStatic.data()
+      };
+   }
+
+   auto Distance(Offset a, Offset b) const -> Real {
+      const Real dx = mX[b] - mX[a];
+      const Real dy = mY[b] - mY[a];
+      const Real dz = mZ[b] - mZ[a];
+      return std::sqrt(dx * dx + dy * dy + dz * dz);
+   }
+};
+
+/// A cubic lattice of slots, bonded to their neighbours along each axis,     
+/// jittered away from rest, with the bottom layer static                     
+void BuildBondLattice(Count side, BondBodies& bodies, BondSolver& solver) {
+   const auto slot = [side](Count x, Count y, Count z) {
+      return static_cast<uint32_t>(x + side * (y + side * z));
+   };
+
+   for (Count z = 0; z < side; ++z) {
+      for (Count y = 0; y < side; ++y) {
+         for (Count x = 0; x < side; ++x) {
+            const auto i = slot(x, y, z);
+            const Real jitter = Real((i * 7919) % 13) / Real(100);
+            bodies.mX[i] = Real(x) + jitter;
+            bodies.mY[i] = Real(y) - jitter;
+            bodies.mZ[i] = Real(z) * Real(1.1);
+            bodies.mStatic[i] = z == 0;
+
+            if (x + 1 < side)
+               solver.Add(i, slot(x + 1, y, z), 1);
+            if (y + 1 < side)
+               solver.Add(i, slot(x, y + 1, z), 1);
+            if (z + 1 < side)
+               solver.Add(i, slot(x, y, z + 1), 1);
+         }
+      }
+   }
+}
+
+
+SCENARIO("Bond constraint solver", "[bonds]") {
+   const Real dt = Real(1) / Real(60);
+
+   GIVEN("Two free slots, stretched to twice the rest length") {
+      BondBodies bodies {2};
+      bodies.mX = {0, 2};
+      BondSolver solver;
+      solver.Add(0, 1, 1);
+
+      WHEN("Solved") {
+         const auto& stats = solver.Solve(bodies.GetState(), dt);
+
+         THEN("Both move halfway, and keep moving towards each other") {
+            REQUIRE(stats.mBonds == 1);
+            REQUIRE(stats.mColours == 1);
+            REQUIRE(stats.mResidual == Approx(0).margin(1e-5));
+            REQUIRE(bodies.mX[0] == Approx(0.5));
+            REQUIRE(bodies.mX[1] == Approx(1.5));
+            REQUIRE(bodies.mVelocityX[0] == Approx(Real(0.5) / dt));
+            REQUIRE(bodies.mVelocityX[1] == Approx(Real(-0.5) / dt));
+         }
+      }
+   }
+
+   GIVEN("A chain of slots, hanging from a static one") {
+      constexpr Count links = 8;
+      BondBodies bodies {links + 1};
+      BondSolver solver;
+      for (Offset i = 0; i <= links; ++i) {
+         bodies.mY[i] = -Real(1.5) * Real(i);
+         if (i)
+            solver.Add(uint32_t(i - 1), uint32_t(i), 1);
+      }
+      bodies.mStatic[0] = 1;
+      solver.SetIterations(500, Real(1e-4));
+
+      WHEN("Solved") {
+         const auto& stats = solver.Solve(bodies.GetState(), dt);
+
+         THEN("The chain converges before the iteration limit") {
+            REQUIRE(stats.mIterations < 500);
+            REQUIRE(stats.mResidual <= Real(1e-3));
+            for (Offset i = 1; i <= links; ++i)
+               REQUIRE(bodies.Distance(i - 1, i) == Approx(1).margin(1e-3));
+         }
+
+         THEN("A chain only needs two colours") {
+            REQUIRE(stats.mColours == 2);
+         }
+
+         THEN("The static slot didn't move") {
+            REQUIRE(bodies.mY[0] == 0);
+            REQUIRE(bodies.mVelocityY[0] == 0);
+         }
+      }
+   }
+
+   GIVEN("A soft bond") {
+      BondBodies bodies {2};
+      bodies.mX = {0, 2};
+      bodies.mStatic[0] = 1;
+      BondSolver solver;
+      solver.Add(0, 1, 1, Real(100));
+
+      WHEN("Solved") {
+         const auto& stats = solver.Solve(bodies.GetState(), dt);
+
+         THEN("It gives way partially") {
+            REQUIRE(stats.mResidual > Real(1e-3));
+            REQUIRE(bodies.mX[1] < 2);
+            REQUIRE(bodies.mX[1] > 1);
+         }
+      }
+   }
+
+   GIVEN("A lattice of bonds, with a static bottom layer") {
+      constexpr Count side = 12;
+      BondBodies serial {side * side * side};
+      BondBodies parallel {side * side * side};
+      BondSolver serialSolver;
+      BondSolver parallelSolver;
+      BuildBondLattice(side, serial, serialSolver);
+      BuildBondLattice(side, parallel, parallelSolver);
+      serialSolver.SetIterations(64, Real(1e-4));
+      parallelSolver.SetIterations(64, Real(1e-4));
+      Scheduler scheduler {4};
+
+      WHEN("Solved with and without a scheduler") {
+         const auto& a = serialSolver.Solve(serial.GetState(), dt);
+         const auto& b = parallelSolver.Solve(parallel.GetState(), dt, &scheduler);
+
+         THEN("Colours keep bonds independent, so results are identical") {
+            REQUIRE(a.mColours <= 6);
+            REQUIRE(a.mColours == b.mColours);
+            REQUIRE(a.mIterations == b.mIterations);
+            REQUIRE(a.mResidual == b.mResidual);
+            REQUIRE(serial.mX == parallel.mX);
+            REQUIRE(serial.mY == parallel.mY);
+            REQUIRE(serial.mZ == parallel.mZ);
+            REQUIRE(serial.mVelocityZ == parallel.mVelocityZ);
+         }
+
+         THEN("More iterations leave a smaller residual") {
+            BondBodies brief {side * side * side};
+            BondSolver briefSolver;
+            BuildBondLattice(side, brief, briefSolver);
+            briefSolver.SetIterations(8, Real(1e-4));
+            const auto& c = briefSolver.Solve(brief.GetState(), dt);
+            REQUIRE(c.mIterations == 8);
+            REQUIRE(a.mResidual < c.mResidual);
+         }
+      }
+   }
+}
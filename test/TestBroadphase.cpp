@@ -0,0 +1,227 @@
+///                                                                           
+/// Langulus::Module::Physics                                                 
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "../source/Broadphase.hpp"
+#include <Langulus/Testing.hpp>
+#include <random>
+#include <set>
+
+using namespace Euclidean;
+using Box = Broadphase::Box;
+
+
+/// Generate random unit-sized boxes inside a cube                            
+///   @param count - number of boxes                                          
+///   @param size - the size of the cube                                      
+///   @param rng - the random generator                                       
+auto RandomBoxes(Count count, Real size, std::mt19937& rng) {
+   std::uniform_real_distribution<Real> place {0, size};
+   std::vector<Box> boxes(count);
+   for (auto& box : boxes) {
+      box.mMin = Vec3 {place(rng), place(rng), place(rng)};
+      box.mMax = box.mMin + Vec3 {1, 1, 1};
+   }
+   return boxes;
+}
+
+/// Convert pairs to an ordered set, to compare them regardless of order      
+auto ToSet(const std::vector<Broadphase::Pair>& pairs) {
+   std::set<std::pair<Offset, Offset>> result;
+   for (auto& pair : pairs)
+      result.emplace(std::min(pair.mA, pair.mB), std::max(pair.mA, pair.mB));
+   return result;
+}
+
+/// Find overlapping fat boxes the slow way                                   
+auto BruteForcePairs(const Broadphase& tree, const std::vector<Broadphase::Proxy>& proxies) {
+   std::vector<Broadphase::Pair> pairs;
+   for (Offset i = 0; i < proxies.size(); ++i) {
+      for (Offset j = i + 1; j < proxies.size(); ++j) {
+         if (tree.GetFatBox(proxies[i]).Overlaps(tree.GetFatBox(proxies[j])))
+            pairs.push_back({tree.GetData(proxies[i]), tree.GetData(proxies[j])});
+      }
+   }
+   return pairs;
+}
+
+
+SCENARIO("Broadphase", "[broadphase]") {
+   std::mt19937 rng {7};
+
+   GIVEN("A broadphase with a thousand proxies") {
+      Broadphase tree;
+      const auto boxes = RandomBoxes(1000, 40, rng);
+      std::vector<Broadphase::Proxy> proxies;
+      for (Offset i = 0; i < boxes.size(); ++i)
+         proxies.push_back(tree.Insert(boxes[i], i));
+
+      THEN("The tree is balanced and consistent") {
+         REQUIRE(tree.IsValid());
+         REQUIRE(tree.GetProxyCount() == 1000);
+         REQUIRE(tree.GetHeight() < 30);
+      }
+
+      THEN("Candidate pairs are the same as brute force") {
+         std::vector<Broadphase::Pair> pairs;
+         tree.FindPairs(pairs);
+         REQUIRE(pairs.size() == ToSet(pairs).size());
+         REQUIRE(ToSet(pairs) == ToSet(BruteForcePairs(tree, proxies)));
+      }
+
+      WHEN("Proxies move by a small amount") {
+         Count reinserted = 0;
+         for (Offset i = 0; i < boxes.size(); ++i) {
+            auto box = boxes[i];
+            box.mMin += Vec3 {Real(0.01), 0, 0};
+            box.mMax += Vec3 {Real(0.01), 0, 0};
+            reinserted += tree.Move(proxies[i], box, Vec3 {Real(0.01), 0, 0});
+         }
+
+         THEN("Nothing is reinserted, because fat boxes contain them") {
+            REQUIRE(reinserted == 0);
+            REQUIRE(tree.IsValid());
+         }
+      }
+
+      WHEN("Proxies move far away") {
+         const auto moved = RandomBoxes(boxes.size(), 40, rng);
+         for (Offset i = 0; i < moved.size(); ++i)
+            REQUIRE(tree.Move(proxies[i], moved[i], Vec3 {1, 0, 0}));
+
+         THEN("The tree remains consistent, and pairs are correct") {
+            REQUIRE(tree.IsValid());
+            std::vector<Broadphase::Pair> pairs;
+            tree.FindPairs(pairs);
+            REQUIRE(ToSet(pairs) == ToSet(BruteForcePairs(tree, proxies)));
+         }
+      }
+
+      WHEN("A proxy moves fast, and then stops") {
+         auto box = boxes[0];
+         box.mMin += Vec3 {5, 0, 0};
+         box.mMax += Vec3 {5, 0, 0};
+         REQUIRE(tree.Move(proxies[0], box, Vec3 {10, 0, 0}));
+         const auto fast = tree.GetFatBox(proxies[0]);
+         const bool shrunk = tree.Move(proxies[0], box, Vec3 {});
+
+         THEN("Its fat box is shrunk again") {
+            REQUIRE(shrunk);
+            REQUIRE(tree.GetFatBox(proxies[0]).Contains(box));
+            REQUIRE(tree.GetFatBox(proxies[0]).GetSurface() < fast.GetSurface());
+            REQUIRE(tree.IsValid());
+         }
+      }
+
+      WHEN("The tree is queried from inside a query") {
+         const Box outer {Vec3 {0, 0, 0}, Vec3 {10, 10, 10}};
+         const Box inner {Vec3 {20, 20, 20}, Vec3 {30, 30, 30}};
+         std::set<Broadphase::Proxy> expected, found;
+         tree.Query(inner, [&](Broadphase::Proxy proxy) {
+            expected.insert(proxy);
+            return true;
+         });
+
+         Count outerCount = 0, innerCount = 0;
+         tree.Query(outer, [&](Broadphase::Proxy) {
+            ++outerCount;
+            found.clear();
+            tree.Query(inner, [&](Broadphase::Proxy proxy) {
+               found.insert(proxy);
+               return true;
+            });
+            innerCount += found == expected;
+            return true;
+         });
+
+         THEN("Both queries are complete") {
+            REQUIRE(outerCount > 0);
+            REQUIRE(innerCount == outerCount);
+            REQUIRE(not expected.empty());
+         }
+      }
+
+      WHEN("Half of the proxies are removed") {
+         for (Offset i = 0; i < proxies.size(); i += 2)
+            tree.Remove(proxies[i]);
+         std::vector<Broadphase::Proxy> remaining;
+         for (Offset i = 1; i < proxies.size(); i += 2)
+            remaining.push_back(proxies[i]);
+
+         THEN("The tree remains consistent, and pairs are correct") {
+            REQUIRE(tree.IsValid());
+            REQUIRE(tree.GetProxyCount() == 500);
+            std::vector<Broadphase::Pair> pairs;
+            tree.FindPairs(pairs);
+            REQUIRE(ToSet(pairs) == ToSet(BruteForcePairs(tree, remaining)));
+         }
+      }
+
+      WHEN("All proxies are removed") {
+         for (auto proxy : proxies)
+            tree.Remove(proxy);
+
+         THEN("The tree is empty") {
+            REQUIRE(tree.IsValid());
+            REQUIRE(tree.GetProxyCount() == 0);
+            REQUIRE(tree.GetHeight() == 0);
+         }
+      }
+   }
+}
+
+#ifdef LANGULUS_STD_BENCHMARK
+SCENARIO("Broadphase performance", "[broadphase][!benchmark]") {
+   for (Count count : {Count {10'000}, Count {100'000}, Count {1'000'000}}) {
+      // Keep density constant, about one neighbour per proxy           
+      const auto size = static_cast<Real>(std::cbrt(count * Real(8)));
+      const auto name = std::to_string(count / 1000) + "k proxies";
+      std::mt19937 rng {1};
+      const auto boxes = RandomBoxes(count, size, rng);
+
+      Broadphase tree;
+      std::vector<Broadphase::Proxy> proxies;
+      for (Offset i = 0; i < count; ++i)
+         proxies.push_back(tree.Insert(boxes[i], i));
+
+      BENCHMARK_ADVANCED("Build - " + name)(Catch::Benchmark::Chronometer meter) {
+         meter.measure([&] {
+            Broadphase fresh;
+            for (Offset i = 0; i < count; ++i)
+               fresh.Insert(boxes[i], i);
+            return fresh.GetHeight();
+         });
+      };
+
+      BENCHMARK_ADVANCED("Refit with 10% escaping - " + name)(Catch::Benchmark::Chronometer meter) {
+         Real shift = 0;
+         meter.measure([&] {
+            // Jitter everything, push every tenth proxy out of its box 
+            shift = -shift + Real(0.01);
+            Count reinserted = 0;
+            for (Offset i = 0; i < count; ++i) {
+               const Real d = i % 10 ? shift : shift * 100;
+               auto box = boxes[i];
+               box.mMin += Vec3 {d, 0, 0};
+               box.mMax += Vec3 {d, 0, 0};
+               reinserted += tree.Move(proxies[i], box, Vec3 {});
+            }
+            return reinserted;
+         });
+      };
+
+      BENCHMARK_ADVANCED("Find pairs - " + name)(Catch::Benchmark::Chronometer meter) {
+         std::vector<Broadphase::Pair> pairs;
+         pairs.reserve(count * 4);
+         meter.measure([&] {
+            pairs.clear();
+            tree.FindPairs(pairs);
+            return pairs.size();
+         });
+      };
+   }
+}
+#endif
@@ -7,6 +7,7 @@
 ///                                                                           
 #include <Langulus/Physical.hpp>
 #include <Langulus/Testing.hpp>
+#include <thread>
 
 
 template<class T>
@@ -65,3 +66,35 @@ SCENARIO("Physics creation", "[physics]") {
    }
 }
 
+
+SCENARIO("Transform cache", "[physics]") {
+   GIVEN("An instance inside a world") {
+      auto root = Thing::Root<false>("Physics");
+      root.CreateUnit<A::World>();
+      auto instance = root.CreateUnit<A::Instance>().As<A::Instance*>();
+      const Mat4 expected[2] {
+         instance->GetModelTransform(Level {}),
+         instance->GetModelTransform(Level {} + 1)
+      };
+
+      WHEN("Transforms for two levels are requested from several threads at once") {
+         std::atomic<bool> matches = true;
+         std::vector<std::thread> threads;
+         for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&, t] {
+               const Level level = Level {} + t % 2;
+               for (int i = 0; i < 1000; ++i)
+                  matches = matches and instance->GetModelTransform(level) == expected[t % 2];
+            });
+         }
+         for (auto& thread : threads)
+            thread.join();
+
+         THEN("Every thread gets the transform of its own level") {
+            REQUIRE(matches);
+         }
+      }
+
+      root.Reference(-1);
+   }
+}
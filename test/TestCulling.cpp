@@ -0,0 +1,136 @@
+///                                                                           
+/// Langulus::Module::Physics                                                 
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "../source/Culling.hpp"
+#include <Langulus/Testing.hpp>
+#include <chrono>
+#include <random>
+#include <vector>
+
+using namespace Euclidean;
+using Integrator::ISA;
+
+
+/// Centers and half-sizes of random boxes                                    
+struct BoxData {
+   std::vector<Real> mArrays[6];
+
+   BoxData(Count count, unsigned seed) {
+      std::mt19937 rng {seed};
+      std::uniform_real_distribution<Real> center {-100, 100};
+      std::uniform_real_distribution<Real> extent {0, 5};
+      for (int i = 0; i < 6; ++i) {
+         mArrays[i].resize(count);
+         for (auto& value : mArrays[i])
+            value = i < 3 ? center(rng) : extent(rng);
+      }
+   }
+
+   auto GetBounds() const noexcept -> Culling::Bounds {
+      return {
+         mArrays[0].data(), mArrays[1].data(), mArrays[2].data(),
+         mArrays[3].data(), mArrays[4].data(), mArrays[5].data()
+      };
+   }
+};
+
+/// A frustum looking down the Z axis, with a 90 degree field of view         
+auto MakeFrustum() {
+   Culling::Frustum f;
+   const Real s = std::sqrt(Real(0.5));
+   f.SetPlane(0, { s, 0, s}, 0);       // Left
+   f.SetPlane(1, {-s, 0, s}, 0);       // Right
+   f.SetPlane(2, {0,  s, s}, 0);       // Bottom
+   f.SetPlane(3, {0, -s, s}, 0);       // Top
+   f.SetPlane(4, {0, 0,  1}, -1);      // Near, at z = 1
+   f.SetPlane(5, {0, 0, -1}, 50);      // Far, at z = 50
+   return f;
+}
+
+
+SCENARIO("Batched frustum culling", "[culling]") {
+   const auto frustum = MakeFrustum();
+
+   GIVEN("A few boxes around the frustum") {
+      // Inside, behind the camera, beyond the far plane, straddling    
+      // the left plane, and outside the left plane                     
+      const Real x[]  {0, 0,   0,  -11, -15};
+      const Real y[]  {0, 0,   0,    0,   0};
+      const Real z[]  {10, -10, 60,  10,  10};
+      const Real e[]  {1, 1,   1,    2,   2};
+      const Culling::Bounds bounds {x, y, z, e, e, e};
+
+      WHEN("Tested with the scalar kernel") {
+         Culling::Word bits = ~Culling::Word {0};
+         Culling::Test(ISA::Scalar, frustum, bounds, 0, 5, &bits);
+
+         THEN("Only boxes that touch the frustum are visible, and unused bits are cleared") {
+            REQUIRE(bits == 0b01001);
+         }
+      }
+   }
+
+   for (int i = 0; i < static_cast<int>(ISA::Counter); ++i) {
+      const auto isa = static_cast<ISA>(i);
+      if (not Integrator::IsSupported(isa))
+         continue;
+
+      GIVEN(std::string("Random boxes and the ") + Integrator::GetName(isa) + " kernel") {
+         // Odd count, so that every kernel has a scalar remainder      
+         constexpr Count count = 1021;
+         const BoxData boxes {count, 42};
+         std::vector<Culling::Word> scalar(Culling::GetWordCount(count));
+         std::vector<Culling::Word> batched(scalar.size());
+
+         WHEN("Tested in a single run") {
+            Culling::Test(ISA::Scalar, frustum, boxes.GetBounds(), 0, count, scalar.data());
+            Culling::Test(isa, frustum, boxes.GetBounds(), 0, count, batched.data());
+
+            THEN("Results are identical to the scalar kernel") {
+               REQUIRE(scalar == batched);
+               Count visible = 0;
+               for (Offset s = 0; s < count; ++s)
+                  visible += Culling::IsVisible(batched.data(), s);
+               REQUIRE(visible > 0);
+               REQUIRE(visible < count);
+            }
+         }
+
+         WHEN("Tested in word-aligned chunks") {
+            Culling::Test(ISA::Scalar, frustum, boxes.GetBounds(), 0, count, scalar.data());
+            for (Offset from = 0; from < count; from += 128)
+               Culling::Test(isa, frustum, boxes.GetBounds(), from, std::min(from + 128, count), batched.data());
+
+            THEN("Results are identical to a single run") {
+               REQUIRE(scalar == batched);
+            }
+         }
+      }
+   }
+}
+
+#ifdef LANGULUS_STD_BENCHMARK
+SCENARIO("Batched frustum culling throughput", "[culling][!benchmark]") {
+   constexpr Count count = 200'000;
+   const auto frustum = MakeFrustum();
+   const BoxData boxes {count, 1};
+   std::vector<Culling::Word> bits(Culling::GetWordCount(count));
+
+   for (int i = 0; i < static_cast<int>(ISA::Counter); ++i) {
+      const auto isa = static_cast<ISA>(i);
+      if (not Integrator::IsSupported(isa))
+         continue;
+
+      BENCHMARK_ADVANCED(std::string(Integrator::GetName(isa)) + " - 200k instances")(Catch::Benchmark::Chronometer meter) {
+         meter.measure([&] {
+            Culling::Test(isa, frustum, boxes.GetBounds(), 0, count, bits.data());
+            return bits[0];
+         });
+      };
+   }
+}
+#endif
@@ -0,0 +1,203 @@
+///                                                                           
+/// Langulus::Module::Physics                                                 
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "../source/FieldTree.hpp"
+#include "../source/Morton.hpp"
+#include <Langulus/Testing.hpp>
+#include <random>
+
+using namespace Euclidean;
+
+
+/// A field that trilinear interpolation reproduces exactly                   
+Vec3 LinearField(const Vec3& at) {
+   return {2 * at.x + 1, at.y - at.z, 3};
+}
+
+
+SCENARIO("Adaptive field storage", "[fields]") {
+   GIVEN("A field over a 64 unit cube, up to three levels deep") {
+      FieldTree field;
+      field.SetVolume(Vec3 {-32}, Vec3 {64});
+      field.SetDepth(3);
+
+      WHEN("Adapted around a single point") {
+         const Real x[] {10}, y[] {-5}, z[] {3};
+         REQUIRE(field.Adapt(x, y, z, 1));
+
+         THEN("Only blocks on the way to the point are refined") {
+            // One leaf at the bottom, the siblings of each level above 
+            REQUIRE(field.GetLeafCount() == 1 + 7 * 3);
+            REQUIRE_FALSE(field.Adapt(x, y, z, 1));
+         }
+
+         THEN("Only points in coarser blocks inside the volume need refinement") {
+            REQUIRE_FALSE(field.NeedsRefinement(Vec3 {10, -5, 3}));
+            REQUIRE_FALSE(field.NeedsRefinement(Vec3 {11, -4, 4}));
+            REQUIRE(field.NeedsRefinement(Vec3 {-20, -20, -20}));
+            REQUIRE_FALSE(field.NeedsRefinement(Vec3 {-40, 0, 0}));
+         }
+
+         WHEN("The point leaves the volume") {
+            const Real away[] {100};
+            REQUIRE(field.Adapt(away, y, z, 1));
+
+            THEN("All blocks are coarsened") {
+               REQUIRE(field.GetLeafCount() == 1);
+            }
+         }
+      }
+
+      WHEN("Adapted around points everywhere, and filled") {
+         std::vector<Real> x, y, z;
+         for (Real i = -30; i < 32; i += 4) {
+            for (Real j = -30; j < 32; j += 4) {
+               for (Real k = -30; k < 32; k += 4) {
+                  x.push_back(i);
+                  y.push_back(j);
+                  z.push_back(k);
+               }
+            }
+         }
+         field.SetDepth(2);
+         field.Adapt(x.data(), y.data(), z.data(), x.size());
+         field.Fill(LinearField);
+
+         THEN("Sampling reproduces a linear field, away from the boundary") {
+            REQUIRE(field.GetLeafCount() == 64);
+            std::mt19937 rng {5};
+            std::uniform_real_distribution<Real> place {-31, 31};
+            for (int i = 0; i < 1000; ++i) {
+               const Vec3 at {place(rng), place(rng), place(rng)};
+               const auto sampled = field.Sample(at);
+               const auto exact = LinearField(at);
+               REQUIRE(sampled.x == Approx(exact.x).margin(1e-3));
+               REQUIRE(sampled.y == Approx(exact.y).margin(1e-3));
+               REQUIRE(sampled.z == Approx(exact.z).margin(1e-3));
+            }
+         }
+
+         THEN("Sampling outside the volume gives nothing") {
+            const auto sampled = field.Sample(Vec3 {0, 40, 0});
+            REQUIRE(sampled.x == 0);
+            REQUIRE(sampled.y == 0);
+            REQUIRE(sampled.z == 0);
+         }
+      }
+
+      WHEN("Adapted around a point, and refilled repeatedly") {
+         const Real x[] {10}, y[] {-5}, z[] {3};
+         field.Adapt(x, y, z, 1);
+         Count evaluated = 0;
+         const auto counted = [&](const Vec3& at) {
+            ++evaluated;
+            return LinearField(at);
+         };
+
+         const auto leaves = field.GetLeafCount();
+         REQUIRE(field.Refill(counted) == leaves);
+         REQUIRE(evaluated == leaves * 8 * 8 * 8);
+
+         THEN("Nothing is recomputed, unless invalidated") {
+            evaluated = 0;
+            REQUIRE(field.Refill(counted) == 0);
+            REQUIRE(field.GetReusedCount() == leaves);
+            REQUIRE(evaluated == 0);
+
+            // A box well inside a single leaf                          
+            field.Invalidate(Vec3 {10}, Vec3 {10.5});
+            REQUIRE(field.Refill(counted) == 1);
+            REQUIRE(field.GetReusedCount() == leaves - 1);
+
+            field.Invalidate();
+            REQUIRE(field.Refill(counted) == leaves);
+         }
+
+         THEN("Adapting around the same point leaves nothing to recompute") {
+            evaluated = 0;
+            REQUIRE_FALSE(field.Adapt(x, y, z, 1));
+            REQUIRE(field.Refill(counted) == 0);
+            REQUIRE(field.GetReusedCount() == leaves);
+            REQUIRE(evaluated == 0);
+         }
+
+         THEN("Only new blocks are computed after adaptation") {
+            const Real far[] {-20};
+            field.Adapt(far, far, far, 1);
+            field.Refill(counted);
+            REQUIRE(field.GetRecomputedCount() > 0);
+            REQUIRE(field.GetRecomputedCount() < field.GetLeafCount());
+            REQUIRE(field.GetRecomputedCount() + field.GetReusedCount() == field.GetLeafCount());
+
+            const auto sampled = field.Sample(Vec3 {-20});
+            REQUIRE(sampled.x == Approx(LinearField(Vec3 {-20}).x));
+         }
+      }
+
+      WHEN("Adapted around a cluster, and filled") {
+         const Real x[] {20, 21, 22}, y[] {20, 21, 22}, z[] {20, 21, 22};
+         field.Adapt(x, y, z, 3);
+         field.Fill(LinearField);
+
+         THEN("Sampling is exact inside the finest blocks, and close elsewhere") {
+            const auto fine = field.Sample(Vec3 {21, 21, 21});
+            REQUIRE(fine.x == Approx(43));
+            REQUIRE(fine.y == Approx(0).margin(1e-3));
+
+            // Coarse cells are 4 units wide, and coarse halos aren't   
+            // interpolated, so blocks don't match exactly at their borders
+            std::mt19937 rng {6};
+            std::uniform_real_distribution<Real> place {-30, 30};
+            for (int i = 0; i < 1000; ++i) {
+               const Vec3 at {place(rng), place(rng), place(rng)};
+               const auto sampled = field.Sample(at);
+               REQUIRE(sampled.x == Approx(LinearField(at).x).margin(2 * 4));
+            }
+         }
+
+         THEN("Sampling in batches gives the same values, sorted or not") {
+            std::mt19937 rng {7};
+            std::uniform_real_distribution<Real> place {-40, 40};
+            std::vector<Real> x(1000), y(1000), z(1000);
+            for (Offset i = 0; i < x.size(); ++i) {
+               x[i] = place(rng);
+               y[i] = place(rng);
+               z[i] = place(rng);
+            }
+
+            std::vector<Real> ax(x.size()), ay(x.size()), az(x.size());
+            const auto check = [&] {
+               field.Sample(x.data(), y.data(), z.data(), x.size(),
+                  ax.data(), ay.data(), az.data());
+               for (Offset i = 0; i < x.size(); ++i) {
+                  const auto single = field.Sample(Vec3 {x[i], y[i], z[i]});
+                  REQUIRE(ax[i] == Approx(single.x).margin(1e-3));
+                  REQUIRE(ay[i] == Approx(single.y).margin(1e-3));
+                  REQUIRE(az[i] == Approx(single.z).margin(1e-3));
+               }
+            };
+            check();
+
+            const auto curve = Morton::Quantizer::Fit(x.data(), y.data(), z.data(), x.size());
+            std::vector<uint64_t> keys(x.size());
+            std::vector<uint32_t> order;
+            Morton::Scratch scratch;
+            for (Offset i = 0; i < x.size(); ++i)
+               keys[i] = curve(x[i], y[i], z[i]);
+            Morton::Sort(keys, order, scratch);
+
+            const auto unsorted = std::make_tuple(x, y, z);
+            for (Offset i = 0; i < x.size(); ++i) {
+               x[i] = std::get<0>(unsorted)[order[i]];
+               y[i] = std::get<1>(unsorted)[order[i]];
+               z[i] = std::get<2>(unsorted)[order[i]];
+            }
+            check();
+         }
+      }
+   }
+}
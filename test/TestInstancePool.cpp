@@ -0,0 +1,126 @@
+///                                                                           
+/// Langulus::Module::Physics                                                 
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "../source/InstancePool.hpp"
+#include <Langulus/Testing.hpp>
+
+using namespace Euclidean;
+
+
+/// Get a distinct owner for a slot - the pool never dereferences owners      
+///   @param index - the index of the owner                                   
+///   @return the owner                                                       
+Instance* GetPoolOwner(Offset index) {
+   static char owners[16];
+   return reinterpret_cast<Instance*>(owners + index);
+}
+
+
+SCENARIO("Instance state pool", "[instances]") {
+   GIVEN("A pool with four awake instances in a row, every other one solid") {
+      InstancePool pool;
+      for (Offset i = 0; i < 4; ++i) {
+         Math::TInstance<Vec3> data;
+         data.mPosition = Vec3(Real(i), 0, 0);
+         data.mSolid = i % 2;
+         const auto slot = pool.Allocate(GetPoolOwner(i));
+         pool.Load(slot, data);
+      }
+      pool.mActiveCount = 4;
+
+      WHEN("A slot in the middle is released") {
+         pool.Release(1);
+
+         THEN("The last slot takes its place, along with its owner and state") {
+            REQUIRE(pool.GetCount() == 3);
+            REQUIRE(pool.GetActiveCount() == 3);
+            REQUIRE(pool.mOwners[1] == GetPoolOwner(3));
+            REQUIRE(pool.mPosition.Get(1) == Vec3(3, 0, 0));
+            REQUIRE(pool.mSolid[1]);
+            REQUIRE(pool.mOwners[0] == GetPoolOwner(0));
+            REQUIRE(pool.mOwners[2] == GetPoolOwner(2));
+         }
+      }
+
+      WHEN("The last slot is released") {
+         pool.Release(3);
+
+         THEN("No other slot is moved") {
+            REQUIRE(pool.GetCount() == 3);
+            for (Offset i = 0; i < 3; ++i) {
+               REQUIRE(pool.mOwners[i] == GetPoolOwner(i));
+               REQUIRE(pool.mPosition.Get(i) == Vec3(Real(i), 0, 0));
+            }
+         }
+      }
+
+      WHEN("Two slots are exchanged") {
+         pool.Swap(0, 3);
+
+         THEN("Owners and state follow their slots") {
+            REQUIRE(pool.mOwners[0] == GetPoolOwner(3));
+            REQUIRE(pool.mOwners[3] == GetPoolOwner(0));
+            REQUIRE(pool.mPosition.Get(0) == Vec3(3, 0, 0));
+            REQUIRE(pool.mPosition.Get(3) == Vec3(0, 0, 0));
+            REQUIRE(pool.mSolid[0]);
+            REQUIRE(not pool.mSolid[3]);
+         }
+      }
+
+      WHEN("A fixed step moves a slot") {
+         pool.mVelocity.Set(0, Vec3(1, 0, 0));
+         pool.SavePrevious(0, 4);
+         pool.Integrate(Real(0.1));
+
+         THEN("It is rendered between its last two positions") {
+            REQUIRE(pool.GetInterpolated(0, 0) == Vec3(0, 0, 0));
+            REQUIRE(pool.GetInterpolated(0, Real(0.5)).x == Approx(0.05));
+            REQUIRE(pool.GetInterpolated(0, 1) == pool.mPosition.Get(0));
+         }
+
+         AND_WHEN("Only its velocity is changed from outside") {
+            Math::TInstance<Vec3> data;
+            pool.Store(0, data);
+            data.mVelocity = Vec3(2, 0, 0);
+            pool.Load(0, data);
+
+            THEN("It is still rendered between its last two positions") {
+               REQUIRE(pool.GetInterpolated(0, Real(0.5)).x == Approx(0.05));
+            }
+         }
+
+         AND_WHEN("It is teleported") {
+            Math::TInstance<Vec3> data;
+            pool.Store(0, data);
+            data.mPosition = Vec3(5, 0, 0);
+            pool.Load(0, data);
+
+            THEN("It is rendered where it was teleported to") {
+               REQUIRE(pool.GetInterpolated(0, Real(0.5)) == Vec3(5, 0, 0));
+            }
+         }
+      }
+
+      WHEN("A slot moves by amounts that don't add up exactly") {
+         pool.mPrevious.Set(2, Vec3(Real(0.1), Real(0.7), 0));
+         pool.mPosition.Set(2, Vec3(Real(0.3), Real(-0.1), 0));
+
+         THEN("It is rendered exactly at its position, when not interpolated") {
+            REQUIRE(pool.GetInterpolated(2, 1) == pool.mPosition.Get(2));
+         }
+      }
+
+      WHEN("The pool is cleared") {
+         pool.Clear();
+
+         THEN("No slots remain") {
+            REQUIRE(pool.GetCount() == 0);
+            REQUIRE(pool.GetActiveCount() == 0);
+         }
+      }
+   }
+}
@@ -0,0 +1,137 @@
+///                                                                           
+/// Langulus::Module::Physics                                                 
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "../source/Integrator.hpp"
+#include <Langulus/Testing.hpp>
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace Euclidean;
+using Integrator::ISA;
+
+
+/// All arrays of a single integrated component                               
+struct LaneData {
+   std::vector<Real> mArrays[10];
+
+   LaneData(Count count, unsigned seed) {
+      std::mt19937 rng {seed};
+      std::uniform_real_distribution<Real> dist {-100, 100};
+      for (auto& array : mArrays) {
+         array.resize(count);
+         for (auto& value : array)
+            value = dist(rng);
+      }
+   }
+
+   auto GetLane() noexcept -> Integrator::Lane {
+      return {
+         mArrays[0].data(), mArrays[1].data(), mArrays[2].data(),
+         mArrays[3].data(), mArrays[4].data(), mArrays[5].data(),
+         mArrays[6].data(), mArrays[7].data(), mArrays[8].data(),
+         mArrays[9].data()
+      };
+   }
+
+   bool operator == (const LaneData& rhs) const noexcept {
+      for (int i = 0; i < 10; ++i) {
+         if (0 != std::memcmp(mArrays[i].data(), rhs.mArrays[i].data(),
+            mArrays[i].size() * sizeof(Real)))
+            return false;
+      }
+      return true;
+   }
+};
+
+
+SCENARIO("Batched instance integration", "[integrator]") {
+   // Odd count, so that every kernel has a scalar remainder            
+   constexpr Count count = 1021;
+   constexpr Real dt = Real(1) / Real(60);
+
+   for (int i = 0; i < static_cast<int>(ISA::Counter); ++i) {
+      const auto isa = static_cast<ISA>(i);
+      if (not Integrator::IsSupported(isa))
+         continue;
+
+      GIVEN(std::string("Random instance state and the ") + Integrator::GetName(isa) + " kernel") {
+         LaneData scalar {count, 42};
+         LaneData batched {count, 42};
+
+         WHEN("Integrated over several steps") {
+            for (int step = 0; step < 8; ++step) {
+               Integrator::Integrate(ISA::Scalar, scalar.GetLane(), 0, count, dt);
+               Integrator::Integrate(isa, batched.GetLane(), 0, count, dt);
+            }
+
+            THEN("Results are bit-identical to the scalar kernel") {
+               REQUIRE(scalar == batched);
+            }
+         }
+
+         WHEN("Integrated over a range that isn't aligned to the kernel width") {
+            Integrator::Integrate(ISA::Scalar, scalar.GetLane(), 3, count - 5, dt);
+            Integrator::Integrate(isa, batched.GetLane(), 3, count - 5, dt);
+
+            THEN("Results match, and slots outside the range are untouched") {
+               const LaneData original {count, 42};
+               REQUIRE(scalar == batched);
+               for (int a = 0; a < 10; ++a) {
+                  for (Offset s : {Offset {0}, Offset {1}, Offset {2}, count - 5, count - 1})
+                     REQUIRE(batched.mArrays[a][s] == original.mArrays[a][s]);
+               }
+            }
+         }
+      }
+   }
+
+   GIVEN("The best instruction set") {
+      const auto isa = Integrator::GetBestISA();
+
+      THEN("It is supported, and processes at least one instance at a time") {
+         REQUIRE(Integrator::IsSupported(isa));
+         REQUIRE(Integrator::GetWidth(isa) >= 1);
+      }
+   }
+}
+
+#ifdef LANGULUS_STD_BENCHMARK
+SCENARIO("Batched instance integration throughput", "[integrator][!benchmark]") {
+   constexpr Count count = 100'000;
+   constexpr Real dt = Real(1) / Real(60);
+
+   for (int i = 0; i < static_cast<int>(ISA::Counter); ++i) {
+      const auto isa = static_cast<ISA>(i);
+      if (not Integrator::IsSupported(isa))
+         continue;
+
+      // Three lanes, one for each vector component                     
+      LaneData x {count, 1}, y {count, 2}, z {count, 3};
+      const auto run = [&] {
+         Integrator::Integrate(isa, x.GetLane(), 0, count, dt);
+         Integrator::Integrate(isa, y.GetLane(), 0, count, dt);
+         Integrator::Integrate(isa, z.GetLane(), 0, count, dt);
+      };
+
+      BENCHMARK_ADVANCED(std::string(Integrator::GetName(isa)) + " - 100k instances")(Catch::Benchmark::Chronometer meter) {
+         meter.measure(run);
+      };
+
+      // Report throughput in instances per second                      
+      constexpr int repeats = 100;
+      const auto start = std::chrono::steady_clock::now();
+      for (int r = 0; r < repeats; ++r)
+         run();
+      const std::chrono::duration<double> elapsed =
+         std::chrono::steady_clock::now() - start;
+      Logger::Info(Integrator::GetName(isa), ": ",
+         static_cast<Count>(count * repeats / elapsed.count()), " instances/s");
+   }
+}
+#endif
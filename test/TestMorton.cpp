@@ -0,0 +1,175 @@
+///                                                                           
+/// Langulus::Module::Physics                                                 
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "../source/ParticlePool.hpp"
+#include <Langulus/Testing.hpp>
+#include <algorithm>
+#include <numeric>
+#include <random>
+
+using namespace Euclidean;
+
+
+/// Random keys, with plenty of duplicates to check stability                 
+auto RandomKeys(Count count, unsigned seed) {
+   std::mt19937_64 rng {seed};
+   std::vector<uint64_t> keys(count);
+   for (auto& key : keys)
+      key = rng() & ((uint64_t {1} << (Morton::AxisBits * 3)) - 1) & ~uint64_t {0xFF};
+   return keys;
+}
+
+/// Fill a pool with particles at random positions, tagged by their red       
+auto FillRandomly(ParticlePool& pool, Count count, unsigned seed) {
+   std::mt19937 rng {seed};
+   std::uniform_real_distribution<Real> dist {-50, 50};
+   for (Offset i = 0; i < count; ++i) {
+      ParticlePool::Particle p;
+      p.mPosition = Vec3 {dist(rng), dist(rng), dist(rng)};
+      p.mRed = static_cast<Real>(i);
+      p.mLifetime = 10;
+      pool.Emit(p);
+   }
+}
+
+
+SCENARIO("Morton keys", "[morton]") {
+   GIVEN("Coordinates along a single axis") {
+      THEN("Bits are spread three apart, and axes are interleaved") {
+         REQUIRE(Morton::Spread(0b1011) == 0b001000001001);
+         REQUIRE(Morton::Encode(1, 0, 0) == 0b001);
+         REQUIRE(Morton::Encode(0, 1, 0) == 0b010);
+         REQUIRE(Morton::Encode(0, 0, 1) == 0b100);
+         REQUIRE(Morton::Encode(0x1FFFFF, 0x1FFFFF, 0x1FFFFF) == (uint64_t {1} << 63) - 1);
+      }
+   }
+
+   GIVEN("A quantizer fitted around two points") {
+      const Real x[] {-1, 1}, y[] {-1, 1}, z[] {-1, 1};
+      const auto quantizer = Morton::Quantizer::Fit(x, y, z, 2);
+
+      THEN("Corners map to the ends of the curve, and outliers are clamped") {
+         REQUIRE(quantizer(-1, -1, -1) == 0);
+         REQUIRE(quantizer(1, 1, 1) == (uint64_t {1} << 63) - 1);
+         REQUIRE(quantizer(-5, -5, -5) == 0);
+         REQUIRE(quantizer(5, 5, 5) == (uint64_t {1} << 63) - 1);
+      }
+   }
+}
+
+SCENARIO("Morton key radix sort", "[morton]") {
+   Scheduler scheduler {3};
+
+   for (bool parallel : {false, true}) {
+      GIVEN(std::string("200k random keys, sorted ") + (parallel ? "in parallel" : "serially")) {
+         const auto original = RandomKeys(200'000, 5);
+         auto keys = original;
+         std::vector<uint32_t> order;
+         Morton::Scratch scratch;
+         Morton::Sort(keys, order, scratch, parallel ? &scheduler : nullptr);
+
+         THEN("The result matches a stable sort") {
+            std::vector<uint32_t> expected(original.size());
+            std::iota(expected.begin(), expected.end(), 0u);
+            std::stable_sort(expected.begin(), expected.end(),
+               [&](uint32_t a, uint32_t b) { return original[a] < original[b]; });
+
+            REQUIRE(order == expected);
+            for (Offset i = 0; i < keys.size(); ++i)
+               REQUIRE(keys[i] == original[order[i]]);
+         }
+      }
+   }
+}
+
+SCENARIO("Sorting particles along a Z-order curve", "[morton][particles]") {
+   Scheduler scheduler {3};
+
+   GIVEN("A pool with particles in random order") {
+      ParticlePool pool {50'000};
+      FillRandomly(pool, 40'000, 3);
+      std::vector<ParticlePool::Handle> handles;
+      for (Offset i = 0; i < pool.GetCount(); ++i)
+         handles.push_back(pool.GetHandle(i));
+
+      THEN("Coherence is low") {
+         REQUIRE(pool.MeasureCoherence() < Real(0.6));
+      }
+
+      WHEN("Sorted") {
+         const auto before = pool.GetParticle(123);
+         pool.Sort(&scheduler);
+
+         THEN("Coherence is perfect, and handles follow their particles") {
+            REQUIRE(pool.MeasureCoherence() == 1);
+            REQUIRE(pool.GetCount() == 40'000);
+
+            for (Offset i = 0; i < handles.size(); ++i) {
+               const auto at = pool.GetIndex(handles[i]);
+               REQUIRE(at < pool.GetCount());
+               REQUIRE(pool.GetParticle(at).mRed == static_cast<Real>(i));
+               REQUIRE(pool.GetHandle(at) == handles[i]);
+            }
+
+            const auto after = pool.GetParticle(pool.GetIndex(handles[123]));
+            REQUIRE(after.mPosition.x == before.mPosition.x);
+            REQUIRE(after.mPosition.y == before.mPosition.y);
+            REQUIRE(after.mPosition.z == before.mPosition.z);
+            REQUIRE(after.mLifetime == before.mLifetime);
+         }
+      }
+
+      WHEN("Every third particle dies, and the pool is compacted") {
+         for (Offset i = 0; i < pool.GetCount(); i += 3)
+            pool.Kill(i);
+         pool.Compact();
+
+         THEN("Dead handles are invalid, and live ones still find their particles") {
+            for (Offset i = 0; i < handles.size(); ++i) {
+               const auto at = pool.GetIndex(handles[i]);
+               if (i % 3 == 0)
+                  REQUIRE(at == ParticlePool::InvalidHandle);
+               else
+                  REQUIRE(pool.GetParticle(at).mRed == static_cast<Real>(i));
+            }
+         }
+
+         THEN("Emitting reuses the freed handles") {
+            FillRandomly(pool, 1000, 4);
+            const auto handle = pool.GetHandle(pool.GetCount() - 1);
+            REQUIRE(handle < 40'000);
+            REQUIRE(pool.GetIndex(handle) == pool.GetCount() - 1);
+         }
+      }
+
+      WHEN("Cleared") {
+         pool.Clear();
+
+         THEN("No handle is valid") {
+            for (auto handle : handles)
+               REQUIRE(pool.GetIndex(handle) == ParticlePool::InvalidHandle);
+         }
+      }
+   }
+}
+
+#ifdef LANGULUS_STD_BENCHMARK
+SCENARIO("Morton re-sorting", "[morton][particles][!benchmark]") {
+   Scheduler scheduler;
+   ParticlePool pool {1'000'000};
+   FillRandomly(pool, 1'000'000, 1);
+
+   for (bool parallel : {false, true}) {
+      BENCHMARK_ADVANCED(std::string("Sort ") + (parallel ? "in parallel" : "serially") + " - 1M particles")(Catch::Benchmark::Chronometer meter) {
+         meter.measure([&] {
+            pool.Sort(parallel ? &scheduler : nullptr);
+            return pool.GetCount();
+         });
+      };
+   }
+}
+#endif
@@ -0,0 +1,119 @@
+///                                                                           
+/// Langulus::Module::Physics                                                 
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "../source/Octaves.hpp"
+#include <Langulus/Testing.hpp>
+#include <algorithm>
+#include <random>
+
+using namespace Euclidean;
+
+
+/// Check that every slot is in the bucket of its octave, exactly once        
+///   @param index - the index to check                                       
+///   @param octaves - the expected octave of each slot                       
+bool IsConsistent(const OctaveIndex& index, const std::vector<int>& octaves) {
+   if (index.GetCount() != octaves.size())
+      return false;
+
+   std::vector<int> seen(octaves.size(), 0);
+   bool valid = true;
+   index.ForEach([&](int octave, const OctaveIndex::Bucket& bucket) {
+      valid &= not bucket.empty();
+      for (auto slot : bucket) {
+         valid &= slot < octaves.size() and octaves[slot] == octave;
+         if (slot < octaves.size())
+            ++seen[slot];
+      }
+   });
+   return valid and std::all_of(seen.begin(), seen.end(),
+      [](int count) { return count == 1; });
+}
+
+
+SCENARIO("Bucketing instances by octave", "[octaves]") {
+   GIVEN("An index with slots in random octaves") {
+      std::mt19937 rng {7};
+      std::uniform_int_distribution<int> pick {-3, 3};
+      OctaveIndex index;
+      std::vector<int> octaves;
+      for (Offset slot = 0; slot < 500; ++slot) {
+         octaves.push_back(pick(rng));
+         index.Insert(slot, octaves.back());
+      }
+
+      THEN("Every slot is in its bucket") {
+         REQUIRE(IsConsistent(index, octaves));
+         REQUIRE(index.GetBucketCount() == 7);
+      }
+
+      WHEN("Slots change octaves") {
+         Count changed = 0;
+         for (Offset slot = 0; slot < octaves.size(); slot += 3) {
+            octaves[slot] = pick(rng) + 10;
+            changed += index.Update(slot, octaves[slot]);
+         }
+
+         THEN("They are moved to their new buckets") {
+            REQUIRE(changed == 167);
+            REQUIRE(IsConsistent(index, octaves));
+            REQUIRE(not index.Update(0, octaves[0]));
+         }
+      }
+
+      WHEN("Slots are removed the way the instance pool removes them") {
+         while (octaves.size() > 100) {
+            const Offset slot = rng() % octaves.size();
+            index.Remove(slot);
+            octaves[slot] = octaves.back();
+            octaves.pop_back();
+         }
+
+         THEN("The last slot takes the place of each removed one") {
+            REQUIRE(IsConsistent(index, octaves));
+         }
+      }
+
+      WHEN("Slots are swapped") {
+         for (Offset slot = 0; slot + 7 < octaves.size(); slot += 5) {
+            index.Swap(slot, slot + 7);
+            std::swap(octaves[slot], octaves[slot + 7]);
+         }
+         index.Swap(3, 3);
+
+         THEN("Both slots are renamed in their buckets") {
+            REQUIRE(IsConsistent(index, octaves));
+         }
+      }
+
+      WHEN("All slots are removed") {
+         while (not octaves.empty()) {
+            index.Remove(0);
+            octaves[0] = octaves.back();
+            octaves.pop_back();
+         }
+
+         THEN("No buckets remain") {
+            REQUIRE(index.GetBucketCount() == 0);
+            REQUIRE(index.GetBucket(0) == nullptr);
+         }
+      }
+
+      WHEN("Iterating buckets visible from octave 2") {
+         std::vector<int> visited;
+         index.ForEachVisible(2, [&](int octave, const OctaveIndex::Bucket&) {
+            visited.push_back(octave);
+         });
+
+         THEN("Octaves that are always culled are skipped") {
+            REQUIRE(visited == std::vector<int> {1, 2, 3});
+            REQUIRE(not OctaveIndex::CanBeVisible(0, 2));
+            REQUIRE(OctaveIndex::CanBeVisible(1, 2));
+         }
+      }
+   }
+}
@@ -0,0 +1,180 @@
+///                                                                           
+/// Langulus::Module::Physics                                                 
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "../source/ParticleIntegrator.hpp"
+#include "../source/Scheduler.hpp"
+#include <Langulus/Testing.hpp>
+#include <chrono>
+#include <cstring>
+#include <random>
+
+using namespace Euclidean;
+using Integrator::ISA;
+
+
+/// Fill a pool with random particles                                         
+///   @param count - number of particles to emit                              
+///   @param seed - the random seed                                           
+auto RandomParticles(Count count, unsigned seed) {
+   std::mt19937 rng {seed};
+   std::uniform_real_distribution<Real> value {-100, 100};
+   std::uniform_real_distribution<Real> unit {0, 1};
+   ParticlePool pool {count};
+   for (Offset i = 0; i < count; ++i) {
+      ParticlePool::Particle p;
+      p.mPosition = Vec3 {value(rng), value(rng), value(rng)};
+      p.mVelocity = Vec3 {value(rng), value(rng), value(rng)};
+      p.mRed = unit(rng);
+      p.mGreen = unit(rng);
+      p.mBlue = unit(rng);
+      p.mAlpha = unit(rng);
+      p.mLifetime = unit(rng) * 2;
+      pool.Emit(p);
+   }
+   return pool;
+}
+
+/// Compare every stream of two pools bit by bit                              
+bool Identical(const ParticlePool& a, const ParticlePool& b) {
+   if (a.GetCount() != b.GetCount())
+      return false;
+   for (int s = 0; s < ParticlePool::StreamCount; ++s) {
+      const auto stream = static_cast<ParticlePool::Stream>(s);
+      if (0 != std::memcmp(a.GetStream(stream), b.GetStream(stream), a.GetCount() * sizeof(Real)))
+         return false;
+   }
+   return true;
+}
+
+
+SCENARIO("Batched particle integration", "[particles]") {
+   ParticleIntegrator::Parameters params;
+   params.mAcceleration = Vec3 {0, Real(-9.8), 0};
+   constexpr Real dt = Real(1) / Real(60);
+
+   for (int i = 0; i < static_cast<int>(ISA::Counter); ++i) {
+      const auto isa = static_cast<ISA>(i);
+      if (not Integrator::IsSupported(isa))
+         continue;
+
+      GIVEN(std::string("Random particles and the ") + Integrator::GetName(isa) + " kernel") {
+         // Odd count, so that every kernel has a scalar remainder      
+         constexpr Count count = 1021;
+         auto scalar = RandomParticles(count, 42);
+         auto batched = RandomParticles(count, 42);
+
+         WHEN("Integrated over their whole lifetime") {
+            for (int step = 0; step < 150; ++step) {
+               ParticleIntegrator::Integrate(ISA::Scalar, scalar, params, 0, count, dt);
+               ParticleIntegrator::Integrate(isa, batched, params, 0, count, dt);
+            }
+
+            THEN("Results are bit-identical to the scalar kernel") {
+               REQUIRE(Identical(scalar, batched));
+            }
+
+            THEN("Dead particles have faded to the fade colour") {
+               Count dead = 0;
+               for (Offset p = 0; p < count; ++p) {
+                  if (batched.IsAlive(p))
+                     continue;
+                  ++dead;
+                  REQUIRE(batched.GetParticle(p).mAlpha == params.mFadeAlpha);
+                  REQUIRE(batched.GetParticle(p).mRed == params.mFadeRed);
+               }
+               REQUIRE(dead > 0);
+               REQUIRE(batched.Compact() == dead);
+            }
+         }
+
+         WHEN("Integrated into the back block, while published particles are read") {
+            bool untouched = true;
+            for (int step = 0; step < 150; ++step) {
+               ParticleIntegrator::Integrate(ISA::Scalar, scalar, params, 0, count, dt);
+
+               batched.Publish();
+               const auto view = batched.GetView();
+               const std::vector<Real> published(view.mPosition[0], view.mPosition[0] + view.mCount);
+               ParticleIntegrator::IntegrateToBack(isa, batched, params, 0, count, dt);
+               untouched &= 0 == std::memcmp(published.data(), view.mPosition[0], count * sizeof(Real));
+               batched.Flip();
+            }
+
+            THEN("Results are bit-identical, and the published view stays intact") {
+               REQUIRE(Identical(scalar, batched));
+               REQUIRE(untouched);
+               REQUIRE(batched.GetGeneration() == 150);
+            }
+         }
+      }
+   }
+
+   GIVEN("A single particle") {
+      ParticlePool pool {1};
+      ParticlePool::Particle p;
+      p.mVelocity = Vec3 {1, 0, 0};
+      p.mLifetime = 1;
+      pool.Emit(p);
+
+      WHEN("Integrated for half its lifetime") {
+         ParticleIntegrator::Integrate(ISA::Scalar, pool, params, 0, 1, Real(0.5));
+
+         THEN("It moves, accelerates, ages and fades halfway") {
+            const auto result = pool.GetParticle(0);
+            REQUIRE(result.mPosition.x == Real(0.5));
+            REQUIRE(result.mVelocity.y == Real(-4.9));
+            REQUIRE(result.mAlpha == Real(0.5));
+            REQUIRE(pool.GetStream(ParticlePool::Age)[0] == Real(0.5));
+         }
+      }
+   }
+}
+
+#ifdef LANGULUS_STD_BENCHMARK
+SCENARIO("Batched particle integration throughput", "[particles][!benchmark]") {
+   constexpr Count count = 1'000'000;
+   constexpr Count chunk = 16384;
+   constexpr Real dt = Real(1) / Real(60);
+   const ParticleIntegrator::Parameters params;
+   Scheduler scheduler;
+
+   for (int i = 0; i < static_cast<int>(ISA::Counter); ++i) {
+      const auto isa = static_cast<ISA>(i);
+      if (not Integrator::IsSupported(isa))
+         continue;
+
+      auto pool = RandomParticles(count, 1);
+      for (bool parallel : {false, true}) {
+         const auto run = [&] {
+            if (parallel) {
+               scheduler.ParallelFor(0, count, chunk, [&](Offset from, Offset to) {
+                  ParticleIntegrator::Integrate(isa, pool, params, from, to, dt);
+               });
+            }
+            else
+               ParticleIntegrator::Integrate(isa, pool, params, 0, count, dt);
+         };
+
+         const std::string name = std::string(Integrator::GetName(isa))
+            + (parallel ? " parallel" : "") + " - 1M particles";
+         BENCHMARK_ADVANCED(name.c_str())(Catch::Benchmark::Chronometer meter) {
+            meter.measure(run);
+         };
+
+         // Report throughput in particles per millisecond              
+         constexpr int repeats = 20;
+         const auto start = std::chrono::steady_clock::now();
+         for (int r = 0; r < repeats; ++r)
+            run();
+         const std::chrono::duration<double, std::milli> elapsed =
+            std::chrono::steady_clock::now() - start;
+         Logger::Info(name, ": ",
+            static_cast<Count>(count * repeats / elapsed.count()), " particles/ms");
+      }
+   }
+}
+#endif
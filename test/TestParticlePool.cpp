@@ -0,0 +1,157 @@
+///                                                                           
+/// Langulus::Module::Physics                                                 
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "../source/ParticlePool.hpp"
+#include <Langulus/Testing.hpp>
+#include <atomic>
+#include <thread>
+
+using namespace Euclidean;
+
+
+SCENARIO("Pooled particle storage", "[particles]") {
+   GIVEN("A pool with a capacity of 1000 particles") {
+      ParticlePool pool {1000};
+      const Real* stream = pool.GetStream(ParticlePool::PositionX);
+
+      WHEN("Filled beyond capacity") {
+         Count emitted = 0;
+         for (int i = 0; i < 1500; ++i) {
+            ParticlePool::Particle p;
+            p.mPosition = Vec3 {Real(i), 0, 0};
+            emitted += pool.Emit(p);
+         }
+
+         THEN("Only the capacity is emitted, without reallocating") {
+            REQUIRE(emitted == 1000);
+            REQUIRE(pool.GetCount() == 1000);
+            REQUIRE(pool.GetStream(ParticlePool::PositionX) == stream);
+            REQUIRE(pool.GetParticle(999).mPosition.x == 999);
+         }
+      }
+
+      WHEN("Every third particle is killed, and the pool is compacted") {
+         for (int i = 0; i < 900; ++i) {
+            ParticlePool::Particle p;
+            p.mPosition = Vec3 {Real(i), 0, 0};
+            p.mVelocity = Vec3 {0, Real(i), 0};
+            p.mAlpha = Real(i);
+            pool.Emit(p);
+         }
+         for (Offset i = 0; i < 900; i += 3)
+            pool.Kill(i);
+         const auto removed = pool.Compact();
+
+         THEN("Survivors are packed at the front, in their original order") {
+            REQUIRE(removed == 300);
+            REQUIRE(pool.GetCount() == 600);
+            for (Offset i = 0; i < pool.GetCount(); ++i) {
+               const Real original = Real(i / 2 * 3 + i % 2 + 1);
+               const auto p = pool.GetParticle(i);
+               REQUIRE(pool.IsAlive(i));
+               REQUIRE(p.mPosition.x == original);
+               REQUIRE(p.mVelocity.y == original);
+               REQUIRE(p.mAlpha == original);
+            }
+            REQUIRE(pool.Compact() == 0);
+         }
+      }
+
+      WHEN("Particles outlive their lifetime") {
+         for (int i = 0; i < 10; ++i) {
+            ParticlePool::Particle p;
+            p.mLifetime = Real(i);
+            pool.Emit(p);
+         }
+         auto age = pool.GetStream(ParticlePool::Age);
+         for (Offset i = 0; i < pool.GetCount(); ++i)
+            age[i] = Real(4.5);
+
+         THEN("Compaction removes them") {
+            REQUIRE(pool.Compact() == 5);
+            REQUIRE(pool.GetParticle(0).mLifetime == 5);
+         }
+      }
+
+      WHEN("Particles are published") {
+         for (int i = 0; i < 100; ++i) {
+            ParticlePool::Particle p;
+            p.mPosition = Vec3 {Real(i), 0, 0};
+            p.mBlue = Real(i);
+            pool.Emit(p);
+         }
+
+         REQUIRE(pool.GetGeneration() == 0);
+         REQUIRE(pool.GetView().mCount == 0);
+         pool.Publish();
+         const auto view = pool.GetView();
+
+         THEN("The view shows positions and colours of all particles") {
+            REQUIRE(pool.GetGeneration() == 1);
+            REQUIRE(view.mGeneration == 1);
+            REQUIRE(view.mCount == 100);
+            REQUIRE(view.mPosition[0] == pool.GetStream(ParticlePool::PositionX));
+            REQUIRE(view.mPosition[0][42] == 42);
+            REQUIRE(view.mColour[2][42] == 42);
+         }
+
+         THEN("Flipping leaves the view intact, until the next publish") {
+            pool.Flip();
+            REQUIRE(pool.GetStream(ParticlePool::PositionX) != view.mPosition[0]);
+            REQUIRE(pool.GetView().mPosition[0] == view.mPosition[0]);
+            pool.Publish();
+            REQUIRE(pool.GetView().mGeneration == 2);
+            REQUIRE(pool.GetView().mPosition[0] == pool.GetStream(ParticlePool::PositionX));
+         }
+
+         THEN("Clearing publishes an empty view") {
+            pool.Clear();
+            REQUIRE(pool.GetGeneration() == 2);
+            REQUIRE(pool.GetView().mCount == 0);
+         }
+
+         THEN("Views read while publishing are never torn") {
+            // Odd generations are published from the first block       
+            const Real* odd = view.mPosition[0];
+            pool.Flip();
+            pool.Publish();
+            const Real* even = pool.GetView().mPosition[0];
+
+            std::atomic<bool> done = false;
+            Count torn = 0;
+            std::thread reader {[&] {
+               while (not done.load()) {
+                  const auto v = pool.GetView();
+                  torn += v.mPosition[0] != (v.mGeneration % 2 ? odd : even)
+                       or v.mColour[3] != v.mPosition[0] + ParticlePool::Alpha * 1000
+                       or v.mCount != 100;
+               }
+            }};
+
+            for (int i = 0; i < 100'000; ++i) {
+               pool.Flip();
+               pool.Publish();
+            }
+            done = true;
+            reader.join();
+            REQUIRE(torn == 0);
+         }
+      }
+
+      WHEN("The capacity is reduced below the live count") {
+         for (int i = 0; i < 100; ++i)
+            pool.Emit({});
+         pool.SetCapacity(40);
+
+         THEN("Excess particles are discarded") {
+            REQUIRE(pool.GetCount() == 40);
+            REQUIRE(pool.GetCapacity() == 40);
+            REQUIRE(pool.IsAlive(39));
+         }
+      }
+   }
+}
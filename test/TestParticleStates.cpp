@@ -0,0 +1,164 @@
+///                                                                           
+/// Langulus::Module::Physics                                                 
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "../source/ParticleStates.hpp"
+#include <Langulus/Testing.hpp>
+#include <random>
+
+using namespace Euclidean;
+
+
+/// Check that every state's group is contiguous, and contains only particles 
+/// in that state                                                             
+bool IsGroupedByState(const ParticlePool& pool) {
+   const auto states = pool.GetStates();
+   Offset end = 0;
+   for (Count s = 0; s < ParticlePool::StateLimit; ++s) {
+      const auto [from, to] = pool.GetGroup(static_cast<ParticlePool::State>(s));
+      if (from != end)
+         return false;
+      for (Offset i = from; i < to; ++i) {
+         if (states[i] != s)
+            return false;
+      }
+      end = to;
+   }
+   return end == pool.GetCount() and pool.GetGroupedCount() == end;
+}
+
+
+SCENARIO("Table-driven particle state transitions", "[particles]") {
+   GIVEN("Sparks that turn into embers, and then into smoke that dies") {
+      ParticleStates table;
+      ParticleStates::Description spark, ember, smoke;
+      spark.mUntil = Real(0.5);
+      ember.mUntil = 1;
+      smoke.mUntil = 2;
+      const auto emberState = table.Add(ember);
+      const auto smokeState = table.Add(smoke);
+      spark.mNext = emberState;
+      ember.mNext = smokeState;
+      table.Set(0, spark);
+      table.Set(emberState, ember);
+
+      ParticlePool pool {1000};
+      std::mt19937 rng {17};
+      std::uniform_real_distribution<Real> place {-10, 10};
+      std::uniform_real_distribution<Real> age {0, Real(2.5)};
+      ParticlePool::Handle handles[600];
+      for (auto& handle : handles) {
+         ParticlePool::Particle p;
+         p.mPosition = Vec3 {place(rng), place(rng), place(rng)};
+         p.mLifetime = 10;
+         REQUIRE(pool.Emit(p));
+         handle = pool.GetHandle(pool.GetCount() - 1);
+      }
+
+      // Spread particles over all states and ages                      
+      Real* ages = pool.GetStream(ParticlePool::Age);
+      auto states = pool.GetStates();
+      for (Offset i = 0; i < pool.GetCount(); ++i) {
+         ages[i] = age(rng);
+         states[i] = static_cast<ParticlePool::State>(i % 3);
+      }
+
+      WHEN("Particles are grouped") {
+         const bool moved = pool.Group();
+
+         THEN("Each state is a contiguous range, and handles followed") {
+            REQUIRE(moved);
+            REQUIRE(IsGroupedByState(pool));
+            REQUIRE(pool.GetGroup(0).second - pool.GetGroup(0).first == 200);
+            REQUIRE_FALSE(pool.Group());
+            for (Offset i = 0; i < 600; ++i)
+               REQUIRE(pool.GetParticle(pool.GetIndex(handles[i])).mState == i % 3);
+         }
+      }
+
+      WHEN("Old enough particles transition, and are grouped again") {
+         pool.Group();
+         ages = pool.GetStream(ParticlePool::Age);
+         std::vector<Real> before(pool.GetCount());
+         std::vector<ParticlePool::State> previous(pool.GetCount());
+         for (Offset i = 0; i < pool.GetCount(); ++i) {
+            before[i] = ages[i];
+            previous[i] = states[i];
+         }
+         const auto transitioned = table.Transition(pool);
+
+         Count expected = 0;
+         bool correct = true;
+         for (Offset i = 0; i < pool.GetCount(); ++i) {
+            const auto& from = table.Get(previous[i]);
+            const bool fires = before[i] >= from.mUntil;
+            expected += fires;
+            if (fires and from.mNext == ParticleStates::Die)
+               correct &= not pool.IsAlive(i) and states[i] == previous[i];
+            else if (fires)
+               correct &= pool.IsAlive(i) and states[i] == from.mNext;
+            else
+               correct &= pool.IsAlive(i) and states[i] == previous[i];
+         }
+
+         const auto removed = pool.Compact();
+         pool.Group();
+
+         THEN("Each particle moved at most one state, and old smoke died") {
+            REQUIRE(correct);
+            REQUIRE(transitioned == expected);
+            REQUIRE(removed > 0);
+            REQUIRE(IsGroupedByState(pool));
+            for (Offset i = 0; i < pool.GetCount(); ++i)
+               REQUIRE(pool.GetIndex(pool.GetHandle(i)) == i);
+         }
+      }
+
+      WHEN("Grouped particles are killed, and new ones are emitted") {
+         pool.Group();
+         for (Offset i = 0; i < pool.GetCount(); i += 4)
+            pool.Kill(i);
+         pool.Compact();
+         const auto grouped = pool.GetGroupedCount();
+
+         ParticlePool::Particle p;
+         pool.Emit(p);
+
+         THEN("Groups stay valid, and new particles are after them") {
+            REQUIRE(grouped == 450);
+            REQUIRE(pool.GetGroupedCount() == grouped);
+            REQUIRE(pool.GetCount() == grouped + 1);
+            const auto [from, to] = pool.GetGroup(smokeState);
+            REQUIRE(to == grouped);
+            for (Offset i = from; i < to; ++i)
+               REQUIRE(states[i] == smokeState);
+            REQUIRE(pool.Group());
+            REQUIRE(IsGroupedByState(pool));
+         }
+      }
+
+      WHEN("Particles are sorted") {
+         pool.Sort();
+
+         THEN("Particles are grouped, and each group follows the curve") {
+            REQUIRE(IsGroupedByState(pool));
+            REQUIRE(pool.MeasureCoherence() > Real(0.9));
+            for (Offset i = 0; i < 600; ++i)
+               REQUIRE(pool.GetParticle(pool.GetIndex(handles[i])).mState == i % 3);
+         }
+      }
+
+      WHEN("The pool is cleared") {
+         pool.Group();
+         pool.Clear();
+
+         THEN("There are no groups") {
+            REQUIRE(pool.GetGroupedCount() == 0);
+            REQUIRE(IsGroupedByState(pool));
+         }
+      }
+   }
+}
@@ -0,0 +1,108 @@
+///                                                                           
+/// Langulus::Module::Physics                                                 
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "../source/Poisson.hpp"
+#include <Langulus/Testing.hpp>
+#include <cmath>
+
+using namespace Euclidean;
+
+constexpr Real PoissonPi = Real(3.14159265358979323846);
+
+
+/// Refine every leaf of a solver's tree, a number of times                   
+void RefinePoissonTree(Poisson::Tree& tree, int times) {
+   for (int i = 0; i < times; ++i) {
+      tree.forEachLeaf([](Poisson::Node& node) {
+         node.action = AMR::Refine;
+      });
+      tree.restructure();
+   }
+}
+
+/// Call a function with the centre of each inner cell of each leaf, in a     
+/// unit cube, and the cell's potential and source                            
+template<class F>
+void ForEachPoissonCell(Poisson::Tree& tree, F&& call) {
+   tree.forEachLeaf([&](Poisson::Node& node) {
+      const Real cell = Real(1) / Real(Poisson::BlockSize << node.level);
+      AMR::Loop<3>(1, Poisson::BlockSize + 1, [&](const auto& it) {
+         const Vec3 at {
+            (Real(node.position[0] + it[0] - 1) + Real(0.5)) * cell,
+            (Real(node.position[1] + it[1] - 1) + Real(0.5)) * cell,
+            (Real(node.position[2] + it[2] - 1) + Real(0.5)) * cell
+         };
+         call(at, std::get<Poisson::Potential>(node.data)[it],
+                  std::get<Poisson::Source>(node.data)[it]);
+      });
+   });
+}
+
+/// A potential that is zero on the faces of the unit cube, and its source    
+Real PoissonExact(const Vec3& at) {
+   return std::sin(PoissonPi * at.x) * std::sin(PoissonPi * at.y) * std::sin(PoissonPi * at.z);
+}
+
+
+SCENARIO("Multigrid Poisson solver", "[poisson]") {
+   for (int depth : {1, 2}) {
+      GIVEN("A unit cube, refined " + std::to_string(depth) + " times everywhere") {
+         Poisson solver;
+         RefinePoissonTree(solver.GetTree(), depth);
+         solver.SetCellSize(Vec3 {Real(1) / Real(Poisson::BlockSize)});
+         ForEachPoissonCell(solver.GetTree(), [](const Vec3& at, Real& potential, Real& source) {
+            potential = 0;
+            source = -3 * PoissonPi * PoissonPi * PoissonExact(at);
+         });
+
+         WHEN("Solved") {
+            const auto cycles = solver.Solve(Real(1e-3));
+
+            THEN("It converges in a few cycles, regardless of the depth") {
+               REQUIRE(solver.GetResidual() <= Real(1e-3));
+               REQUIRE(cycles <= 12);
+            }
+
+            THEN("The potential is close to the exact one") {
+               // Discretization error shrinks with the square of the cell
+               const Real tolerance = depth == 1 ? Real(0.02) : Real(0.006);
+               ForEachPoissonCell(solver.GetTree(), [&](const Vec3& at, Real& potential, Real&) {
+                  REQUIRE(potential == Approx(PoissonExact(at)).margin(tolerance));
+               });
+            }
+
+            THEN("Solving again costs nothing") {
+               REQUIRE(solver.Solve(Real(1e-3)) == 0);
+            }
+         }
+      }
+   }
+
+   GIVEN("A unit cube, refined only in one corner") {
+      Poisson solver;
+      RefinePoissonTree(solver.GetTree(), 1);
+      auto& tree = solver.GetTree();
+      tree.root->children[{0, 0, 0}]->action = AMR::Refine;
+      tree.restructure();
+      solver.SetCellSize(Vec3 {Real(1) / Real(Poisson::BlockSize)});
+      ForEachPoissonCell(tree, [](const Vec3& at, Real& potential, Real& source) {
+         potential = 0;
+         source = -3 * PoissonPi * PoissonPi * PoissonExact(at);
+      });
+
+      WHEN("Solved") {
+         solver.Solve(Real(1e-3));
+
+         THEN("Leaves of all levels converge together") {
+            REQUIRE(solver.GetResidual() <= Real(1e-3));
+            ForEachPoissonCell(tree, [&](const Vec3& at, Real& potential, Real&) {
+               REQUIRE(potential == Approx(PoissonExact(at)).margin(0.05));
+            });
+         }
+      }
+   }
+}
@@ -0,0 +1,109 @@
+///                                                                           
+/// Langulus::Module::Physics                                                 
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "../source/Scheduler.hpp"
+#include <Langulus/Testing.hpp>
+
+using namespace Euclidean;
+
+
+SCENARIO("Work-stealing scheduler", "[scheduler]") {
+   for (Count threads : {Count {0}, Count {1}, Count {4}}) {
+      GIVEN("A scheduler with " + std::to_string(threads) + " workers") {
+         Scheduler scheduler {threads};
+
+         WHEN("A range is split in chunks") {
+            constexpr Count count = 100'000;
+            std::vector<std::atomic<int>> visits(count);
+            scheduler.ParallelFor(0, count, 1000, [&](Offset from, Offset to) {
+               for (Offset i = from; i < to; ++i)
+                  ++visits[i];
+            });
+
+            THEN("Every index is visited exactly once") {
+               for (auto& v : visits)
+                  REQUIRE(v == 1);
+            }
+         }
+
+         WHEN("Phases are executed one after another") {
+            std::vector<int> data(10'000, 0);
+            std::atomic<bool> ordered = true;
+            for (int phase = 1; phase <= 4; ++phase) {
+               scheduler.ParallelFor(0, data.size(), 64, [&](Offset from, Offset to) {
+                  for (Offset i = from; i < to; ++i) {
+                     // Each phase must see the previous one completed  
+                     if (data[i] != phase - 1)
+                        ordered = false;
+                     data[i] = phase;
+                  }
+               });
+            }
+
+            THEN("Each phase acts as a barrier") {
+               REQUIRE(ordered);
+               for (auto v : data)
+                  REQUIRE(v == 4);
+            }
+         }
+
+         WHEN("Parallel loops are nested") {
+            std::atomic<Count> sum = 0;
+            scheduler.ParallelFor(0, 16, 1, [&](Offset from, Offset to) {
+               for (Offset i = from; i < to; ++i) {
+                  scheduler.ParallelFor(0, 1000, 10, [&](Offset a, Offset b) {
+                     sum += b - a;
+                  });
+               }
+            });
+
+            THEN("All inner iterations are executed") {
+               REQUIRE(sum == 16 * 1000);
+            }
+         }
+
+         WHEN("Threads wait for nested loops") {
+            std::atomic<bool> reentered = false;
+            scheduler.ParallelFor(0, 64, 1, [&](Offset, Offset) {
+               thread_local int depth = 0;
+               if (++depth > 1)
+                  reentered = true;
+               scheduler.ParallelFor(0, 1000, 10, [&](Offset, Offset) {
+                  std::this_thread::sleep_for(std::chrono::microseconds(5));
+               });
+               --depth;
+            });
+
+            THEN("They never start another outer chunk while waiting") {
+               REQUIRE(not reentered);
+            }
+         }
+
+         WHEN("Independent tasks are run with a concurrency limit of two") {
+            constexpr Count count = 64;
+            std::vector<std::atomic<int>> runs(count);
+            std::atomic<int> running = 0;
+            std::atomic<int> peak = 0;
+            scheduler.RunTasks(count, 2, [&](Offset i) {
+               const int now = ++running;
+               for (int p = peak; now > p and not peak.compare_exchange_weak(p, now);)
+                  ;
+               std::this_thread::sleep_for(std::chrono::microseconds(50));
+               ++runs[i];
+               --running;
+            });
+
+            THEN("Every task runs once, never more than two at a time") {
+               for (auto& r : runs)
+                  REQUIRE(r == 1);
+               REQUIRE(peak <= 2);
+               REQUIRE(peak >= 1);
+            }
+         }
+      }
+   }
+}
\ No newline at end of file
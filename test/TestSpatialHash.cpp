@@ -0,0 +1,155 @@
+///
+/// Langulus::Module::Physics
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>
+/// Part of the Langulus framework, see https://langulus.com
+///
+/// SPDX-License-Identifier: GPL-3.0-or-later
+///
+#include "../source/SpatialHash.hpp"
+#include <Langulus/Testing.hpp>
+#include <algorithm>
+#include <random>
+
+using namespace Euclidean;
+
+
+/// Random points, one stream per component
+struct Points {
+   std::vector<Real> mX, mY, mZ;
+
+   Points(Count count, Real size, unsigned seed) {
+      std::mt19937 rng {seed};
+      std::uniform_real_distribution<Real> dist {-size, size};
+      for (Offset i = 0; i < count; ++i) {
+         mX.push_back(dist(rng));
+         mY.push_back(dist(rng));
+         mZ.push_back(dist(rng));
+      }
+   }
+
+   /// Find points within a radius by testing all of them
+   auto BruteForce(const Vec3& c, Real radius) const {
+      std::vector<SpatialHash::Index> found;
+      for (Offset i = 0; i < mX.size(); ++i) {
+         const Real dx = mX[i] - c.x, dy = mY[i] - c.y, dz = mZ[i] - c.z;
+         if (dx * dx + dy * dy + dz * dz <= radius * radius)
+            found.push_back(static_cast<SpatialHash::Index>(i));
+      }
+      return found;
+   }
+};
+
+/// Find points within a radius with the grid, sorted for comparison
+auto Query(const SpatialHash& grid, const Vec3& c, Real radius) {
+   std::vector<SpatialHash::Index> found;
+   grid.Query(c, radius, [&](SpatialHash::Index i) {
+      found.push_back(i);
+   });
+   std::sort(found.begin(), found.end());
+   return found;
+}
+
+
+SCENARIO("Spatial hash grid", "[spatialhash]") {
+   Scheduler scheduler {3};
+
+   for (bool parallel : {false, true}) {
+      GIVEN(std::string("100k random points, built ") + (parallel ? "in parallel" : "serially")) {
+         const Points points {100'000, 50, 7};
+         SpatialHash grid {1};
+         grid.Build(points.mX.data(), points.mY.data(), points.mZ.data(),
+            points.mX.size(), parallel ? &scheduler : nullptr);
+
+         THEN("Every point is in the grid") {
+            REQUIRE(grid.GetCount() == 100'000);
+            REQUIRE(grid.GetBucketCount() >= 200'000);
+         }
+
+         WHEN("Querying radii smaller and larger than a cell") {
+            std::mt19937 rng {3};
+            std::uniform_real_distribution<Real> dist {-55, 55};
+            for (Real radius : {Real(0.5), Real(1), Real(3.5)}) {
+               for (int q = 0; q < 50; ++q) {
+                  const Vec3 c {dist(rng), dist(rng), dist(rng)};
+                  REQUIRE(Query(grid, c, radius) == points.BruteForce(c, radius));
+               }
+            }
+         }
+      }
+   }
+
+   GIVEN("The same points, built serially and in parallel") {
+      const Points points {100'000, 20, 5};
+      SpatialHash serial {1}, parallel {1};
+      serial.Build(points.mX.data(), points.mY.data(), points.mZ.data(), points.mX.size());
+      parallel.Build(points.mX.data(), points.mY.data(), points.mZ.data(),
+         points.mX.size(), &scheduler);
+
+      THEN("Neighbours are reported in the same order") {
+         std::mt19937 rng {9};
+         std::uniform_real_distribution<Real> dist {-20, 20};
+         for (int q = 0; q < 50; ++q) {
+            const Vec3 c {dist(rng), dist(rng), dist(rng)};
+            std::vector<SpatialHash::Index> a, b;
+            serial.Query(c, 2, [&](SpatialHash::Index i) { a.push_back(i); });
+            parallel.Query(c, 2, [&](SpatialHash::Index i) { b.push_back(i); });
+            REQUIRE(a == b);
+         }
+      }
+
+      THEN("The grid can be queried from inside a query") {
+         std::mt19937 rng {4};
+         std::uniform_real_distribution<Real> dist {-20, 20};
+         for (int q = 0; q < 20; ++q) {
+            const Vec3 c {dist(rng), dist(rng), dist(rng)};
+            std::vector<SpatialHash::Index> outer;
+            Count inner = 0, expected = 0;
+            serial.Query(c, 1, [&](SpatialHash::Index i) {
+               outer.push_back(i);
+               const Vec3 at {points.mX[i], points.mY[i], points.mZ[i]};
+               inner += Query(serial, at, Real(0.5)).size();
+               expected += points.BruteForce(at, Real(0.5)).size();
+            });
+
+            std::sort(outer.begin(), outer.end());
+            REQUIRE(outer == points.BruteForce(c, 1));
+            REQUIRE(inner == expected);
+         }
+      }
+   }
+
+   GIVEN("Points clustered in a single cell, and an empty grid") {
+      const Points points {1000, Real(0.4), 1};
+      SpatialHash grid {1};
+
+      THEN("Empty grids report nothing") {
+         REQUIRE(Query(grid, {}, 100).empty());
+      }
+
+      WHEN("Built, and queried with a radius covering all cells") {
+         grid.Build(points.mX.data(), points.mY.data(), points.mZ.data(), points.mX.size());
+
+         THEN("Each point is reported once") {
+            REQUIRE(Query(grid, {}, 10) == points.BruteForce({}, 10));
+         }
+      }
+   }
+}
+
+#ifdef LANGULUS_STD_BENCHMARK
+SCENARIO("Spatial hash grid rebuild", "[spatialhash][!benchmark]") {
+   const Points points {1'000'000, 100, 1};
+   Scheduler scheduler;
+   SpatialHash grid {1};
+
+   for (bool parallel : {false, true}) {
+      BENCHMARK_ADVANCED(std::string("Build ") + (parallel ? "in parallel" : "serially") + " - 1M points")(Catch::Benchmark::Chronometer meter) {
+         meter.measure([&] {
+            grid.Build(points.mX.data(), points.mY.data(), points.mZ.data(),
+               points.mX.size(), parallel ? &scheduler : nullptr);
+            return grid.GetCount();
+         });
+      };
+   }
+}
+#endif
@@ -0,0 +1,180 @@
+///                                                                           
+/// Langulus::Module::Physics                                                 
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "../source/Stencil.hpp"
+#include <Langulus/Testing.hpp>
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace Euclidean;
+using Integrator::ISA;
+
+/// A single scalar on each cell, i.e. temperature                            
+using HeatConfig = AMR::MeshConfig<3, 8, AMR::AverageGrid<Real>>;
+/// A source and a target grid, for kernels that can't work in place          
+using HeatPairConfig = AMR::MeshConfig<3, 8, AMR::AverageGrid<Real>, AMR::AverageGrid<Real>>;
+
+
+/// Set every inner cell of every leaf to the X coordinate of its centre,     
+/// with cells of the root block being one unit wide                          
+template<class C>
+void FillHeatRamp(AMR::Tree<C>& tree) {
+   tree.forEachLeaf([](AMR::Node<C>& node) {
+      const Real cell = Real(1) / Real(AMR::u64 {1} << node.level);
+      AMR::Loop<3>(1, C::BlockSize + 1, [&](const auto& it) {
+         std::get<0>(node.data)[it] = (Real(node.position[0] + it[0] - 1) + Real(0.5)) * cell;
+      });
+   });
+   tree.synchronize();
+}
+
+
+SCENARIO("Transport stencil", "[stencil]") {
+   GIVEN("A block of random values, with a halo") {
+      constexpr Count size = 8;
+      constexpr Count extent = size + 2;
+      std::mt19937 rng {3};
+      std::uniform_real_distribution<Real> dist {-100, 100};
+      std::vector<Real> source(extent * extent * extent);
+      for (auto& value : source)
+         value = dist(rng);
+
+      const auto weights = Stencil::Weights::Transport(
+         Real(0.5), Vec3 {1, -2, 0}, Vec3 {1}, Real(0.1));
+      REQUIRE(weights.IsStable());
+
+      WHEN("Stepped with every supported instruction set") {
+         std::vector<Real> expected(source.size());
+         Stencil::Apply(ISA::Scalar, {source.data(), expected.data(), extent, extent * extent, size}, weights);
+
+         THEN("Results are bit-identical to the scalar kernel") {
+            for (int i = 0; i < static_cast<int>(ISA::Counter); ++i) {
+               const auto isa = static_cast<ISA>(i);
+               if (not Integrator::IsSupported(isa))
+                  continue;
+
+               std::vector<Real> result(source.size());
+               Stencil::Apply(isa, {source.data(), result.data(), extent, extent * extent, size}, weights);
+               REQUIRE(0 == std::memcmp(expected.data(), result.data(), result.size() * sizeof(Real)));
+            }
+         }
+      }
+   }
+
+   GIVEN("Weights for a time step that is too large") {
+      const auto weights = Stencil::Weights::Transport(
+         Real(1), Vec3 {0}, Vec3 {1}, Real(1));
+
+      THEN("The step is reported as unstable") {
+         REQUIRE_FALSE(weights.IsStable());
+      }
+   }
+
+   GIVEN("A refined tree, holding a linear ramp along X") {
+      AMR::Tree<HeatConfig> tree;
+      std::vector<Real> scratch;
+      tree.root->action = AMR::Refine;
+      tree.restructure();
+      FillHeatRamp(tree);
+
+      const auto inner = [&](auto&& check) {
+         tree.forEachLeaf([&](AMR::Node<HeatConfig>& node) {
+            const Real cell = Real(1) / Real(AMR::u64 {1} << node.level);
+            AMR::Loop<3>(1, HeatConfig::BlockSize + 1, [&](const auto& it) {
+               const Real x = (Real(node.position[0] + it[0] - 1) + Real(0.5)) * cell;
+               // Outside the mesh, halos repeat the nearest cell       
+               if (x > 1 and x < 7)
+                  check(std::get<0>(node.data)[it], x);
+            });
+         });
+      };
+
+      WHEN("Diffused") {
+         Stencil::Transport(Integrator::GetBestISA(), tree, scratch, Vec3 {1}, Real(0.01), Vec3 {0}, Real(1));
+
+         THEN("The ramp doesn't change away from the boundary") {
+            inner([](Real value, Real x) {
+               REQUIRE(value == Approx(x));
+            });
+         }
+      }
+
+      WHEN("Advected along X") {
+         Stencil::Transport(Integrator::GetBestISA(), tree, scratch, Vec3 {1}, Real(0), Vec3 {1, 0, 0}, Real(0.1));
+
+         THEN("The ramp moves with the flow") {
+            inner([](Real value, Real x) {
+               REQUIRE(value == Approx(x - Real(0.1)));
+            });
+         }
+      }
+   }
+}
+
+#ifdef LANGULUS_STD_BENCHMARK
+SCENARIO("Transport stencil throughput", "[stencil][!benchmark]") {
+   // Two levels of refinement everywhere - 64 leaves of 512 cells      
+   const auto refine = [](auto& tree) {
+      for (int level = 0; level < 2; ++level) {
+         tree.forEachLeaf([](auto& node) {
+            node.action = AMR::Refine;
+         });
+         tree.restructure();
+      }
+   };
+   constexpr Count cells = 64 * 512;
+   constexpr int repeats = 100;
+   const auto report = [&](const std::string& name, auto&& run) {
+      const auto start = std::chrono::steady_clock::now();
+      for (int r = 0; r < repeats; ++r)
+         run();
+      const std::chrono::duration<double> elapsed =
+         std::chrono::steady_clock::now() - start;
+      Logger::Info(name, ": ", static_cast<Count>(cells * repeats / elapsed.count()), " cells/s");
+   };
+
+   // The same stencil, through a DataView per cell                     
+   AMR::Tree<HeatPairConfig> pair;
+   refine(pair);
+   FillHeatRamp(pair);
+   const auto weights = Stencil::Weights::Transport(Real(0.01), Vec3 {1, 0, 0}, Vec3 {Real(0.25)}, Real(0.01));
+   const auto perCell = [&] {
+      pair.applyKernel([&](AMR::DataView<HeatPairConfig> view) {
+         view.get<1>(0, 0, 0) = view.get<0>(0, 0, 0) * weights.mCenter
+            + view.get<0>(-1, 0, 0) * weights.mLow[0] + view.get<0>(1, 0, 0) * weights.mHigh[0]
+            + view.get<0>(0, -1, 0) * weights.mLow[1] + view.get<0>(0, 1, 0) * weights.mHigh[1]
+            + view.get<0>(0, 0, -1) * weights.mLow[2] + view.get<0>(0, 0, 1) * weights.mHigh[2];
+      });
+   };
+
+   BENCHMARK_ADVANCED("Per cell kernel - 32k cells")(Catch::Benchmark::Chronometer meter) {
+      meter.measure(perCell);
+   };
+   report("Per cell kernel", perCell);
+
+   AMR::Tree<HeatConfig> tree;
+   std::vector<Real> scratch;
+   refine(tree);
+   FillHeatRamp(tree);
+   for (int i = 0; i < static_cast<int>(ISA::Counter); ++i) {
+      const auto isa = static_cast<ISA>(i);
+      if (not Integrator::IsSupported(isa))
+         continue;
+
+      const auto run = [&] {
+         Stencil::Transport(isa, tree, scratch, Vec3 {1}, Real(0.01), Vec3 {1, 0, 0}, Real(0.01));
+      };
+
+      BENCHMARK_ADVANCED(std::string(Integrator::GetName(isa)) + " - 32k cells")(Catch::Benchmark::Chronometer meter) {
+         meter.measure(run);
+      };
+      report(Integrator::GetName(isa), run);
+   }
+}
+#endif
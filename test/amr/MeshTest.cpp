@@ -1,5 +1,5 @@
 #include <catch2/catch.hpp>
-#include "../../source/amr/Mesh.inl"
+#include "../../source/amr/Mesh.hpp"
 #include <iostream>
 
 using namespace AMR;
@@ -16,28 +16,30 @@ struct GridI64 : GridConfig<i64>
 };
 
 using Config2D = MeshConfig<2, 8, GridI64>;
+using Config3D = MeshConfig<3, 4, AverageGrid<double>>;
 
 
 TEST_CASE("Create Node", "[mesh]")
 {
-    auto buffers = Config2D::createBuffers(16);
-    Node<Config2D> node(nullptr, buffers, 0, 0);
-    auto buffers2 = Config2D::createBuffers(16);
-    node.split(buffers2, 0);
-}
-
-/*TEST_CASE("Create Tree", "[mesh]")
-{
-    Tree<Config2D> tree;
+    Node<Config2D> node;
+    std::get<0>(node.data)[{3, 4}] = 7;
+    node.split();
+    CHECK(!node.isLeaf);
+    CHECK(node.children[{1, 0}]->position[0] == 8);
+    CHECK(node.children[{1, 0}]->position[1] == 0);
+    // Cell {3, 4} is inner cell {2, 3}, which covers inner cells {4..5, 6..7}
+    CHECK(std::get<0>(node.children[{0, 0}]->data)[{5, 7}] == 7);
+    CHECK(std::get<0>(node.children[{0, 0}]->data)[{6, 8}] == 7);
+    CHECK(std::get<0>(node.children[{0, 0}]->data)[{7, 8}] == 0);
 }
 
 TEST_CASE("Restructure Tree", "[mesh]")
 {
     Tree<Config2D> tree;
-    tree.restructure();
+    CHECK(!tree.restructure());
 
     tree.root->action = AMR::Refine;
-    tree.restructure();
+    CHECK(tree.restructure());
     CHECK(!tree.root->isLeaf);
     CHECK(tree.root->children[{0, 0}]->isLeaf);
     CHECK(tree.root->children[{0, 1}]->isLeaf);
@@ -60,12 +62,76 @@ TEST_CASE("Restructure Tree", "[mesh]")
     CHECK(tree.root->isLeaf);
 }
 
+TEST_CASE("Adjacency", "[mesh]")
+{
+    Tree<Config2D> tree;
+    tree.root->action = AMR::Refine;
+    tree.restructure();
+    auto corner = tree.root->children[{1, 1}];
+    corner->action = AMR::Refine;
+    tree.restructure();
+
+    auto fine = corner->children[{0, 0}];
+    CHECK(fine->adjacent[{1, 1}] == fine);
+    CHECK(fine->adjacent[{2, 1}] == corner->children[{1, 0}]);
+    CHECK(fine->adjacent[{0, 1}] == tree.root->children[{0, 1}]);
+    CHECK(fine->adjacent[{0, 0}] == tree.root->children[{0, 0}]);
+    CHECK(corner->adjacent[{2, 2}] == nullptr);
+    CHECK(tree.root->children[{0, 1}]->adjacent[{2, 1}] == corner);
+}
+
 TEST_CASE("Synchronize Tree", "[mesh]")
 {
     Tree<Config2D> tree;
     tree.root->action = AMR::Refine;
     tree.restructure();
+
+    // Each inner cell holds its global column
+    tree.forEachLeaf([](Node<Config2D>& node) {
+        Loop<2>(1, Config2D::BlockSize + 1, [&](const auto& it) {
+            std::get<0>(node.data)[it] = node.position[0] + it[0] - 1;
+        });
+    });
+    tree.synchronize();
+
+    auto left = tree.root->children[{0, 0}];
+    auto right = tree.root->children[{1, 0}];
+    CHECK(std::get<0>(left->data)[{9, 4}] == 8);
+    CHECK(std::get<0>(right->data)[{0, 4}] == 7);
+    CHECK(std::get<0>(right->data)[{0, 9}] == 7);
+    // Outside the mesh, the halo repeats the nearest cell
+    CHECK(std::get<0>(left->data)[{0, 4}] == 0);
+    CHECK(std::get<0>(right->data)[{9, 4}] == 15);
+    // The root holds the average of each pair of columns
+    CHECK(std::get<0>(tree.root->data)[{1, 1}] == 0);
+    CHECK(std::get<0>(tree.root->data)[{8, 1}] == 14);
+}
+
+TEST_CASE("Synchronize with coarser neighbours", "[mesh]")
+{
+    Tree<Config3D> tree;
+    tree.root->action = AMR::Refine;
+    tree.restructure();
+    auto corner = tree.root->children[{0, 0, 0}];
+    corner->action = AMR::Refine;
+    tree.restructure();
+
+    tree.forEachLeaf([](Node<Config3D>& node) {
+        Loop<3>(1, Config3D::BlockSize + 1, [&](const auto& it) {
+            std::get<0>(node.data)[it] = double(node.level);
+        });
+    });
     tree.synchronize();
+
+    // Fine leaves next to coarse ones see coarse data in their halo
+    auto fine = corner->children[{1, 1, 1}];
+    CHECK(std::get<0>(fine->data)[{5, 2, 2}] == 1);
+    CHECK(std::get<0>(fine->data)[{2, 2, 2}] == 2);
+    CHECK(std::get<0>(fine->data)[{0, 2, 2}] == 2);
+    // Coarse leaves see the refined node, downsampled
+    auto side = tree.root->children[{1, 0, 0}];
+    CHECK(std::get<0>(side->data)[{0, 2, 2}] == 2);
+    CHECK(std::get<0>(tree.root->data)[{1, 1, 1}] == 2);
 }
 
 TEST_CASE("Apply kernel", "[mesh]")
@@ -76,18 +142,16 @@ TEST_CASE("Apply kernel", "[mesh]")
     tree.synchronize();
     tree.applyKernel([](DataView<Config2D> view) {
         view.get<0>(0, 0) = 4;
+        view.derefine = true;
     });
     Loop<2>(0, 2, [&](auto& it1) {
-        Loop<2>(1, Config2D::blockSize, [&](auto& it2) {
+        Loop<2>(1, Config2D::BlockSize + 1, [&](auto& it2) {
             CHECK(std::get<0>(tree.root->children[it1]->data)[it2] == 4);
         });
     });
-}
 
-TEST_CASE("Construct Mesh")
-{
-    Mesh<Config2D> mesh({5, 5});
-    mesh.applyKernel([](DataView<Config2D> view) {
-        view.get<0>(0, 0) = 4;
-    });
-}*/
+    // All cells of all leaves asked for coarsening
+    tree.restructure();
+    CHECK(tree.root->isLeaf);
+    CHECK(std::get<0>(tree.root->data)[{3, 3}] == 4);
+}